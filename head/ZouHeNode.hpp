@@ -10,6 +10,7 @@
 #include "latticeModel.hxx"
 
 #include "boundaryNode.hxx"
+#include "nodeTypeField.hpp"
 
 class ZouHeNode: public boundaryNode
 {
@@ -41,30 +42,47 @@ class ZouHeNode: public boundaryNode
         );
         // Updates the boundary nodes based on "On pressure and velocity boundary
         // conditions for the lattice Boltzmann"
-        // param df lattice distribution functions stored row-wise in a 2D vector
+        // param df lattice distribution functions stored row-wise in a latticeArray
         // param is_modify_stream boolean toggle for half-way bounceback nodes to
         //       perform functions during stream, set to FALSE for Zou/He velocity nodes
         void updateNode
         (
-            std::vector<std::vector<double>> &df,
+            latticeArray<double> &df,
             bool is_modify_stream
         );
+        // Get the rows of the boundary nodes and their neighbours, whose density
+        // or velocity corners and normal-flow nodes read
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        void getRows
+        (
+            std::size_t &first_row,
+            std::size_t &last_row
+        ) const;
+        // Registers the nodes in a node type field as velocity nodes, so that the
+        // streaming sweep applies them. Call after toggleNormalFlow(), the object
+        // must then not be added to LatticeBoltzmann as well
+        // param types node type field of the streaming model
+        void registerNodes
+        (
+            nodeTypeField &types
+        );
         // Updates the non-corner nodes
-        // param df lattice distribution function stored row-wise in a 2D vector
+        // param df lattice distribution function stored row-wise in a latticeArray
         // param node Zou/He velocity node which contains information on the position
         //       of the boundary node and velocities of the node
         void updateEdge
         (
-            std::vector<std::vector<double>> &df,
+            latticeArray<double> &df,
             latticeNode &node
         );
         // Updates the corner nodes, first-order expolation for node density
-        // param df lattice distribution function stored row-wise in a 2D vector
+        // param df lattice distribution function stored row-wise in a latticeArray
         // param node Zou/He velocity node which contains information on the position
         //       of the boundary node and velocities of the node
         void updateCorner
         (
-            std::vector<std::vector<double>> &df,
+            latticeArray<double> &df,
             latticeNode &node
         );
         // Toggles behaviour of Zou/He nodes when used as outlet, boundary node
@@ -0,0 +1,67 @@
+#ifndef ZOUHEPRESSURENODE_HPP_INCLUDED
+#define ZOUHEPRESSURENODE_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "ZouHeNode.hpp"
+#include "nodeTypeField.hpp"
+
+class ZouHePressureNode: public ZouHeNode
+{
+    public:
+        // Constructor: Creates Zou/He pressure boundary nodes
+        // param lm lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param cm collision model which contains information on lattice density
+        ZouHePressureNode
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Destructor
+        ~ZouHePressureNode() = default;
+        // Adds a Zou/He pressure node to the nodes vector. Throws exception for
+        // corner nodes, which belong to the adjacent walls or velocity nodes
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // param rho density of the node, the pressure is cs^2 * rho
+        void addNode
+        (
+            std::size_t x,
+            std::size_t y,
+            double rho
+        );
+        // Updates the boundary nodes based on "On pressure and velocity boundary
+        // conditions for the lattice Boltzmann BGK model" Zou1997. The velocity
+        // normal to the edge follows from the density and the known distribution
+        // functions, the tangential velocity is zero
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param is_modify_stream boolean toggle for half-way bounceback nodes to
+        //       perform functions during stream, set to FALSE for Zou/He pressure nodes
+        void updateNode
+        (
+            latticeArray<double> &df,
+            bool is_modify_stream
+        );
+        // Registers the nodes in a node type field as pressure nodes, so that the
+        // streaming sweep applies them. The object must then not be added to
+        // LatticeBoltzmann as well
+        // param types node type field of the streaming model
+        void registerNodes
+        (
+            nodeTypeField &types
+        );
+    private:
+        // define lattice model
+        latticeModelD2Q9 &D2Q9_;
+};
+
+#endif // ZOUHEPRESSURENODE_HPP_INCLUDED
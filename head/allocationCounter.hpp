@@ -0,0 +1,20 @@
+#ifndef ALLOCATIONCOUNTER_HPP_INCLUDED
+#define ALLOCATIONCOUNTER_HPP_INCLUDED
+
+#include <cstddef>
+
+// Builds with COUNT_ALLOCATIONS replace the global operator new and delete by
+// versions which count every heap allocation made through them, e.g. to check
+// that time steps do not allocate. Other builds keep the operators of the
+// standard library
+
+// Checks if the build counts heap allocations
+// return true if built with COUNT_ALLOCATIONS
+bool isAllocationCounted();
+
+// Get the number of heap allocations since the start of the program, on all
+// threads
+// return number of allocations, 0 without COUNT_ALLOCATIONS
+std::size_t getNumberOfAllocations();
+
+#endif // ALLOCATIONCOUNTER_HPP_INCLUDED
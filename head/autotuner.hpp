@@ -0,0 +1,113 @@
+#ifndef AUTOTUNER_HPP_INCLUDED
+#define AUTOTUNER_HPP_INCLUDED
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nodeOrdering.hpp"
+#include "latticeBoltzmann.hpp"
+
+class autotuner
+{
+    public:
+        // Storage configuration of a lattice. The streaming kernel follows from
+        // the ordering: index arithmetic for row-major lattices, a tile by tile
+        // sweep from saved tile edges for tiled lattices
+        struct configuration
+        {
+            // Storage order of the nodes
+            nodeOrdering::e_orderings ordering;
+            // Number of grid along each side of a tile, 0 for row-major lattices
+            std::size_t tile_size;
+            // Million lattice updates per second measured for the configuration
+            double mlups;
+        };
+        // Constructor: Creates an autotuner which selects the fastest configuration
+        // of a problem from a tuning cache shared by several hosts, e.g. on a
+        // network file system. Entries are keyed by the host and the problem
+        // signature, a missing file gives an empty cache
+        // param cache_file CSV file with the selected configuration of each host
+        //       and problem, new entries are merged into it after each measurement
+        //       under a lock on cache_file.lock
+        autotuner
+        (
+            const std::string &cache_file
+        );
+        // Destructor
+        ~autotuner() = default;
+        // Get the configuration of a problem from the cache or, on a cache miss,
+        // benchmarks every candidate of getCandidates() for a few steps with
+        // measure, stores the fastest in the cache and prints the MLUPS of every
+        // candidate. Tiled orders are only selected if they are more than 5%
+        // faster than the row-major order
+        // param problem signature of the problem, e.g. collision model and
+        //       boundaries, the lattice size and host are added by the autotuner
+        // param nx number of grid along x coordinate
+        // param ny number of grid along y coordinate
+        // param measure sets up the problem with a configuration and returns its
+        //       MLUPS, usually with measureMLUPS()
+        // return fastest configuration
+        configuration tune
+        (
+            const std::string &problem,
+            std::size_t nx,
+            std::size_t ny,
+            const std::function<double(const configuration&)> &measure
+        );
+        // Checks if the last configuration returned by tune() was read from the
+        // cache
+        // return true if the last configuration was not measured
+        bool isCached() const;
+        // Get the configurations tried for a lattice: row-major and Morton and
+        // Hilbert tiles of 16 to 128 grid which fit into the lattice
+        // param nx number of grid along x coordinate
+        // param ny number of grid along y coordinate
+        // return candidate configurations with mlups 0
+        std::vector<configuration> getCandidates
+        (
+            std::size_t nx,
+            std::size_t ny
+        ) const;
+        // Runs time steps in short windows after a warm-up step and returns the
+        // million lattice updates per second of the fastest window. Each window
+        // updates at least about a million nodes
+        // param run lattice Boltzmann run of the problem
+        // param num_nodes number of nodes of the lattice
+        // return million lattice updates per second
+        static double measureMLUPS
+        (
+            latticeBoltzmann &run,
+            std::size_t num_nodes
+        );
+        // Get the name of a storage order as used in the cache
+        // param ordering storage order of the nodes
+        // return ROW_MAJOR, MORTON or HILBERT
+        static std::string getOrderingName
+        (
+            nodeOrdering::e_orderings ordering
+        );
+    private:
+        // Identifies the host by its name, processor model and number of hardware
+        // threads, so that hosts with the same name but different hardware do not
+        // share entries
+        // return host signature without commas
+        std::string getHostSignature() const;
+        // Reads the tuning cache, a missing file gives an empty cache
+        void readCache();
+        // Writes the tuning cache to a temporary file which then replaces the
+        // cache, throws exception if writing fails
+        void writeCache();
+        // Name of the tuning cache file
+        std::string cache_file_;
+        // Signature of this host
+        std::string host_;
+        // Selected configuration of each host and problem, keyed by
+        // host,problem,nx,ny
+        std::map<std::string, configuration> cache_;
+        // Boolean toggle set if the last configuration was read from the cache
+        bool is_cached_;
+};
+
+#endif // AUTOTUNER_HPP_INCLUDED
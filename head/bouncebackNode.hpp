@@ -5,11 +5,13 @@
 
 #include "latticeBase.hpp"
 #include "collisionBase.hxx"
+#include "streamBase.hxx"
 
 #include "latticeModel.hxx"
 
 #include "latticeNode.hxx"
 #include "boundaryNode.hxx"
+#include "nodeTypeField.hpp"
 
 class bouncebackNode: public boundaryNode
 {
@@ -55,6 +57,31 @@ class bouncebackNode: public boundaryNode
         // param y y-coordinate of the node
         // param z z-coordinate of the node
         void addNode(std::size_t x, std::size_t y, std::size_t z);
+        // Adds a bounceback node which belongs to an immersed obstacle, the
+        // momentum-exchange force is accumulated per obstacle ID
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // param obstacle_id user-defined ID of the obstacle, nodes added with
+        //       addNode() belong to obstacle 0
+        void addObstacleNode
+        (
+            std::size_t x,
+            std::size_t y,
+            std::size_t obstacle_id
+        );
+        // Toggles evaluation of the momentum-exchange force on the obstacles. The
+        // force is accumulated over the links of each node while its distribution
+        // functions are updated in updateNode()
+        void toggleForceEvaluation();
+        // Registers the nodes in a node type field as full-way or half-way
+        // bounceback nodes, so that the streaming sweep applies them. The object
+        // must then not be added to LatticeBoltzmann as well. Momentum-exchange
+        // forces are only evaluated by updateNode()
+        // param types node type field of the streaming model
+        void registerNodes
+        (
+            nodeTypeField &types
+        );
         // Performs the bounceback boundary condition on the boundary nodes based on
         // the type of bounceback nodes used.
         // Full-way bounceback: Reflects all the node distribution functions in the
@@ -62,15 +89,27 @@ class bouncebackNode: public boundaryNode
         // Half-way bounceback: Copies the prestream node distribution functions
         //       before streaming. Updates the post-stream unknown distribution functions
         //       with the prestream distribution functions in the opposite directions
-        // param df lattice distribution functions store row-wise in a 2D vector
+        // param df lattice distribution functions stored row-wise in a latticeArray
         // param is_modify_stream Boolean toggle for half-way bounceback as it has
         //       both pre-stream and post-stream functions. Used to fit in with how
         //       all boundary conditions are called
         void updateNode
         (
-            std::vector<std::vector<double>> &df,
+            latticeArray<double> &df,
             bool is_modify_stream
         );
+        // Get the rows of the boundary nodes, the bounceback nodes touch only
+        // their own distribution functions
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        void getRows
+        (
+            std::size_t &first_row,
+            std::size_t &last_row
+        ) const;
+        // Momentum-exchange force of the last time step on each obstacle, indexed
+        // by obstacle ID and dimension
+        std::vector<std::vector<double>> force;
     protected:
         // Vector used to store information about the boundary nodes such as their
         // position at the lattice node
@@ -81,7 +120,19 @@ class bouncebackNode: public boundaryNode
         // Pointer to stream model as full-way bounceback nodes do not require stream
         // models and NULL references can't be declared
         streamBase *sb_ = nullptr;
+        // Obstacle ID of each boundary node
+        std::vector<std::size_t> obstacle_;
+        // Bit mask of each full-way bounceback node, bit i is set if the
+        // distribution function in direction i has streamed in from a fluid node
+        std::vector<unsigned> links_;
+        // Boolean toggle for momentum-exchange force evaluation
+        bool is_force_;
+        // Boolean toggle to indicate if the links are up to date with the nodes
+        bool is_links_built_;
     private:
+        // Finds the fluid links of full-way bounceback nodes, i.e. directions in
+        // which the upstream neighbour is neither off-lattice nor a bounceback node
+        void buildLinks();
         // define fluid field;
         fluidField &field_;
         // define lattice model
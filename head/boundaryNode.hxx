@@ -1,8 +1,10 @@
 #ifndef BOUNDARYNODE_HXX_INCLUDED
 #define BOUNDARYNODE_HXX_INCLUDED
 
+#include <algorithm>
 #include <vector>
 
+#include "latticeArray.hxx"
 #include "latticeBase.hpp"
 
 class boundaryNode
@@ -33,14 +35,28 @@ class boundaryNode
         virtual ~boundaryNode() = default;
         // Pure virtual function for the boundary conditions to implement on how the
         // boundary nodes are updated
-        // param df lattice distribution functions stored row-wise in a 2D vector
+        // param df lattice distribution functions stored row-wise in a latticeArray
         // param is_modify_stream Boolean toggle for half-way bounceback nodes to
         //       perform functions after streaming
         virtual void updateNode
         (
-            std::vector<std::vector<double>> &df,
+            latticeArray<double> &df,
             bool is_modify_stream
         ) = 0;
+        // Get the rows of the lattice whose nodes the boundary condition reads or
+        // writes, so that it can run concurrently with the sweeps of other rows.
+        // Defaults to all rows
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        virtual void getRows
+        (
+            std::size_t &first_row,
+            std::size_t &last_row
+        ) const
+        {
+            first_row = 0;
+            last_row = lb_.getNumberOfNy();
+        }
         // Boolean toggle to indicate if boundary condition occurs before streaming
         bool prestream;
         // Boolean toggle to indicate if boundary condition occurs during stream, or
@@ -49,6 +65,32 @@ class boundaryNode
     protected:
         // Indicates boundary node positions, for outputting results
         std::vector<std::size_t> position;
+        // Rows of a set of boundary nodes and of their neighbours up to a distance
+        // param nodes boundary nodes with coordinate y_node
+        // param margin number of neighbouring rows read on either side
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        template <typename T>
+        void getRowsOfNodes
+        (
+            const std::vector<T> &nodes,
+            std::size_t margin,
+            std::size_t &first_row,
+            std::size_t &last_row
+        ) const
+        {
+            first_row = 0;
+            last_row = 0;
+            if (nodes.empty()) return;
+            first_row = lb_.getNumberOfNy();
+            for (auto &node : nodes)
+            {
+                first_row = std::min(first_row, node.y_node);
+                last_row = std::max(last_row, node.y_node + 1);
+            }  // node
+            first_row = first_row > margin ? first_row - margin : 0;
+            last_row = std::min(last_row + margin, lb_.getNumberOfNy());
+        }
         // Reference to LatticeModel which contains information on number of rows,
         // columns, dimensions, discrete directions and lattice velocity
         latticeBase &lb_;
@@ -1,9 +1,13 @@
 #ifndef COLLISIONBASE_HXX_INCLUDED
 #define COLLISIONBASE_HXX_INCLUDED
 
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "latticeArray.hxx"
 #include "latticeBase.hpp"
+#include "loadBalancer.hpp"
 
 class collisionBase
 {
@@ -25,12 +29,13 @@ class collisionBase
             const auto ny = lb_.getNumberOfNy();
             const auto nc = lb_.getNumberOfDirections();
             const auto lat_size = nx * ny;
-            eqdf.assign(lat_size, std::vector<double>(nc, 0.0));
+            eqdf.assign(lat_size, nc, 0.0);
             rho_.assign(lat_size, initial_density);
         };
-        // Constructor: Creates collision base with the same density at each node
+        // Constructor: Creates collision base with variable density at each node.
+        // Throws exception if there is not one density for each node
         // param lm lattice model used for simulation
-        // param initial_density initial density of the lattice
+        // param initial_density initial density of each node
         collisionBase
         (
             latticeBase &lb,
@@ -45,7 +50,11 @@ class collisionBase
             const auto ny = lb_.getNumberOfNy();
             const auto nc = lb_.getNumberOfDirections();
             const auto lat_size = nx * ny;
-            eqdf.assign(lat_size, std::vector<double>(nc, 0.0));
+            if (rho_.size() != lat_size)
+            {
+                throw std::runtime_error("Initial density does not match the lattice size");
+            }
+            eqdf.assign(lat_size, nc, 0.0);
         };
         // https://stackoverflow.com/questions/353817/should-every-class-have-a-
         // virtual-destructor
@@ -54,11 +63,11 @@ class collisionBase
         // Calculates equilibrium distribution function according to LBIntro
         virtual void computefEq() = 0;
         // Compute density at each node by summing up its distribution functions
-        // param lattice 2D vector containing distribution functions
+        // param lattice latticeArray containing distribution functions
         // return density of lattice stored row-wise in a 1D vector
         virtual std::vector<double> computeRho
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         ) = 0;
         // Pure virtual function to compute the macroscopic properties of the lattice
         // depending on the equation, density and velocity for Navier-Stokes, only
@@ -66,10 +75,10 @@ class collisionBase
         // This is used to unify function calling in LatticeBoltzmann takeStep()
         // method
         // param df Particle distribution functions of the lattice stored row-wise
-        // in a 2D vector
+        // in a latticeArray
         virtual void computeMacroscopicProperties
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         ) = 0;
         // Adds a node to exclude it from the collision step
         // param n index of the node in the lattice
@@ -77,18 +86,77 @@ class collisionBase
         (
             std::size_t n
         ) = 0;
+        // Checks if a node is excluded from the collision step, e.g. a solid
+        // node inside a full-way bounceback obstacle
+        // param n index of the node in the lattice
+        // return TRUE if the node is skipped
+        virtual bool isNodeSkipped
+        (
+            std::size_t n
+        ) const = 0;
+        // Prepares the collision model for another case on the same lattice
+        // without reallocating its arrays: sets the viscosity and the density of
+        // each node and includes every node in the collision step again. Other
+        // parameters of the model, e.g. a Smagorinsky constant, are kept
+        // param kinematic_viscosity kinematic viscosity of the case
+        // param initial_density initial density of the lattice
+        virtual void reset
+        (
+            double kinematic_viscosity,
+            double initial_density
+        ) = 0;
         // Pure virtual function to compute collision step and apply force step
         // according to "A new scheme for source term in LBGK model for
         // convection  diffusion equation" and Guo2002
-        // param lattice 2D vector containing distribution functions
+        // param lattice latticeArray containing distribution functions
         virtual void collide
         (
-            std::vector<std::vector<double>> &df
+            latticeArray<double> &df
         ) = 0;
+        // Runs the node sweeps of the collision model which support it on the
+        // threads of a load balancer. The balancer must outlive the collision
+        // model or be removed again
+        // param balancer load balancer over the nodes of the lattice, nullptr
+        //       runs the sweeps serially (default)
+        void setLoadBalancer
+        (
+            loadBalancer *balancer
+        )
+        {
+            balancer_ = balancer;
+        }
+        // Checks if every node sweep of the collision model runs through
+        // forEachNodeRange, so that the sweeps can be restricted to a range of
+        // nodes with restrictToNodes
+        // return TRUE if the sweeps can be restricted
+        virtual bool isNodeRangeSupported() const
+        {
+            return false;
+        }
+        // Runs sweeps of the collision model, e.g. computefEq() and collide(), on
+        // the nodes first <= n < last only. Sweeps on disjoint ranges may run
+        // concurrently on different threads
+        // param first first node of the range
+        // param last one past the last node of the range
+        // param sweeps callable which calls the sweeps
+        template <typename F>
+        void restrictToNodes
+        (
+            std::size_t first,
+            std::size_t last,
+            F sweeps
+        )
+        {
+            auto &range = getThreadRange();
+            const auto outer = range;
+            range = {first, last};
+            sweeps();
+            range = outer;
+        }
         // Density stored row-wise in a 1D vector
         std::vector<double> rho_;
-        // Equilibrium distribution function stored row-wise in a 2D vector
-        std::vector<std::vector<double>> eqdf;
+        // Equilibrium distribution function stored row-wise in a latticeArray
+        latticeArray<double> eqdf;
     protected:
         // Lattice model to handle number of rows, columns, dimensions, directions,
         // velocity/
@@ -98,6 +166,38 @@ class collisionBase
         // Square of speed of sound in lattice, used to simplify computations in the
         // collision step
         double cs_sqr_ = c_ * c_ / 3.0;
+        // Node range of the sweeps run by the calling thread, empty for all nodes
+        // return first node and one past the last node of the range
+        static std::pair<std::size_t, std::size_t>& getThreadRange()
+        {
+            static thread_local std::pair<std::size_t, std::size_t> range {0, 0};
+            return range;
+        }
+        // Load balancer of the node sweeps, nullptr for serial sweeps
+        loadBalancer *balancer_ = nullptr;
+        // Runs a kernel over all nodes, on the load balancer if one is set
+        // param kernel callable kernel(first, last) which updates the nodes with
+        //       index first <= n < last and no other nodes
+        template <typename F>
+        void forEachNodeRange
+        (
+            F kernel
+        )
+        {
+            const auto &range = getThreadRange();
+            if (range.second > range.first)
+            {
+                kernel(range.first, range.second);
+            }
+            else if (balancer_)
+            {
+                balancer_->forEachChunk(kernel);
+            }
+            else
+            {
+                kernel(std::size_t {0}, rho_.size());
+            }
+        }
 };
 
 #endif // COLLISIONBASE_HXX_INCLUDED
@@ -0,0 +1,142 @@
+#ifndef COLLISIOND2Q9_BGK_ADE_HPP_INCLUDED
+#define COLLISIOND2Q9_BGK_ADE_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+#include "collisionD2Q9_BGK.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_BGK_ADE: public collisionD2Q9_BGK
+{
+    public:
+        // Edges of the lattice
+        enum e_edges
+        {
+            RIGHT,
+            TOP,
+            LEFT,
+            BOTTOM
+        };
+        // Boundaries of the scalar on the lattice edges, the wall lies half a node
+        // outside of the edge nodes like a half-way bounceback wall
+        enum e_scalar_boundaries
+        {
+            ADIABATIC,
+            FIXED,
+            PERIODIC
+        };
+        // Constructor: Creates BGK collision model for NS equation coupled with a
+        // D2Q5 advection-diffusion equation of a passive scalar or temperature, with
+        // the same density at each node. The scalar uses directions 0 to 4 of D2Q9
+        // and is collided and streamed in the sweep of the fluid collision, the
+        // edges are adiabatic until set otherwise
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param diffusivity diffusivity of the scalar
+        // param initial_density_f initial density of NS lattice
+        // param initial_scalar initial scalar at each node
+        collisionD2Q9_BGK_ADE
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double diffusivity,
+            double initial_density_f,
+            const std::vector<double> &initial_scalar,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates BGK collision model for NS equation coupled with a
+        // D2Q5 advection-diffusion equation with variable density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param diffusivity diffusivity of the scalar
+        // param initial_density_f initial density of NS lattice
+        // param initial_scalar initial scalar at each node
+        collisionD2Q9_BGK_ADE
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double diffusivity,
+            const std::vector<double> &initial_density_f,
+            const std::vector<double> &initial_scalar,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_BGK_ADE() = default;
+        // Sets the Boussinesq buoyancy F = rho * (scalar - reference_scalar) * b
+        // which acts back on the flow, b = -beta * g for a temperature. Without
+        // buoyancy the scalar is passive
+        // param b_x x-component of b
+        // param b_y y-component of b
+        // param reference_scalar scalar at which the buoyancy vanishes
+        void setBuoyancy
+        (
+            double b_x,
+            double b_y,
+            double reference_scalar
+        );
+        // Sets the boundary of the scalar on a lattice edge
+        // param edge edge of the lattice
+        // param boundary adiabatic, fixed or periodic
+        // param value scalar on the wall of a fixed edge, unused otherwise
+        void setEdge
+        (
+            e_edges edge,
+            e_scalar_boundaries boundary,
+            double value
+        );
+        // Computes density, scalar and velocity in a single sweep, the velocity
+        // includes half of the buoyancy according to Guo2002
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void computeMacroscopicProperties
+        (
+            const latticeArray<double> &df
+        );
+        // Collides the fluid with the BGK operator and the buoyancy forcing term of
+        // Guo2002. In the same sweep the scalar of the node is collided with the
+        // velocity of the node and pushed to its neighbours, full-way bounceback
+        // nodes reflect it like an adiabatic wall
+        // param lattice latticeArray containing distribution functions
+        void collide
+        (
+            latticeArray<double> &df_lattice
+        );
+        // Get the scalar
+        // return scalar at each node
+        const std::vector<double> &getScalar() const;
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its collide() and
+        // computeMacroscopicProperties() sweep the whole lattice
+        bool isNodeRangeSupported() const;
+    private:
+        // Sets the scalar distribution functions to their equilibrium
+        // param initial_scalar initial scalar at each node
+        void initialize
+        (
+            const std::vector<double> &initial_scalar
+        );
+        // Relaxation time of the scalar
+        double tau_scalar_;
+        // Buoyancy per unit density and scalar
+        std::vector<double> buoyancy_;
+        // Scalar at which the buoyancy vanishes
+        double reference_scalar_;
+        // Boundary of the scalar on each edge, indexed by e_edges
+        std::vector<e_scalar_boundaries> edge_boundary_;
+        // Scalar on the wall of each fixed edge
+        std::vector<double> edge_value_;
+        // Scalar at each node
+        std::vector<double> scalar_;
+        // D2Q5 scalar distribution functions, the streamed ones are written to
+        // scalar_df_next_ and swapped at the end of the collision sweep
+        latticeArray<double> scalar_df_;
+        latticeArray<double> scalar_df_next_;
+        // Buoyancy force of the node being collided
+        std::vector<double> force_;
+};
+
+#endif // COLLISIOND2Q9_BGK_ADE_HPP_INCLUDED
@@ -0,0 +1,64 @@
+#ifndef COLLISIOND2Q9_BGK_LES_HPP_INCLUDED
+#define COLLISIOND2Q9_BGK_LES_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionD2Q9_BGK.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_BGK_LES: public collisionD2Q9_BGK
+{
+    public:
+        // Constructor: Creates BGK collision model with Smagorinsky subgrid model
+        // for NS equation with the same density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity molecular viscosity
+        // param smagorinsky_constant Smagorinsky constant C_s, typically 0.1 to 0.2
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_BGK_LES
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double smagorinsky_constant,
+            double initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates BGK collision model with Smagorinsky subgrid model
+        // for NS equation with variable density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity molecular viscosity
+        // param smagorinsky_constant Smagorinsky constant C_s, typically 0.1 to 0.2
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_BGK_LES
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double smagorinsky_constant,
+            const std::vector<double> &initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_BGK_LES() = default;
+        // Collides with a local relaxation time according to "A lattice Boltzmann
+        // subgrid model for high Reynolds number flows" Hou1996. The strain rate
+        // comes from the non-equilibrium momentum flux of the node, so the eddy
+        // viscosity is evaluated inside the collision loop and never stored
+        // param lattice latticeArray containing distribution functions
+        void collide
+        (
+            latticeArray<double> &df_lattice
+        );
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its collide() sweeps the whole lattice
+        bool isNodeRangeSupported() const;
+    private:
+        // 2 * (C_s * dl)^2 / (cs^4 * dt^2), scales the non-equilibrium momentum flux
+        // in the quadratic equation of the local relaxation time
+        double les_coeff_;
+};
+
+#endif // COLLISIOND2Q9_BGK_LES_HPP_INCLUDED
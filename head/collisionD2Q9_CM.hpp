@@ -0,0 +1,64 @@
+#ifndef COLLISIOND2Q9_CM_HPP_INCLUDED
+#define COLLISIOND2Q9_CM_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionD2Q9_BGK.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_CM: public collisionD2Q9_BGK
+{
+    public:
+        // Constructor: Creates central moment collision model for NS equation with
+        // the same density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_CM
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates central moment collision model for NS equation with
+        // variable density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_CM
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            const std::vector<double> &initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_CM() = default;
+        // Collides in the space of central moments according to "Non-orthogonal
+        // central moments relaxing to a discrete equilibrium: A D2Q9 lattice
+        // Boltzmann model" DeRosis2016. The deviatoric stress relaxes with 1/tau,
+        // the trace and all higher moments are set to their equilibrium, so the
+        // collision is Galilean invariant and stays stable close to tau = 0.5
+        // param lattice latticeArray containing distribution functions
+        void collide
+        (
+            latticeArray<double> &df_lattice
+        );
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its collide() sweeps the whole lattice
+        bool isNodeRangeSupported() const;
+    private:
+        // Inverts the raw moment matrix of the lattice velocities. Throws
+        // exception if it is singular
+        void initialize();
+        // Inverse of the matrix transforming distribution functions to the raw
+        // moments m00, m10, m01, m20, m02, m11, m21, m12 and m22
+        std::vector<std::vector<double>> mInv_;
+};
+
+#endif // COLLISIOND2Q9_CM_HPP_INCLUDED
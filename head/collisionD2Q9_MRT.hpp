@@ -40,47 +40,67 @@ class collisionD2Q9_MRT: public collisionBase
         // Calculates equilibrium distribution function according to LBIntro
         void computefEq();
         // Calculates momentem equilibrium distribution function according to LBIntro
-        void computemEq();
+        virtual void computemEq();
         // Calculates momentem equilibrium distribution function according to LBIntro
         void computeM
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         );
         // Compute density at each node by summing up its distribution functions
-        // param lattice 2D vector containing distribution functions
+        // param lattice latticeArray containing distribution functions
         // return density of lattice stored row-wise in a 1D vector
         std::vector<double> computeRho
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         );
         // Calculated velocity for NS equation without body force based on formula in Guo2002
-        // param df 2D vector containing distribution functions of the NS equation
-        // return 2D vector containing velocity at each node of lattice
-        std::vector<std::vector<double>> computeU
+        // param df latticeArray containing distribution functions of the NS equation
+        // return latticeArray containing velocity at each node of lattice
+        latticeArray<double> computeU
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         );
         // Computes the macroscopic properties based on the collision model used, both
         // velocity and density in this case. Based on "Discrete lattice effects on
         // the forcing term in the lattice Boltzmann method"
-        // param df lattice distribution functions stored row-wise in a 2D vector
+        // param df lattice distribution functions stored row-wise in a latticeArray
         void computeMacroscopicProperties
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df
         );
+        // Checks if the sweeps can be restricted to a range of nodes. Derived
+        // models which replace a sweep by one over the whole lattice return FALSE
+        // return TRUE since every sweep runs through forEachNodeRange
+        bool isNodeRangeSupported() const;
         // Adds a node to exclude it from the collision step
         // param n index of the node in the lattice
         void addNodeToSkip
         (
             std::size_t n
         );
+        // Checks if a node is excluded from the collision step
+        // param n index of the node in the lattice
+        // return TRUE if the node is skipped
+        bool isNodeSkipped
+        (
+            std::size_t n
+        ) const;
+        // Sets the viscosity and the density of each node for another case and
+        // includes every node in the collision step again
+        // param kinematic_viscosity kinematic viscosity of the case
+        // param initial_density initial density of the lattice
+        void reset
+        (
+            double kinematic_viscosity,
+            double initial_density
+        );
         // Collides according to Guo2002
-        // param lattice 2D vector containing distribution functions
+        // param lattice latticeArray containing distribution functions
         void collide
         (
-            std::vector<std::vector<double>> &df_lattice
+            latticeArray<double> &df_lattice
         );
-    private:
+    protected:
         // define fluid field;
         fluidField &field_;
         // define lattice model
@@ -90,9 +110,9 @@ class collisionD2Q9_MRT: public collisionBase
         // Relaxation rate for MRT/
         std::vector<double> s_;
         // Relaxation rate for MRT/
-        std::vector<std::vector<double>> m_;
+        latticeArray<double> m_;
         // Relaxation rate for MRT/
-        std::vector<std::vector<double>> mEq_;
+        latticeArray<double> mEq_;
         // Skips the collision step for the node if it is a full-way bounceback node
         std::vector<bool> skip;
 };
@@ -0,0 +1,82 @@
+#ifndef COLLISIOND2Q9_MRT_PRE_HPP_INCLUDED
+#define COLLISIOND2Q9_MRT_PRE_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionD2Q9_MRT.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_MRT_PRE: public collisionD2Q9_MRT
+{
+    public:
+        // Constructor: Creates preconditioned MRT collision model for steady NS
+        // equation with the same density at each node. The steady solution is that
+        // of collisionD2Q9_MRT, transients are not time accurate. Throws exception
+        // if gamma is not in (0, 1]
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param gamma preconditioning parameter, 1 recovers collisionD2Q9_MRT,
+        //       smaller values converge faster but need u << sqrt(gamma) * cs
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_MRT_PRE
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double gamma,
+            double initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates preconditioned MRT collision model for steady NS
+        // equation with variable density at each node. Throws exception if gamma
+        // is not in (0, 1]
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param gamma preconditioning parameter
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_MRT_PRE
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double gamma,
+            const std::vector<double> &initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_MRT_PRE() = default;
+        // Calculates the preconditioned equilibrium distribution function with
+        // computePreconditionedfEq
+        void computefEq();
+        // Calculates the equilibrium moments with the quadratic terms of energy,
+        // energy square and stress divided by gamma
+        void computemEq();
+        // Computes density and velocity like collisionD2Q9_MRT, the pressure is
+        // gamma * cs^2 * (rho - 1) since the effective speed of sound is
+        // sqrt(gamma) * cs
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void computeMacroscopicProperties
+        (
+            const latticeArray<double> &df
+        );
+        // Sets the viscosity and the density of each node for another case, the
+        // preconditioning parameter is kept
+        // param kinematic_viscosity kinematic viscosity of the case
+        // param initial_density initial density of the lattice
+        void reset
+        (
+            double kinematic_viscosity,
+            double initial_density
+        );
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its computefEq() and
+        // computeMacroscopicProperties() sweep the whole lattice
+        bool isNodeRangeSupported() const;
+    private:
+        // Preconditioning parameter
+        double gamma_;
+};
+
+#endif // COLLISIOND2Q9_MRT_PRE_HPP_INCLUDED
@@ -0,0 +1,54 @@
+#ifndef COLLISIOND2Q9_RBGK_HPP_INCLUDED
+#define COLLISIOND2Q9_RBGK_HPP_INCLUDED
+
+#include "latticeModel.hxx"
+#include "collisionD2Q9_BGK.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_RBGK: public collisionD2Q9_BGK
+{
+    public:
+        // Constructor: Creates regularized BGK collision model for NS equation with
+        // the same density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_RBGK
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates regularized BGK collision model for NS equation with
+        // variable density at each node
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_RBGK
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            const std::vector<double> &initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_RBGK() = default;
+        // Collides according to "Lattice Boltzmann method with regularized
+        // pre-collision distribution functions" Latt2006: the non-equilibrium part
+        // is replaced by its projection on the second order Hermite polynomial,
+        // which removes the ghost modes that make BGK unstable at small tau
+        // param lattice latticeArray containing distribution functions
+        void collide
+        (
+            latticeArray<double> &df_lattice
+        );
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its collide() sweeps the whole lattice
+        bool isNodeRangeSupported() const;
+};
+
+#endif // COLLISIOND2Q9_RBGK_HPP_INCLUDED
@@ -0,0 +1,133 @@
+#ifndef COLLISIOND2Q9_SC_HPP_INCLUDED
+#define COLLISIOND2Q9_SC_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+#include "collisionD2Q9_BGK.hpp"
+
+#include "latticeBase.hpp"
+
+class collisionD2Q9_SC: public collisionD2Q9_BGK
+{
+    public:
+        // Constructor: Creates single component Shan-Chen multiphase collision model
+        // with the same density at each node. The pseudopotential is
+        // psi = rho_ref * (1 - exp(-rho / rho_ref)) with rho_ref = 1, phases separate
+        // for G < -4
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param interaction_strength G, e.g. -5.0 gives liquid and gas densities of
+        //       about 1.9 and 0.16
+        // param wall_density density which sets the pseudopotential of solid nodes,
+        //       the liquid density makes walls wetting, the gas density non-wetting
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_SC
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double interaction_strength,
+            double wall_density,
+            double initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Constructor: Creates single component Shan-Chen multiphase collision model
+        // with variable density at each node, e.g. a droplet
+        // param lm lattice model used for simulation
+        // param kinematic viscosity
+        // param interaction_strength G
+        // param wall_density density which sets the pseudopotential of solid nodes
+        // param initial_density_f initial density of NS lattice
+        collisionD2Q9_SC
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            double interaction_strength,
+            double wall_density,
+            const std::vector<double> &initial_density_f,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Virtual destructor since we may be deriving from this class
+        virtual ~collisionD2Q9_SC() = default;
+        // Sets whether the interaction force wraps around the lattice edges, which
+        // should match periodic nodes of the stream. Neighbours outside of a
+        // non-periodic edge act like solid nodes, which suits half-way bounceback
+        // walls on the edge. Both directions are non-periodic by default
+        // param is_periodic_x force wraps around the left and right edges
+        // param is_periodic_y force wraps around the bottom and top edges
+        void setPeriodic
+        (
+            bool is_periodic_x,
+            bool is_periodic_y
+        );
+        // Computes density, interaction force and velocity in a single sweep. The
+        // force of a row needs the pseudopotential of the rows below and above,
+        // so it is computed one row behind the density. The velocity includes half
+        // of the force according to Guo2002
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void computeMacroscopicProperties
+        (
+            const latticeArray<double> &df
+        );
+        // Adds a solid node which takes the wall pseudopotential and is excluded
+        // from the collision step
+        // param n index of the node in the lattice
+        void addNodeToSkip
+        (
+            std::size_t n
+        );
+        // Collides with the BGK operator and the forcing term of "Discrete lattice
+        // effects on the forcing term in the lattice Boltzmann method" Guo2002
+        // param lattice latticeArray containing distribution functions
+        void collide
+        (
+            latticeArray<double> &df_lattice
+        );
+        // Get the Shan-Chen interaction force
+        // return force at each node
+        const latticeArray<double> &getForce() const;
+        // Checks if the sweeps can be restricted to a range of nodes
+        // return FALSE since its collide() and
+        // computeMacroscopicProperties() sweep the whole lattice
+        bool isNodeRangeSupported() const;
+    private:
+        // Sizes the pseudopotential and force arrays and the neighbour offsets
+        void initialize();
+        // Pseudopotential of a density
+        // param rho density
+        double getPseudopotential
+        (
+            double rho
+        ) const;
+        // Computes the interaction force F = -G * psi(x) * sum w_i * psi(x + e_i) * e_i
+        // of a row according to "Lattice Boltzmann model for simulating flows with
+        // multiple phases and components" Shan1993
+        // param y row of the lattice
+        void computeForceRow
+        (
+            std::size_t y
+        );
+        // Interaction strength G
+        double G_;
+        // Pseudopotential of solid nodes and of neighbours outside of non-periodic
+        // edges
+        double psi_wall_;
+        // Force wraps around the left and right edges
+        bool is_periodic_x_;
+        // Force wraps around the bottom and top edges
+        bool is_periodic_y_;
+        // false until the force matches the density and solid nodes
+        bool is_force_current_;
+        // Neighbour offsets of the directions in grid units
+        std::vector<int> offset_x_;
+        std::vector<int> offset_y_;
+        // Pseudopotential at each node
+        std::vector<double> psi_;
+        // Interaction force at each node
+        latticeArray<double> force_;
+};
+
+#endif // COLLISIOND2Q9_SC_HPP_INCLUDED
@@ -0,0 +1,153 @@
+#ifndef DIAGNOSTICS_HPP_INCLUDED
+#define DIAGNOSTICS_HPP_INCLUDED
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "bouncebackNode.hpp"
+
+class diagnostics
+{
+    public:
+        // Integrated quantities which can be registered with addIntegral()
+        enum e_integrals
+        {
+            MASS,
+            KINETIC_ENERGY,
+            ENSTROPHY
+        };
+        // Walls which can be registered with addWallShear()
+        enum e_walls
+        {
+            RIGHT,
+            TOP,
+            LEFT,
+            BOTTOM
+        };
+        // Constructor: Creates a lightweight in-situ monitor which evaluates point
+        // probes, line samples and integrated quantities on the lattice and appends
+        // them as one row per evaluation to a CSV time series
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param cb collision model which contains information on lattice density
+        // param field fluid field which contains pressure and velocity
+        // param file_name name of the CSV time series file
+        // param interval number of time steps between two evaluations
+        diagnostics
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            fluidField &field,
+            const std::string &file_name,
+            std::size_t interval
+        );
+        diagnostics(const diagnostics&) = delete;
+        diagnostics& operator= (const diagnostics&) = delete;
+        // Destructor
+        ~diagnostics() = default;
+        // Adds a point probe which records pressure and velocity of a single node
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addProbe
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Adds a line sample which records the velocity profile along a full
+        // lattice line, e.g. the centre-lines of a cavity
+        // param is_vertical TRUE samples the column x = position
+        //                   FALSE samples the row y = position
+        // param position index of the sampled column or row
+        void addLineSample
+        (
+            bool is_vertical,
+            std::size_t position
+        );
+        // Adds an integrated quantity over all fluid nodes. Nodes skipped by the
+        // collision model, i.e. solid nodes of full-way bounceback obstacles, are
+        // left out, and the enstrophy takes them as walls at rest
+        // param quantity one of MASS, KINETIC_ENERGY and ENSTROPHY
+        void addIntegral
+        (
+            e_integrals quantity
+        );
+        // Adds the mean wall shear stress along a straight domain wall, computed
+        // with a first-order one-sided difference of the tangential velocity
+        // between the wall node and its first neighbour
+        // param wall one of RIGHT, TOP, LEFT and BOTTOM
+        // param kinematic_viscosity kinematic viscosity of the fluid
+        void addWallShear
+        (
+            e_walls wall,
+            double kinematic_viscosity
+        );
+        // Adds the momentum-exchange force on an obstacle, force evaluation is
+        // toggled on the bounceback nodes
+        // param bb bounceback nodes which contain the obstacle
+        // param obstacle_id ID of the obstacle used in bouncebackNode::addObstacleNode()
+        void addForce
+        (
+            bouncebackNode &bb,
+            std::size_t obstacle_id
+        );
+        // Evaluates all registered diagnostics and appends them to the time series
+        // if time is a multiple of the interval. Called by LatticeBoltzmann
+        // takeStep() after the macroscopic properties have been updated
+        // param time time point
+        void evaluate
+        (
+            std::size_t time
+        );
+        // Values of the last evaluation in the same order as the CSV columns
+        std::vector<double> values;
+    private:
+        // Writes the CSV header, called at the first evaluation so that all
+        // diagnostics registered beforehand are included
+        void writeHeader();
+        // Computes an integrated quantity over the fluid nodes of the lattice with
+        // a parallel reduction
+        // param quantity one of MASS, KINETIC_ENERGY and ENSTROPHY
+        // return integrated quantity
+        double computeIntegral
+        (
+            e_integrals quantity
+        );
+        // Computes the mean wall shear stress along a domain wall
+        // param wall one of RIGHT, TOP, LEFT and BOTTOM
+        // param kinematic_viscosity kinematic viscosity of the fluid
+        // return mean wall shear stress
+        double computeWallShear
+        (
+            e_walls wall,
+            double kinematic_viscosity
+        );
+        // Reference to LatticeModel
+        latticeBase &lb_;
+        // Collision model which contains information on lattice density
+        collisionBase &cb_;
+        // define fluid field;
+        fluidField &field_;
+        // Number of time steps between two evaluations
+        std::size_t interval_;
+        // Node indices of the point probes
+        std::vector<std::size_t> probes_;
+        // Orientation and position of the line samples
+        std::vector<std::pair<bool, std::size_t>> lines_;
+        // Registered integrated quantities
+        std::vector<e_integrals> integrals_;
+        // Registered walls and the kinematic viscosity used for their shear stress
+        std::vector<std::pair<e_walls, double>> walls_;
+        // Registered bounceback nodes and obstacle IDs for force evaluation
+        std::vector<std::pair<bouncebackNode*, std::size_t>> forces_;
+        // Output stream of the CSV time series
+        std::ofstream file_;
+        // Boolean toggle to indicate if the CSV header has been written
+        bool is_header_written_;
+};
+
+#endif // DIAGNOSTICS_HPP_INCLUDED
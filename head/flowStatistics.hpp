@@ -0,0 +1,102 @@
+#ifndef FLOWSTATISTICS_HPP_INCLUDED
+#define FLOWSTATISTICS_HPP_INCLUDED
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+
+class flowStatistics
+{
+    public:
+        // Quantities of each node which can be read with getValue()
+        enum e_quantities
+        {
+            MEAN_PRESSURE,
+            MEAN_VELOCITY_X,
+            MEAN_VELOCITY_Y,
+            PRESSURE_VARIANCE,
+            REYNOLDS_STRESS_XX,
+            REYNOLDS_STRESS_YY,
+            REYNOLDS_STRESS_XY
+        };
+        // Constructor: Creates an accumulator of the time-averaged pressure and
+        // velocity and of their fluctuations, i.e. the pressure variance and the
+        // Reynolds stresses <u'_a u'_b>. Each node keeps its running means and
+        // sums of squared deviations, updated with the one-pass algorithm of
+        // "Note on a method for calculating corrected sums of squares and
+        // products" Welford1962, so long averages of small fluctuations do not
+        // cancel. Throws exception for a zero stride
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param field fluid field which contains pressure and velocity
+        // param first_step first time step which is sampled, e.g. after the
+        //       start-up transient
+        // param stride number of time steps between two samples
+        flowStatistics
+        (
+            latticeBase &lb,
+            fluidField &field,
+            std::size_t first_step,
+            std::size_t stride
+        );
+        // Destructor
+        ~flowStatistics() = default;
+        // Checks whether a time step is sampled
+        // param time time step after which the macroscopic properties are sampled
+        // return TRUE if the time step is sampled
+        bool isSampled
+        (
+            std::size_t time
+        ) const;
+        // Samples all nodes if the time step is sampled, the nodes are updated in
+        // parallel
+        // param time time step after which the macroscopic properties are sampled
+        void sample
+        (
+            std::size_t time
+        );
+        // Starts a sample whose nodes are then updated range by range with
+        // sampleNodes(), e.g. by the macroscopic tasks of a task scheduled step
+        void startSample();
+        // Updates a range of nodes with the macroscopic properties of the sample
+        // started last
+        // param first_node first node of the range
+        // param last_node one past the last node of the range
+        void sampleNodes
+        (
+            std::size_t first_node,
+            std::size_t last_node
+        );
+        // Discards all samples
+        void reset();
+        // Get the number of samples
+        // return number of samples
+        std::size_t getNumberOfSamples() const;
+        // Get a quantity of a node. Variance and Reynolds stresses are the means
+        // of the products of the fluctuations over the samples, all quantities are
+        // 0 without samples
+        // param n index of the node
+        // param quantity quantity of the node
+        // return value of the quantity
+        double getValue
+        (
+            std::size_t n,
+            e_quantities quantity
+        ) const;
+    private:
+        // Lattice model to handle number of rows and columns
+        latticeBase &lb_;
+        // define fluid field;
+        fluidField &field_;
+        // First sampled time step and number of time steps between two samples
+        std::size_t first_step_;
+        std::size_t stride_;
+        // Number of samples
+        std::size_t num_samples_;
+        // Running means of pressure and velocity and sums of the squared
+        // deviations of each node, in the order of e_quantities
+        latticeArray<double> moments_;
+};
+
+#endif // FLOWSTATISTICS_HPP_INCLUDED
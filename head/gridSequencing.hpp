@@ -0,0 +1,137 @@
+#ifndef GRIDSEQUENCING_HPP_INCLUDED
+#define GRIDSEQUENCING_HPP_INCLUDED
+
+#include <memory>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeBase.hpp"
+#include "latticeBoltzmann.hpp"
+#include "nodeTypeField.hpp"
+
+class gridSequencing
+{
+    public:
+        // Constructor: Creates a grid sequencing driver which converges a steady
+        // flow on a hierarchy of coarser lattices, each half the size of the next,
+        // before the fine lattice takes its first step. The lattice velocity is
+        // kept on every level and the viscosity halves with every coarsening, so
+        // the Reynolds number stays the same
+        // param lb fine lattice, nx and ny must be divisible by 2^(num_levels - 1)
+        // param kinematic_viscosity kinematic viscosity on the fine lattice
+        // param num_levels number of levels including the fine lattice
+        // param tolerance steady state tolerance of checkSteadyState
+        // param check_interval number of steps between two steady state checks
+        // param max_steps maximum number of steps on each coarse level
+        gridSequencing
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            std::size_t num_levels,
+            double tolerance,
+            std::size_t check_interval,
+            std::size_t max_steps
+        );
+        // Virtual destructor since the boundaries are set by a derived class
+        virtual ~gridSequencing() = default;
+        // Converges the coarse levels one after another, coarsest first, and
+        // initialises the fine lattice with the solution of the finest coarse
+        // level. Density and velocity are interpolated bilinearly, the
+        // non-equilibrium part of the distribution functions is interpolated and
+        // rescaled to the gradients and relaxation time of the finer level
+        // param run LatticeBoltzmann of the fine lattice, its distribution
+        //       functions are overwritten
+        // param cb collision model of the fine lattice, its density is overwritten
+        // param field fluid field of the fine lattice, its velocity is overwritten
+        // return number of steps taken on the coarse levels
+        std::size_t initialize
+        (
+            latticeBoltzmann &run,
+            collisionBase &cb,
+            fluidField &field
+        );
+        // Creates the collision model of a coarse level
+        // param lb lattice of the level
+        // param kinematic_viscosity kinematic viscosity of the level
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field of the level
+        virtual std::unique_ptr<collisionBase> makeCollision
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        ) = 0;
+        // Registers the boundaries of a coarse level, coordinates are those of the
+        // level, e.g. nx - 1 is the right edge of the level
+        // param lb lattice of the level
+        // param cb collision model of the level
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field of the level
+        // param types node type field which is applied by the stream of the level
+        virtual void addBoundaries
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field,
+            nodeTypeField &types
+        ) = 0;
+    private:
+        // Converged solution of a level, stored row-wise
+        struct levelSolution
+        {
+            // Number of grid along x coordinate
+            std::size_t nx;
+            // Number of grid along y coordinate
+            std::size_t ny;
+            // Relaxation time of the level
+            double tau;
+            // Density
+            std::vector<double> rho;
+            // Velocity
+            latticeArray<double> u;
+            // Non-equilibrium part of the distribution functions
+            latticeArray<double> fneq;
+        };
+        // Relaxation time of a viscosity in lattice units of the fine lattice
+        // param kinematic_viscosity kinematic viscosity
+        double getRelaxationTime
+        (
+            double kinematic_viscosity
+        ) const;
+        // Sets density, velocity and distribution functions of a lattice from the
+        // solution of the next coarser level
+        // param coarse solution of the next coarser level
+        // param lb lattice to be initialised
+        // param tau relaxation time of the lattice
+        // param df distribution functions of the lattice
+        // param cb collision model of the lattice
+        // param field fluid field of the lattice
+        void prolongate
+        (
+            const levelSolution &coarse,
+            latticeBase &lb,
+            double tau,
+            latticeArray<double> &df,
+            collisionBase &cb,
+            fluidField &field
+        );
+        // Fine lattice
+        latticeBase &lb_;
+        // Kinematic viscosity on the fine lattice
+        double kinematic_viscosity_;
+        // Number of levels including the fine lattice
+        std::size_t num_levels_;
+        // Steady state tolerance
+        double tolerance_;
+        // Number of steps between two steady state checks
+        std::size_t check_interval_;
+        // Maximum number of steps on each coarse level
+        std::size_t max_steps_;
+};
+
+#endif // GRIDSEQUENCING_HPP_INCLUDED
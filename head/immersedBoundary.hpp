@@ -0,0 +1,144 @@
+#ifndef IMMERSEDBOUNDARY_HPP_INCLUDED
+#define IMMERSEDBOUNDARY_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "boundaryNode.hxx"
+
+class immersedBoundary: public boundaryNode
+{
+    public:
+        // Lagrangian marker on the surface of the body
+        struct marker
+        {
+            // Position in grid units, node (x, y) lies at (x, y)
+            double x;
+            double y;
+            // Velocity of the surface at the marker
+            double u_x;
+            double u_y;
+            // Position relative to the centre of the body at zero rotation angle
+            double x_ref;
+            double y_ref;
+            // Length of the surface represented by the marker in grid units
+            double length;
+            // Force of the fluid on the marker in the last step
+            double f_x;
+            double f_y;
+        };
+        // Constructor: Creates an immersed body whose surface is represented by
+        // Lagrangian markers, according to "Simulating the flow around moving
+        // bodies with an immersed boundary-lattice Boltzmann method" Kang2011.
+        // After streaming, the fluid velocity is interpolated to the markers, the
+        // difference to the marker velocity is spread back to the nodes around
+        // them and added to their distribution functions with the exact difference
+        // method, so it works with every collision model. Only the nodes within
+        // 1.5 grid units of a marker are visited, the markers of a moving body are
+        // moved instead of rebuilding boundary nodes. The stencil wraps around the
+        // lattice edges, so bodies should stay two nodes away from non-periodic
+        // edges. Add it to LatticeBoltzmann with addBoundaryNode()
+        // param lb lattice model
+        // param D2Q9 lattice model D2Q9
+        // param centre_x x-coordinate of the centre of rotation of the body
+        // param centre_y y-coordinate of the centre of rotation of the body
+        // param num_iterations number of interpolation and spreading passes per
+        //       step, more passes enforce the marker velocity more closely
+        immersedBoundary
+        (
+            latticeBase &lb,
+            latticeModelD2Q9 &D2Q9,
+            double centre_x,
+            double centre_y,
+            std::size_t num_iterations
+        );
+        // Virtual destructor since the kinematics may be overridden
+        virtual ~immersedBoundary() = default;
+        // Adds a marker on the surface of the body
+        // param x x-coordinate of the marker in grid units
+        // param y y-coordinate of the marker in grid units
+        // param length length of the surface represented by the marker, should be
+        //       close to one grid unit
+        void addMarker
+        (
+            double x,
+            double y,
+            double length
+        );
+        // Sets the rigid body motion used by the default moveMarkers()
+        // param u_x x-velocity of the centre
+        // param u_y y-velocity of the centre
+        // param angular_velocity angular velocity about the centre, counterclockwise
+        //       positive
+        void setMotion
+        (
+            double u_x,
+            double u_y,
+            double angular_velocity
+        );
+        // Sets position and velocity of the markers at the given time. Moves the
+        // body as a rigid body with the velocity of setMotion(), override it for
+        // prescribed deformations such as a flapping plate
+        // param time time after the step
+        virtual void moveMarkers
+        (
+            double time
+        );
+        // Moves the markers and enforces their velocity on the fluid
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param is_modify_stream unused, the body is applied after streaming
+        void updateNode
+        (
+            latticeArray<double> &df,
+            bool is_modify_stream
+        );
+        // Get the force of the fluid on the body in the last step
+        // return force
+        std::vector<double> getForce() const;
+        // Get the torque of the fluid on the body about its centre in the last step
+        // return counterclockwise torque
+        double getTorque() const;
+        // Markers of the body
+        std::vector<marker> markers;
+    protected:
+        // Centre of rotation of the body
+        double centre_x_;
+        double centre_y_;
+        // Velocity of the centre
+        double u_x_;
+        double u_y_;
+        // Rotation angle and angular velocity
+        double angle_;
+        double angular_velocity_;
+        // Time of the markers
+        double time_;
+    private:
+        // Kernel of "A multigrid method for the immersed boundary method" Roma1999,
+        // support of 1.5 grid units
+        // param r distance from the node in grid units
+        double getKernel
+        (
+            double r
+        ) const;
+        // lattice model D2Q9
+        latticeModelD2Q9 &D2Q9_;
+        // Number of interpolation and spreading passes per step
+        std::size_t num_iterations_;
+        // Index of each lattice node in the support arrays, the number of nodes for
+        // nodes outside the support. Only the entries of the support are reset
+        std::vector<std::size_t> support_index_;
+        // Lattice nodes within the support of the markers
+        std::vector<std::size_t> support_nodes_;
+        // Density, velocity and velocity correction of the support nodes
+        std::vector<double> support_rho_;
+        latticeArray<double> support_u_;
+        latticeArray<double> support_du_;
+        // Support node and kernel weight of the 3 x 3 stencil of each marker
+        std::vector<std::size_t> stencil_nodes_;
+        std::vector<double> stencil_weights_;
+};
+
+#endif // IMMERSEDBOUNDARY_HPP_INCLUDED
@@ -0,0 +1,297 @@
+#ifndef LATTICEARRAY_HXX_INCLUDED
+#define LATTICEARRAY_HXX_INCLUDED
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mappedFile.hpp"
+
+template <typename T>
+class latticeArray
+{
+    public:
+        // Constructor: Creates an empty array
+        latticeArray()
+        : data_ {},
+          file_ {},
+          values_ {nullptr},
+          num_values_ {0},
+          width_ {1}
+        {};
+        // Constructor: Creates a contiguous array with a fixed number of values at
+        // each node, stored node by node in a single 1D vector so that df[n][i] can
+        // still be used while the whole lattice lives in one block of memory
+        // param num_nodes number of nodes in the lattice
+        // param width number of values at each node
+        // param value initial value
+        latticeArray
+        (
+            std::size_t num_nodes,
+            std::size_t width,
+            T value
+        )
+        : data_ (num_nodes * width, value),
+          file_ {},
+          values_ {data_.data()},
+          num_values_ {data_.size()},
+          width_ {width}
+        {};
+        // Constructor: Creates a contiguous array with the same values at each node
+        // param num_nodes number of nodes in the lattice
+        // param node_value values at each node
+        latticeArray
+        (
+            std::size_t num_nodes,
+            const std::vector<T> &node_value
+        )
+        : data_ {},
+          file_ {},
+          values_ {nullptr},
+          num_values_ {0},
+          width_ {node_value.size()}
+        {
+            data_.reserve(num_nodes * width_);
+            for (auto n = 0u; n < num_nodes; ++n)
+            {
+                data_.insert(end(data_), begin(node_value), end(node_value));
+            }  // n
+            values_ = data_.data();
+            num_values_ = data_.size();
+        };
+        // Constructor: Creates a contiguous array from values stored row-wise in a
+        // 2D vector, all rows must have the same length
+        // param values values at each node
+        latticeArray
+        (
+            const std::vector<std::vector<T>> &values
+        )
+        : data_ {},
+          file_ {},
+          values_ {nullptr},
+          num_values_ {0},
+          width_ {values.empty() ? 1 : values.front().size()}
+        {
+            data_.reserve(values.size() * width_);
+            for (auto &node : values) data_.insert(end(data_), begin(node), end(node));
+            values_ = data_.data();
+            num_values_ = data_.size();
+        };
+        // Copy constructor: the copy is always held in memory, e.g. to keep the
+        // velocity of the last step
+        latticeArray
+        (
+            const latticeArray &other
+        )
+        : data_ (other.values_, other.values_ + other.num_values_),
+          file_ {},
+          values_ {data_.data()},
+          num_values_ {other.num_values_},
+          width_ {other.width_}
+        {};
+        latticeArray
+        (
+            latticeArray &&other
+        )
+        : data_ {std::move(other.data_)},
+          file_ {std::move(other.file_)},
+          values_ {other.values_},
+          num_values_ {other.num_values_},
+          width_ {other.width_}
+        {
+            other.values_ = nullptr;
+            other.num_values_ = 0;
+        };
+        // Copy assignment: an array backed by a file keeps its file
+        latticeArray& operator=
+        (
+            const latticeArray &other
+        )
+        {
+            if (this == &other) return *this;
+            if (file_)
+            {
+                resizeFile(other.num_values_);
+                std::copy(other.values_, other.values_ + other.num_values_, values_);
+            }
+            else
+            {
+                data_.assign(other.values_, other.values_ + other.num_values_);
+                values_ = data_.data();
+            }
+            num_values_ = other.num_values_;
+            width_ = other.width_;
+            return *this;
+        };
+        latticeArray& operator=
+        (
+            latticeArray &&other
+        )
+        {
+            if (this == &other) return *this;
+            data_ = std::move(other.data_);
+            file_ = std::move(other.file_);
+            values_ = other.values_;
+            num_values_ = other.num_values_;
+            width_ = other.width_;
+            other.values_ = nullptr;
+            other.num_values_ = 0;
+            return *this;
+        };
+        // Resizes the array and sets all values
+        // param num_nodes number of nodes in the lattice
+        // param width number of values at each node
+        // param value value to be assigned
+        void assign
+        (
+            std::size_t num_nodes,
+            std::size_t width,
+            T value
+        )
+        {
+            width_ = width;
+            if (file_)
+            {
+                resizeFile(num_nodes * width);
+                std::fill(values_, values_ + num_nodes * width, value);
+            }
+            else
+            {
+                data_.assign(num_nodes * width, value);
+                values_ = data_.data();
+            }
+            num_values_ = num_nodes * width;
+        };
+        // Moves the values into a scratch file in a directory which is mapped into
+        // memory, so that the array can be larger than the memory of the node.
+        // The values stay accessible as before
+        // param directory directory of the scratch file, e.g. on local NVMe
+        void mapToFile
+        (
+            const std::string &directory
+        )
+        {
+            if (file_) return;
+            file_.reset(new mappedFile(directory, num_values_ * sizeof(T)));
+            auto *mapped = static_cast<T*>(file_->data());
+            std::copy(values_, values_ + num_values_, mapped);
+            std::vector<T>().swap(data_);
+            values_ = mapped;
+            file_->adviseSequential();
+        };
+        // Starts reading the values of a range of nodes of a file-backed array,
+        // does nothing for an array held in memory
+        // param first_node first node of the range
+        // param num_nodes number of nodes in the range
+        void prefetch
+        (
+            std::size_t first_node,
+            std::size_t num_nodes
+        )
+        {
+            if (file_) file_->prefetch(first_node * width_ * sizeof(T), num_nodes * width_ * sizeof(T));
+        };
+        // Starts writing the values of a range of nodes of a file-backed array and
+        // releases their memory, does nothing for an array held in memory
+        // param first_node first node of the range
+        // param num_nodes number of nodes in the range
+        void writeBehind
+        (
+            std::size_t first_node,
+            std::size_t num_nodes
+        )
+        {
+            if (file_) file_->writeBehind(first_node * width_ * sizeof(T), num_nodes * width_ * sizeof(T));
+        };
+        // Get the number of nodes of the slabs in which sweeps read ahead and write
+        // behind a file-backed array, whole rows of about mappedFile::slab_bytes
+        // param nx number of nodes in a row
+        // return number of nodes of a slab, all nodes for an array held in memory
+        std::size_t getSlabNodes
+        (
+            std::size_t nx
+        ) const
+        {
+            if (!file_) return size();
+            const std::size_t slab_rows = mappedFile::slab_bytes / (nx * width_ * sizeof(T));
+            return std::min(std::max(slab_rows, std::size_t {1}) * nx, size());
+        };
+        // Drops the values of a file-backed array which are no longer needed
+        // without writing them, they read as zero afterwards. Does nothing for an
+        // array held in memory
+        void discard()
+        {
+            if (file_) file_->discard(0, num_values_ * sizeof(T));
+        };
+        // Get if the array is backed by a file
+        // return true if the array is backed by a file
+        bool isMapped() const
+        {
+            return static_cast<bool>(file_);
+        };
+        // Access the values of a node
+        // param n index of the node in the lattice
+        // return pointer to the first value of the node
+        T* operator[](std::size_t n)
+        {
+            return values_ + n * width_;
+        };
+        const T* operator[](std::size_t n) const
+        {
+            return values_ + n * width_;
+        };
+        // Copies the values of a node, e.g. to keep them across an update
+        // param n index of the node in the lattice
+        // return values of the node
+        std::vector<T> getNode(std::size_t n) const
+        {
+            return std::vector<T>(values_ + n * width_, values_ + (n + 1) * width_);
+        };
+        // Get the number of nodes
+        // return number of nodes
+        std::size_t size() const
+        {
+            return num_values_ / width_;
+        };
+        // Get the number of values at each node
+        // return number of values at each node
+        std::size_t width() const
+        {
+            return width_;
+        };
+        // Get the underlying contiguous memory
+        // return pointer to the first value of the first node
+        T* data()
+        {
+            return values_;
+        };
+        const T* data() const
+        {
+            return values_;
+        };
+    private:
+        // Resizes the scratch file to a number of values
+        // param num_values number of values
+        void resizeFile
+        (
+            std::size_t num_values
+        )
+        {
+            file_->resize(num_values * sizeof(T));
+            values_ = static_cast<T*>(file_->data());
+        };
+        // Values stored node by node in a 1D vector, empty if backed by a file
+        std::vector<T> data_;
+        // Scratch file which holds the values instead of data_, if any
+        std::unique_ptr<mappedFile> file_;
+        // Values stored node by node, in data_ or the scratch file
+        T* values_;
+        // Number of values
+        std::size_t num_values_;
+        // Number of values at each node
+        std::size_t width_;
+};
+
+#endif // LATTICEARRAY_HXX_INCLUDED
@@ -4,6 +4,8 @@
 #include <iostream>
 //#include <vector>
 
+#include "nodeOrdering.hpp"
+
 class latticeBase
 {
     public:
@@ -21,6 +23,24 @@ class latticeBase
             double dl,
             double dt
         );
+        // Constructor: creates lattice model whose nodes are stored in a tiled order
+        // param num_dims number of dimensions
+        // param num_dirs number of discrete directions
+        // param dx space step
+        // param dt time step
+        // param ordering storage order of the tiles, see nodeOrdering
+        // param tile_size number of grid along each side of a tile
+        latticeBase
+        (
+            std::size_t nx,
+            std::size_t ny,
+            std::size_t num_dims,
+            std::size_t num_dirs,
+            double dl,
+            double dt,
+            nodeOrdering::e_orderings ordering,
+            std::size_t tile_size
+        );
         // Constructor: creates lattice model with the same velocity at each node
         // param num_dims number of dimensions
         // param num_dirs number of discrete directions
@@ -63,6 +83,21 @@ class latticeBase
         // Get the lattice speed (c) of the model
         // return lattice speed of the model
         double getLatticeSpeed() const;
+        // Get the storage order of the nodes
+        // return storage order of the nodes
+        const nodeOrdering& getNodeOrdering() const;
+        // Get the index of a node in the lattice arrays, use instead of y * nx + x
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // return index of the node
+        std::size_t getNodeIndex
+        (
+            std::size_t x,
+            std::size_t y
+        ) const
+        {
+            return ordering_.getIndex(x, y);
+        }
         // Checks if input parameters for lattice base is valid, prevents creation of
         // invalid lattice base, such as a size 0 x 0 lattice
         // return validity of lattice base
@@ -86,6 +121,8 @@ class latticeBase
         double time_step_;
         // Propagation speed on the lattice. Based on "Introduction to Lattice Boltzmann Methods"
         double c_ = space_step_ / time_step_;
+        // Storage order of the nodes
+        nodeOrdering ordering_;
 };
 
 #endif // LATTICEBASE_HPP_INCLUDED
@@ -1,12 +1,19 @@
 #ifndef LATTICEBOLTZMANN_HPP_INCLUDED
 #define LATTICEBOLTZMANN_HPP_INCLUDED
 
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "latticeBase.hpp"
 #include "collisionBase.hxx"
 #include "streamBase.hxx"
 #include "boundaryNode.hxx"
+#include "diagnostics.hpp"
+#include "flowStatistics.hpp"
+#include "tracerParticles.hpp"
+#include "stepScheduler.hpp"
 
 class latticeBoltzmann
 {
@@ -23,7 +30,8 @@ class latticeBoltzmann
             collisionBase &cb,
             streamBase &sb
         );
-        latticeBoltzmann(const latticeBoltzmann&) = default;
+        latticeBoltzmann(const latticeBoltzmann&) = delete;
+        latticeBoltzmann& operator= (const latticeBoltzmann&) = delete;
         ~latticeBoltzmann() = default;
         // Adds a boundary condition to the lattice
         // param bn pointer to the boundary condition to be added
@@ -31,15 +39,84 @@ class latticeBoltzmann
         (
             boundaryNode *bn
         );
+        // Adds in-situ diagnostics which are evaluated at the end of every step
+        // param dg pointer to the diagnostics to be added
+        void addDiagnostics
+        (
+            diagnostics *dg
+        );
+        // Adds flow statistics which sample the macroscopic properties of the
+        // steps they select. The sample is taken right after the macroscopic
+        // properties are computed, by the tasks of each band in task scheduled
+        // steps
+        // param st pointer to the flow statistics to be added
+        void addStatistics
+        (
+            flowStatistics *st
+        );
+        // Adds tracer particles which are advanced at the end of every step
+        // param tp pointer to the tracer particles to be added
+        void addTracers
+        (
+            tracerParticles *tp
+        );
+        // Moves the distribution functions and the equilibrium distribution
+        // functions of the collision model into scratch files in a directory,
+        // e.g. on local NVMe, which are mapped into memory. Lattices larger than
+        // the memory of the node are then paged in and out by the kernel while
+        // the sweeps run through them in node order slab by slab, reading the next
+        // slab ahead. Collision models without node ranges collide and compute
+        // the macroscopic properties in one sweep which only reads its first slab
+        // ahead. If the arrays exceed half of the physical memory, the equilibrium
+        // distribution functions are discarded after the collision instead of
+        // being written back and every sweep writes its finished slabs behind
+        // param directory directory of the scratch files
+        void enableOutOfCore
+        (
+            const std::string &directory
+        );
+        // Runs the time steps as graphs of OpenMP tasks on bands of rows, see
+        // stepScheduler, so that the boundary conditions overlap with the sweeps of
+        // the interior. Results are the same as those of the serial step. Throws
+        // exception for collision models without node ranges, i.e. other than BGK
+        // and MRT, stream models without row ranges, lattices not stored row-wise
+        // and out-of-core distribution functions
+        // param band_rows number of rows of a band, 0 for about four bands per
+        //       thread
+        void enableTaskScheduling
+        (
+            std::size_t band_rows
+        );
+        // Starts another run on the same arrays, e.g. for the next case of the same
+        // size: removes the boundaries, diagnostics, statistics and tracers, stops
+        // task scheduling and sets the distribution functions to the equilibrium
+        // of the current macroscopic properties. Out-of-core arrays stay in their
+        // scratch files
+        void reset();
         // Performs one cycle of evolution equation, computes the relevant macroscopic
         // properties such as velocity and density
         void takeStep();
+        // Get the lattice distribution functions, their memory stays the same
+        // between time steps so that it can be viewed from outside the solver
+        // return lattice distribution functions stored row-wise in a latticeArray
+        latticeArray<double>& getDistributionFunctions();
         // by reference, similar to by pointer
         // https://stackoverflow.com/questions/9285627/is-it-possible-to-pass-derived-
         // classes-by-reference-to-a-function-taking-base-cl
     private:
-        // Lattice distribution function stored row-wise in a 2D vector
-        std::vector<std::vector<double>> df;
+        // Runs a sweep of the collision model slab by slab over out-of-core
+        // distribution functions, reading the next slab ahead and writing the
+        // finished slab behind if the arrays are paged
+        // param is_eqdf TRUE if the sweep also reads the equilibrium distribution
+        //       functions ahead
+        // param sweep callable which calls the sweep, restricted to each slab
+        void sweepSlabs
+        (
+            bool is_eqdf,
+            const std::function<void()> &sweep
+        );
+        // Lattice distribution function stored row-wise in a latticeArray
+        latticeArray<double> df;
         // Lattice model which contains information on the number of rows, columns,
         // dimensions, discrete directions and lattice velocity
         latticeBase &lb_;
@@ -50,6 +127,22 @@ class latticeBoltzmann
         // Pointers to boundary conditions in the lattice stored in a vector.
         // References cannot be used as it is not possible to store a vector of references
         std::vector<boundaryNode*> bn_;
+        // Pointers to in-situ diagnostics evaluated after the macroscopic properties
+        std::vector<diagnostics*> dg_;
+        // Pointers to flow statistics and to those sampling the current step
+        std::vector<flowStatistics*> st_;
+        std::vector<flowStatistics*> sampled_;
+        // Pointers to tracer particles advanced after the diagnostics
+        std::vector<tracerParticles*> tp_;
+        // Number of steps taken, passed to the diagnostics as time point
+        std::size_t time_;
+        // Number of nodes of the slabs of the sweeps, 0 if the distribution
+        // functions are held in memory
+        std::size_t slab_nodes_;
+        // Boolean toggle to release the pages of the out-of-core arrays every step
+        bool is_paging_;
+        // Task scheduler of the time steps, nullptr for serial steps
+        std::unique_ptr<stepScheduler> scheduler_;
 };
 
 #endif // LATTICEBOLTZMANN_HPP_INCLUDED
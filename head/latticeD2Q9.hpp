@@ -24,6 +24,25 @@ class latticeD2Q9: public latticeBase
             double dt,
             latticeModelD2Q9 &D2Q9
         );
+        // Constructor: Create lattice model for D2Q9 whose nodes are stored in a
+        // tiled order
+        // param num_rows number of nx
+        // param num_cols number of ny
+        // param dl space step
+        // param dt time step
+        // param initial model of the lattice
+        // param ordering storage order of the tiles, see nodeOrdering
+        // param tile_size number of grid along each side of a tile
+        latticeD2Q9
+        (
+            std::size_t num_nx,
+            std::size_t num_ny,
+            double dl,
+            double dt,
+            latticeModelD2Q9 &D2Q9,
+            nodeOrdering::e_orderings ordering,
+            std::size_t tile_size
+        );
         // Destructor
         virtual ~latticeD2Q9() = default;
     private:
@@ -4,12 +4,14 @@
 #include <iostream>
 #include <vector>
 
+#include "latticeArray.hxx"
+
 struct fluidField
 {
     // pressure 1D with n grids * pressure scalar in the field
     std::vector<double> p;
-    // velocity 2D with n grids * velocity vector in the field
-    std::vector<std::vector<double>> u;
+    // velocity with n grids * velocity vector in the field, stored contiguously
+    latticeArray<double> u;
     // Constructor: Create lattice model for D2Q9 with variable velocity at each node
     // param num_rows number of nx
     // param num_cols number of ny
@@ -20,10 +22,9 @@ struct fluidField
         std::size_t num_ny,
         const std::vector<double> &initial_velocity
     )
-    : p {}
-    {
-       u.assign(num_nx * num_ny, initial_velocity);
-    };
+    : p (num_nx * num_ny, 0.0),
+      u (num_nx * num_ny, initial_velocity)
+    {};
     // Constructor: Create lattice model for D2Q9 with variable velocity at each node
     // param num_rows number of nx
     // param num_cols number of ny
@@ -32,10 +33,9 @@ struct fluidField
     (
         const std::vector<std::vector<double>> &initial_velocity
     )
-    : p {}
-    {
-        u = initial_velocity;
-    };
+    : p (initial_velocity.size(), 0.0),
+      u (initial_velocity)
+    {};
     // Destructor
     virtual ~fluidField() = default;
  };
@@ -0,0 +1,157 @@
+#ifndef LOADBALANCER_HPP_INCLUDED
+#define LOADBALANCER_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "latticeBase.hpp"
+
+class loadBalancer
+{
+    public:
+        // Constructor: Creates a scheduler which runs the node sweeps of a
+        // collision model on all OpenMP threads. The node indices are cut into
+        // chunks and each thread owns a contiguous range of chunks, sized by the
+        // estimated cost of the chunks at first and by their measured time after
+        // every rebalance. A thread which runs out of chunks steals the remaining
+        // chunks of the other threads, so that a few slow chunks do not stall a
+        // sweep
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param chunk_nodes number of nodes per chunk, 0 for one row
+        // param rebalance_interval number of sweeps between two rebalances, 0 keeps
+        //       the partition of the estimated costs
+        loadBalancer
+        (
+            latticeBase &lb,
+            std::size_t chunk_nodes,
+            std::size_t rebalance_interval
+        );
+        loadBalancer(const loadBalancer&) = delete;
+        loadBalancer& operator= (const loadBalancer&) = delete;
+        // Destructor
+        ~loadBalancer() = default;
+        // Estimates the cost of each chunk as the number of fluid nodes plus
+        // link_weight times the number of links from fluid nodes to solid nodes or
+        // out of the lattice, and partitions the chunks by these costs
+        // param solid true for nodes which are skipped by the collision
+        // param link_weight cost of a boundary link relative to a fluid node
+        void setCosts
+        (
+            const std::vector<bool> &solid,
+            double link_weight
+        );
+        // Runs a kernel over all nodes, chunk by chunk, on all threads. Chunks of
+        // a sweep may run in any order and concurrently, the kernel must only
+        // write to the nodes of its chunk
+        // param kernel callable kernel(first, last) which updates the nodes with
+        //       index first <= n < last
+        template <typename F>
+        void forEachChunk
+        (
+            F kernel
+        )
+        {
+            for (auto t = 0u; t < num_threads_; ++t) queues_[t].next = queues_[t].first;
+            #pragma omp parallel num_threads(num_threads_)
+            {
+                const auto t = getThreadNumber();
+                const auto start = std::chrono::steady_clock::now();
+                // own chunks first, then the chunks left by the other threads
+                for (auto k = 0u; k < num_threads_; ++k)
+                {
+                    auto &queue = queues_[(t + k) % num_threads_];
+                    for (auto c = queue.next++; c < queue.last; c = queue.next++)
+                    {
+                        const auto chunk_start = std::chrono::steady_clock::now();
+                        kernel(c * chunk_nodes_, std::min((c + 1) * chunk_nodes_, num_nodes_));
+                        chunk_time_[c] += std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - chunk_start).count();
+                        if (k > 0) ++queues_[t].num_stolen;
+                    }  // c
+                }  // k
+                thread_time_[t] += std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                                  start).count();
+            }
+            finishSweep();
+        }
+        // Get the number of threads of the sweeps
+        // return number of threads
+        std::size_t getNumberOfThreads() const;
+        // Get the load imbalance of the last rebalance interval, the busy time of
+        // the slowest thread divided by the mean busy time. 1 is perfectly
+        // balanced
+        // return load imbalance
+        double getImbalance() const;
+        // Get the number of chunks stolen since the last rebalance
+        // return number of stolen chunks
+        std::size_t getNumberOfStolenChunks() const;
+    private:
+        // Chunk range of a thread, padded to the size of a cache line as every
+        // chunk taken increments next. C++11 new does not align beyond 16 bytes
+        struct chunkQueue
+        {
+            // next chunk to be taken, by the owner or a thief
+            std::atomic<std::size_t> next;
+            // first chunk and one past the last chunk of the thread
+            std::size_t first;
+            std::size_t last;
+            // number of chunks the thread took from other queues
+            std::size_t num_stolen;
+            char padding[64 - 4 * sizeof(std::size_t)];
+        };
+        // Get the number of the calling thread, 0 without OpenMP
+        // return thread number
+        static std::size_t getThreadNumber();
+        // Counts the links from a fluid node to solid nodes or out of the lattice
+        // along the eight moving directions of D2Q9
+        // param solid true for nodes which are skipped by the collision
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // return number of boundary links
+        std::size_t getNumberOfBoundaryLinks
+        (
+            const std::vector<bool> &solid,
+            std::size_t x,
+            std::size_t y
+        ) const;
+        // Counts the sweep and rebalances after every rebalance_interval sweeps
+        void finishSweep();
+        // Splits the chunks into contiguous ranges of equal weight, one per thread
+        // param weight weight of each chunk
+        void partition
+        (
+            const std::vector<double> &weight
+        );
+        // Lattice model to handle number of rows, columns and the node order
+        latticeBase &lb_;
+        // Number of nodes of the lattice
+        std::size_t num_nodes_;
+        // Number of nodes per chunk
+        std::size_t chunk_nodes_;
+        // Number of chunks
+        std::size_t num_chunks_;
+        // Number of threads of the sweeps
+        std::size_t num_threads_;
+        // Number of sweeps between two rebalances
+        std::size_t rebalance_interval_;
+        // Number of sweeps since the last rebalance
+        std::size_t num_sweeps_;
+        // Estimated cost of each chunk
+        std::vector<double> cost_;
+        // Time spent in each chunk since the last rebalance
+        std::vector<double> chunk_time_;
+        // Busy time of each thread since the last rebalance
+        std::vector<double> thread_time_;
+        // Load imbalance of the last rebalance interval
+        double imbalance_;
+        // Number of chunks stolen in the last rebalance interval
+        std::size_t num_stolen_;
+        // Chunk range of each thread
+        std::unique_ptr<chunkQueue[]> queues_;
+};
+
+#endif // LOADBALANCER_HPP_INCLUDED
@@ -0,0 +1,125 @@
+#ifndef LOSSYCODEC_HPP_INCLUDED
+#define LOSSYCODEC_HPP_INCLUDED
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+class lossyCodec
+{
+    public:
+        // Kinds of error bounds
+        enum e_bounds
+        {
+            ABSOLUTE,
+            RELATIVE
+        };
+        // Outcome of compressing one or more fields
+        struct statistics
+        {
+            // Size of the fields as doubles
+            std::size_t raw_bytes;
+            // Size of the compressed fields
+            std::size_t compressed_bytes;
+            // Largest absolute difference between a value and its reconstruction
+            double max_error;
+        };
+        // Constructor: Creates an error-bounded lossy codec for smooth 2D fields
+        // in the style of SZ, "Significantly improving lossy compression for
+        // scientific data sets based on multidimensional prediction and
+        // error-controlled quantization" Tao2017. Each value is predicted by the
+        // Lorenzo predictor from its already reconstructed neighbours, the
+        // prediction error is quantized to a multiple of twice the error bound and
+        // the quantization codes are Rice coded in blocks. Values which cannot be
+        // quantized within the bound, e.g. NaN, are stored exactly. Stripes of rows
+        // are compressed independently and in parallel. Throws exception for a
+        // non-positive error bound or stripe size
+        // param bound ABSOLUTE error bound or bound RELATIVE to the value range of
+        //       each field
+        // param error_bound largest allowed absolute error or fraction of the
+        //       value range
+        // param stripe_rows number of rows of a stripe
+        lossyCodec
+        (
+            e_bounds bound,
+            double error_bound,
+            std::size_t stripe_rows
+        );
+        // Destructor
+        ~lossyCodec() = default;
+        // Compresses a field and writes it to a stream
+        // param values field values stored row-wise, nx * ny values
+        // param nx number of columns
+        // param ny number of rows
+        // param out stream of the compressed field
+        // return sizes and largest error of the field
+        statistics compress
+        (
+            const std::vector<double> &values,
+            std::size_t nx,
+            std::size_t ny,
+            std::ostream &out
+        ) const;
+        // Reads a field written by compress() from a stream. Throws exception if
+        // the stream ends early or does not hold a compressed field of this size,
+        // also for stripe sizes beyond the end of the stream
+        // param in stream of the compressed field
+        // param nx number of columns
+        // param ny number of rows
+        // param values reconstructed field values stored row-wise
+        static void decompress
+        (
+            std::istream &in,
+            std::size_t nx,
+            std::size_t ny,
+            std::vector<double> &values
+        );
+        // Smallest number of bytes which compress() writes for a field of this
+        // size, so that a reader can reject a size which a stream cannot hold
+        // param nx number of columns
+        // param ny number of rows
+        // return lower bound of the compressed size
+        static std::uint64_t getMinimumCompressedSize
+        (
+            std::size_t nx,
+            std::size_t ny
+        );
+    private:
+        // Compresses the rows of a stripe
+        // param values first value of the stripe
+        // param nx number of columns
+        // param num_rows number of rows of the stripe
+        // param error_bound absolute error bound
+        // param bytes compressed stripe
+        // return largest error of the stripe
+        static double encodeStripe
+        (
+            const double *values,
+            std::size_t nx,
+            std::size_t num_rows,
+            double error_bound,
+            std::vector<char> &bytes
+        );
+        // Reconstructs the rows of a stripe
+        // param bytes compressed stripe
+        // param nx number of columns
+        // param num_rows number of rows of the stripe
+        // param error_bound absolute error bound
+        // param values first value of the stripe
+        static void decodeStripe
+        (
+            const std::vector<char> &bytes,
+            std::size_t nx,
+            std::size_t num_rows,
+            double error_bound,
+            double *values
+        );
+        // Kind of error bound
+        e_bounds bound_;
+        // Absolute error bound or fraction of the value range
+        double error_bound_;
+        // Number of rows of a stripe
+        std::size_t stripe_rows_;
+};
+
+#endif // LOSSYCODEC_HPP_INCLUDED
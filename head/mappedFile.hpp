@@ -0,0 +1,93 @@
+#ifndef MAPPEDFILE_HPP_INCLUDED
+#define MAPPEDFILE_HPP_INCLUDED
+
+#include <string>
+
+class mappedFile
+{
+    public:
+        // Size of the slabs in which the sweeps read ahead and write behind
+        // mapped files
+        static const std::size_t slab_bytes = 8u << 20;
+        // Constructor: Creates an anonymous scratch file in a directory, e.g. on
+        // local NVMe, and maps it shared into memory. The file is unlinked right
+        // away, so it disappears with the mapping. Pages are read and written by
+        // the kernel on demand, the memory in use is bounded by the page cache
+        // instead of the size of the file
+        // param directory directory of the scratch file
+        // param num_bytes size of the file
+        mappedFile
+        (
+            const std::string &directory,
+            std::size_t num_bytes
+        );
+        mappedFile(const mappedFile&) = delete;
+        mappedFile& operator= (const mappedFile&) = delete;
+        // Destructor: Unmaps and closes the file
+        ~mappedFile();
+        // Changes the size of the file, the mapping may move
+        // param num_bytes new size of the file
+        void resize
+        (
+            std::size_t num_bytes
+        );
+        // Declares that the mapping is swept in increasing address order, the
+        // kernel then reads ahead aggressively and frees pages behind the sweep
+        void adviseSequential();
+        // Starts reading a range asynchronously, e.g. the next slab of a sweep
+        // param offset first byte of the range
+        // param num_bytes size of the range
+        void prefetch
+        (
+            std::size_t offset,
+            std::size_t num_bytes
+        );
+        // Starts writing the dirty pages of a range to the file asynchronously
+        // and releases them from the mapping, e.g. the last slab of a sweep
+        // param offset first byte of the range
+        // param num_bytes size of the range
+        void writeBehind
+        (
+            std::size_t offset,
+            std::size_t num_bytes
+        );
+        // Discards the contents of the whole pages of a range without writing
+        // them, reads of the range return zeros afterwards
+        // param offset first byte of the range
+        // param num_bytes size of the range
+        void discard
+        (
+            std::size_t offset,
+            std::size_t num_bytes
+        );
+        // Get the mapped memory
+        // return pointer to the first byte of the file
+        void* data()
+        {
+            return data_;
+        };
+        // Get the size of the file
+        // return size of the file in bytes
+        std::size_t size() const
+        {
+            return num_bytes_;
+        };
+    private:
+        // Rounds a range outwards to whole pages and clips it to the file
+        // param offset first byte of the range, rounded down
+        // param num_bytes size of the range, rounded up
+        // return false if the range is empty
+        bool alignRange
+        (
+            std::size_t &offset,
+            std::size_t &num_bytes
+        ) const;
+        // File descriptor of the scratch file
+        int fd_;
+        // Mapped memory, nullptr for an empty file
+        void *data_;
+        // Size of the file
+        std::size_t num_bytes_;
+};
+
+#endif // MAPPEDFILE_HPP_INCLUDED
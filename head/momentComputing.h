@@ -98,7 +98,7 @@ bool checkSteadyState
 )
 {
     const auto nn = u_prev.size();
-    const auto ii = u_prev.at(0).size();
+    const auto ii = u_prev.width();
     std::vector<U> diff_sum(ii, 0);
     std::vector<U> sum(ii, 0);
     std::vector<U> error(ii, 0);
@@ -131,7 +131,7 @@ double checkError
 )
 {
     const auto nn = u_prev.size();
-    const auto ii = u_prev.at(0).size();
+    const auto ii = u_prev.width();
     std::vector<double> diff_sum(ii, 0.0);
     std::vector<double> sum(ii, 0.0);
     std::vector<double> error(ii, 0.0);
@@ -0,0 +1,151 @@
+#ifndef NODEORDERING_HPP_INCLUDED
+#define NODEORDERING_HPP_INCLUDED
+
+#include <iostream>
+#include <vector>
+
+class nodeOrdering
+{
+    public:
+        // Storage orders of the nodes
+        enum e_orderings
+        {
+            ROW_MAJOR,
+            MORTON,
+            HILBERT
+        };
+        // Nodes of a tile, stored contiguously and row-wise
+        struct tile
+        {
+            // Index of the first node, the lower left node
+            std::size_t first;
+            // Coordinates of the lower left node
+            std::size_t x;
+            std::size_t y;
+            // Number of grid along x and y coordinate
+            std::size_t width;
+            std::size_t height;
+        };
+        // Constructor: Creates the row-major order n = y * nx + x
+        // param nx number of grid along x coordinate
+        // param ny number of grid along y coordinate
+        nodeOrdering
+        (
+            std::size_t nx,
+            std::size_t ny
+        );
+        // Constructor: Creates a tiled order. The lattice is cut into square tiles
+        // whose nodes are stored contiguously and row-wise, the tiles follow a
+        // Morton or Hilbert curve so that neighbouring nodes share cache lines and
+        // pages. Tiles on the right and top edges may be smaller. Throws exception
+        // if the tile size is not a power of two
+        // param nx number of grid along x coordinate
+        // param ny number of grid along y coordinate
+        // param ordering storage order of the tiles
+        // param tile_size number of grid along each side of a tile
+        nodeOrdering
+        (
+            std::size_t nx,
+            std::size_t ny,
+            e_orderings ordering,
+            std::size_t tile_size
+        );
+        // Destructor
+        ~nodeOrdering() = default;
+        // Get the storage order
+        // return storage order of the nodes
+        e_orderings getOrdering() const;
+        // Get the number of grid along each side of a full tile
+        // return tile size, 0 for the row-major order
+        std::size_t getTileSize() const;
+        // Get the tiles in storage order, so that sweeping them visits the nodes
+        // in index order
+        // return tiles of the lattice, empty for the row-major order
+        const std::vector<tile>& getTiles() const;
+        // Checks for the row-major order, which allows index arithmetic such as
+        // n + nx for the node above
+        // return true if the nodes are stored row-wise
+        bool isRowMajor() const
+        {
+            return ordering_ == ROW_MAJOR;
+        }
+        // Get the index of a node in the lattice arrays
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // return index of the node
+        std::size_t getIndex
+        (
+            std::size_t x,
+            std::size_t y
+        ) const
+        {
+            if (ordering_ == ROW_MAJOR) return y * nx_ + x;
+            const auto tile_x = x >> tile_shift_;
+            return tile_offset_[(y >> tile_shift_) * num_tiles_x_ + tile_x] +
+                   (y & tile_mask_) * tile_width_[tile_x] + (x & tile_mask_);
+        }
+        // Get the x-coordinate of a node
+        // param n index of the node
+        // return x-coordinate of the node
+        std::size_t getX
+        (
+            std::size_t n
+        ) const
+        {
+            return ordering_ == ROW_MAJOR ? n % nx_ : node_x_[n];
+        }
+        // Get the y-coordinate of a node
+        // param n index of the node
+        // return y-coordinate of the node
+        std::size_t getY
+        (
+            std::size_t n
+        ) const
+        {
+            return ordering_ == ROW_MAJOR ? n / nx_ : node_y_[n];
+        }
+    private:
+        // Position of a tile on the Morton curve, interleaves the bits of the tile
+        // coordinates
+        // param tile_x x-coordinate of the tile
+        // param tile_y y-coordinate of the tile
+        static std::size_t getMortonKey
+        (
+            std::size_t tile_x,
+            std::size_t tile_y
+        );
+        // Position of a tile on the Hilbert curve according to "Hilbert curve"
+        // Wikipedia, xy2d
+        // param side number of tiles along each side of the curve, power of two
+        // param tile_x x-coordinate of the tile
+        // param tile_y y-coordinate of the tile
+        static std::size_t getHilbertKey
+        (
+            std::size_t side,
+            std::size_t tile_x,
+            std::size_t tile_y
+        );
+        // Number of grid along x coordinate
+        std::size_t nx_;
+        // Number of grid along y coordinate
+        std::size_t ny_;
+        // Storage order of the nodes
+        e_orderings ordering_;
+        // log2 of the tile size
+        std::size_t tile_shift_;
+        // Tile size - 1, masks the coordinates inside a tile
+        std::size_t tile_mask_;
+        // Number of tiles along x coordinate
+        std::size_t num_tiles_x_;
+        // Index of the first node of each tile, tiles stored row-wise
+        std::vector<std::size_t> tile_offset_;
+        // Number of grid along x coordinate of the tiles in each tile column
+        std::vector<std::size_t> tile_width_;
+        // Tiles in storage order
+        std::vector<tile> tiles_;
+        // Coordinates of each node for the tiled orders
+        std::vector<unsigned> node_x_;
+        std::vector<unsigned> node_y_;
+};
+
+#endif // NODEORDERING_HPP_INCLUDED
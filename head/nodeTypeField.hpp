@@ -0,0 +1,291 @@
+#ifndef NODETYPEFIELD_HPP_INCLUDED
+#define NODETYPEFIELD_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeModel.hxx"
+
+class nodeTypeField
+{
+    public:
+        // Boundary types, one byte per node
+        enum e_types : unsigned char
+        {
+            FLUID,
+            BOUNCEBACK,
+            HALFWAY,
+            VELOCITY,
+            PRESSURE,
+            PERIODIC
+        };
+        // Constructor: Creates a field which marks every node of the lattice as fluid.
+        // Boundary nodes are registered with a type and their parameters are kept
+        // in small tables, streamD2Q9 then applies them inside its sweeps
+        // param lb reference to LatticeModel
+        // param cb CollisionModel to skip full-way bounceback nodes and to provide
+        //       the density next to velocity corners
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field which provides the velocity for normal flow
+        nodeTypeField
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Destructor
+        ~nodeTypeField() = default;
+        // Marks every node as fluid again and empties the parameter tables without
+        // reallocating the field, e.g. to set up another case on the same lattice.
+        // Full-way bounceback nodes are included in the collision again by
+        // resetting the collision model
+        void clear();
+        // Adds a full-way bounceback node, the node is excluded from collision
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addBounceback
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Adds a half-way bounceback node on the edge of the lattice, distribution
+        // functions which would stream in from outside are reflected
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addHalfwayBounceback
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Adds a Zou/He velocity node on the edge or corner of the lattice
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // param u_x x-component of the velocity
+        // param u_y y-component of the velocity
+        // param is_normal_flow takes the velocity of the neighbouring fluid node
+        //       instead of (u_x, u_y) on edges
+        void addVelocity
+        (
+            std::size_t x,
+            std::size_t y,
+            double u_x,
+            double u_y,
+            bool is_normal_flow
+        );
+        // Adds a Zou/He pressure node on the edge of the lattice, the tangential
+        // velocity is zero. Throws exception for corner nodes
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // param rho density of the node
+        void addPressure
+        (
+            std::size_t x,
+            std::size_t y,
+            double rho
+        );
+        // Adds a periodic node on the edge of the lattice, distribution functions
+        // which would stream in from outside come from the opposite edge
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addPeriodic
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Returns the type of a node
+        // param n index of the node in the lattice
+        e_types getType
+        (
+            std::size_t n
+        ) const
+        {
+            return static_cast<e_types>(type_[n]);
+        }
+        // Copies the prestream distribution functions of the lattice edges, which
+        // are needed by half-way bounceback and periodic nodes during streaming
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void saveEdges
+        (
+            const latticeArray<double> &df
+        );
+        // Copies the prestream distribution functions of the lattice edges in the
+        // rows first_row <= y < last_row, ranges of rows may be saved concurrently
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        void saveEdges
+        (
+            const latticeArray<double> &df,
+            std::size_t first_row,
+            std::size_t last_row
+        );
+        // Sets a distribution function of an edge node whose source lies outside
+        // of the lattice, nodes without such a rule are left unchanged
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param n index of the node in the lattice
+        // param i direction of the distribution function
+        void pullOffLattice
+        (
+            latticeArray<double> &df,
+            std::size_t n,
+            std::size_t i
+        );
+        // Applies the boundary rule of a node once its distribution functions have
+        // been streamed. The switch dispatches to the inlined rule of each type
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param n index of the node in the lattice
+        void updateNode
+        (
+            latticeArray<double> &df,
+            std::size_t n
+        );
+    private:
+        // Boundary rule of a single type
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param n index of the node in the lattice
+        template <e_types type>
+        void applyRule
+        (
+            latticeArray<double> &df,
+            std::size_t n
+        );
+        // Sets the type of a node and the index of its parameters
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        // param type boundary type
+        // param param index in the parameter table of the type
+        void setType
+        (
+            std::size_t x,
+            std::size_t y,
+            e_types type,
+            unsigned param
+        );
+        // Returns the side of an edge node: 0 right, 1 top, 2 left, 3 bottom
+        // param n index of the node in the lattice
+        int getSide
+        (
+            std::size_t n
+        ) const;
+        // Index of an edge node in the prestream copy of the edges
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        std::size_t getEdgeIndex
+        (
+            std::size_t x,
+            std::size_t y
+        ) const;
+        // Sum of the distribution functions with known values at an edge node,
+        // rho * (1 -+ u_n / c) with u_n the velocity normal to the edge
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param n index of the node in the lattice
+        // param side side of the edge node
+        double getKnownSum
+        (
+            const latticeArray<double> &df,
+            std::size_t n,
+            int side
+        ) const;
+        // Sets the unknown distribution functions of an edge node according to
+        // "On pressure and velocity boundary conditions for the lattice Boltzmann
+        // BGK model" Zou1997
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param n index of the node in the lattice
+        // param side side of the edge node
+        // param j_x x-component of the momentum rho * u
+        // param j_y y-component of the momentum rho * u
+        void setEdgeUnknowns
+        (
+            latticeArray<double> &df,
+            std::size_t n,
+            int side,
+            double j_x,
+            double j_y
+        );
+        // Reference to LatticeModel
+        latticeBase &lb_;
+        // Reference to CollisionModel
+        collisionBase &cb_;
+        // define lattice model
+        latticeModelD2Q9 &D2Q9_;
+        // define fluid field;
+        fluidField &field_;
+        // Type of each node stored row-wise
+        std::vector<unsigned char> type_;
+        // Index of the node in the parameter table of its type
+        std::vector<unsigned> param_;
+        // Velocity table of velocity nodes
+        std::vector<std::vector<double>> velocity_;
+        // Normal flow toggle of the velocity table
+        std::vector<bool> is_normal_flow_;
+        // Density table of pressure nodes
+        std::vector<double> density_;
+        // Opposite direction of each direction
+        std::vector<std::size_t> opposite_;
+        // Prestream distribution functions of the bottom, top, left and right edges
+        latticeArray<double> edges_;
+        // Toggle to copy the edges, only needed by half-way bounceback and periodic
+        // nodes
+        bool is_edges_;
+        // Zou/He coefficients, see ZouHeNode
+        double beta1_;
+        double beta2_;
+        double beta3_;
+};
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::BOUNCEBACK>
+(
+    latticeArray<double> &df,
+    std::size_t n
+);
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::VELOCITY>
+(
+    latticeArray<double> &df,
+    std::size_t n
+);
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::PRESSURE>
+(
+    latticeArray<double> &df,
+    std::size_t n
+);
+
+inline void nodeTypeField::updateNode
+(
+    latticeArray<double> &df,
+    std::size_t n
+)
+{
+    switch (type_[n])
+    {
+        case BOUNCEBACK:
+        {
+            applyRule<BOUNCEBACK>(df, n);
+            break;
+        }
+        case VELOCITY:
+        {
+            applyRule<VELOCITY>(df, n);
+            break;
+        }
+        case PRESSURE:
+        {
+            applyRule<PRESSURE>(df, n);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+#endif // NODETYPEFIELD_HPP_INCLUDED
@@ -0,0 +1,155 @@
+#ifndef OUTFLOWNODE_HPP_INCLUDED
+#define OUTFLOWNODE_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "boundaryNode.hxx"
+
+class outflowNode: public boundaryNode
+{
+    public:
+        // Non-reflecting outflow conditions
+        enum e_outflows
+        {
+            CONVECTIVE,
+            CHARACTERISTIC
+        };
+        // Constructor: Creates outflow boundary nodes which let vortices and
+        // pressure waves leave the lattice, so that the domain can end shortly
+        // behind the region of interest. The nodes are updated after streaming
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param cb collision model which contains information on lattice density
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field which contains the velocity of the last step
+        // param outflow outflow condition of the nodes
+        outflowNode
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field,
+            e_outflows outflow
+        );
+        // Destructor
+        ~outflowNode() = default;
+        // Adds an outflow node on an edge of the lattice. Throws exception for
+        // corner nodes, which belong to the adjacent walls, and for lattices with
+        // less than three nodes normal to the edge
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addNode
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Sets the convection velocity U of the CONVECTIVE condition. Without
+        // it U is the mean outward velocity of the nodes next to the outflow
+        // nodes. Throws exception if u_convective is negative
+        // param u_convective velocity normal to the edge
+        void setConvectiveVelocity
+        (
+            double u_convective
+        );
+        // Sets the far field. The incoming wave of the CHARACTERISTIC condition
+        // relaxes the density towards rho with K = sigma * (1 - Ma^2) * cs / length,
+        // the CONVECTIVE condition relaxes it with sigma * cs / length. sigma 0
+        // gives a perfectly non-reflecting boundary whose mean density drifts.
+        // Default rho 1, sigma 0.25 and the longer side of the lattice
+        // param rho far-field density
+        // param sigma relaxation coefficient of the incoming wave
+        // param length characteristic length of the domain
+        void setFarField
+        (
+            double rho,
+            double sigma,
+            double length
+        );
+        // Updates the distribution functions of the outflow nodes
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param is_modify_stream boolean toggle for half-way bounceback nodes to
+        //       perform functions during stream, set to FALSE for outflow nodes
+        void updateNode
+        (
+            latticeArray<double> &df,
+            bool is_modify_stream
+        );
+        // Get the rows of the boundary nodes and of the two neighbours along the
+        // normal of their edge which the nodes read
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        void getRows
+        (
+            std::size_t &first_row,
+            std::size_t &last_row
+        ) const;
+        // Boundary nodes stored in a 1D vector, index_i is the side of the node:
+        // 0 right, 1 top, 2 left, 3 bottom
+        std::vector<latticeNode> nodes;
+    private:
+        // Sets the distribution functions which stream in from outside according
+        // to the convective condition f_i(x, t + 1) = (f_i(x, t) + U / c *
+        // f_i(x - n, t + 1)) / (1 + U / c) of "Evaluation of outflow boundary
+        // conditions for two-phase lattice Boltzmann equation" Lou2013, the first
+        // step extrapolates with zero gradient. The density of the nodes is then
+        // relaxed towards the far field
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void updateConvective
+        (
+            latticeArray<double> &df
+        );
+        // Advances density and velocity of the nodes with the locally
+        // one-dimensional inviscid characteristic equations of "Boundary
+        // conditions for direct simulations of compressible viscous flows"
+        // Poinsot1992 as in "Multiple-relaxation-time lattice Boltzmann model for
+        // computing flows with characteristic boundary conditions" Izquierdo2008.
+        // Outgoing waves use one-sided second-order differences, the incoming
+        // wave is relaxed towards the far field. The distribution functions
+        // are then set by the non-equilibrium extrapolation of "Non-equilibrium
+        // extrapolation method for velocity and pressure boundary conditions in
+        // the lattice Boltzmann method" Guo2002
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void updateCharacteristic
+        (
+            latticeArray<double> &df
+        );
+        // Equilibrium distribution function of a direction
+        // param i direction
+        // param rho density
+        // param u_x x-component of the velocity
+        // param u_y y-component of the velocity
+        // return equilibrium distribution function
+        double getEquilibrium
+        (
+            std::size_t i,
+            double rho,
+            double u_x,
+            double u_y
+        ) const;
+        // Collision model which contains information on lattice density
+        collisionBase &cb_;
+        // define lattice model
+        latticeModelD2Q9 &D2Q9_;
+        // define fluid field;
+        fluidField &field_;
+        // Outflow condition of the nodes
+        e_outflows outflow_;
+        // Convection velocity
+        double u_convective_;
+        // Boolean toggle to indicate if the convection velocity is set, otherwise
+        // the mean outward velocity is used
+        bool is_convective_set_;
+        // Far-field density, relaxation coefficient and length of the
+        // characteristic condition
+        double rho_far_;
+        double sigma_;
+        double length_;
+};
+
+#endif // OUTFLOWNODE_HPP_INCLUDED
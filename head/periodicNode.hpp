@@ -0,0 +1,76 @@
+#ifndef PERIODICNODE_HPP_INCLUDED
+#define PERIODICNODE_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "boundaryNode.hxx"
+#include "nodeTypeField.hpp"
+
+class periodicNode: public boundaryNode
+{
+    public:
+        // Constructor: Creates periodic boundary nodes on the edges of the
+        // lattice. The distribution functions which would stream in from outside
+        // of the lattice are taken from the prestream distribution functions of
+        // the periodic node on the opposite edge
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param D2Q9 lattice model D2Q9
+        periodicNode
+        (
+            latticeBase &lb,
+            latticeModelD2Q9 &D2Q9
+        );
+        // Destructor
+        ~periodicNode() = default;
+        // Adds a periodic node. Throws exception for nodes which are not on the
+        // edge of the lattice
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addNode
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Registers the nodes in a node type field as periodic nodes, so that the
+        // streaming sweep applies them. The object must then not be added to
+        // LatticeBoltzmann as well
+        // param types node type field of the streaming model
+        void registerNodes
+        (
+            nodeTypeField &types
+        );
+        // Copies the prestream distribution functions of the nodes before
+        // streaming, afterwards sets the distribution functions whose source lies
+        // outside of the lattice to those of the wrapped source. Sources which are
+        // not periodic nodes leave the distribution function unchanged
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param is_modify_stream TRUE after streaming, FALSE before
+        void updateNode
+        (
+            latticeArray<double> &df,
+            bool is_modify_stream
+        );
+    private:
+        // Finds the source node of every distribution function of the nodes
+        // which streams in from outside of the lattice
+        void buildLinks();
+        // Periodic nodes, df_node holds the prestream distribution functions
+        std::vector<latticeNode> nodes;
+        // Node, direction and source node of each link across the lattice edge,
+        // indexed into nodes
+        std::vector<std::size_t> link_node_;
+        std::vector<std::size_t> link_direction_;
+        std::vector<std::size_t> link_source_;
+        // Boolean toggle to indicate if the links are up to date with the nodes
+        bool is_links_built_;
+        // define lattice model
+        latticeModelD2Q9 &D2Q9_;
+};
+
+#endif // PERIODICNODE_HPP_INCLUDED
@@ -0,0 +1,43 @@
+#ifndef PRECONDITIONING_HPP_INCLUDED
+#define PRECONDITIONING_HPP_INCLUDED
+
+#include <vector>
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+
+// Preconditioned equilibrium of "Preconditioned lattice-Boltzmann method for
+// steady flows" Guo2004, shared by collisionD2Q9_BGK_PRE and
+// collisionD2Q9_MRT_PRE
+
+// Checks the preconditioning parameter. Throws exception if gamma is not in
+// (0, 1]
+// param gamma preconditioning parameter
+// return gamma
+double checkPreconditioning
+(
+    double gamma
+);
+
+// Calculates the preconditioned equilibrium distribution function, the
+// quadratic velocity terms are divided by gamma
+// param lb lattice model which contains information on the number of rows,
+//       columns, dimensions, discrete directions and lattice velocity
+// param D2Q9 lattice model D2Q9
+// param field fluid field holding the velocity of each node
+// param rho density of each node
+// param gamma preconditioning parameter
+// param eqdf equilibrium distribution functions of each node
+void computePreconditionedfEq
+(
+    const latticeBase &lb,
+    const latticeModelD2Q9 &D2Q9,
+    const fluidField &field,
+    const std::vector<double> &rho,
+    double gamma,
+    latticeArray<double> &eqdf
+);
+
+#endif // PRECONDITIONING_HPP_INCLUDED
@@ -4,7 +4,11 @@
 #include <string>
 #include <vector>
 
+#include "latticeArray.hxx"
+
 #include "latticeBase.hpp"
+#include "lossyCodec.hpp"
+#include "flowStatistics.hpp"
 
 class result
 {
@@ -20,6 +24,16 @@ class result
             fluidField &field
 
         );
+        // Constructor: Creates results class which writes to the given folder
+        // instead of vtk_fluid, e.g. one folder per case of a run queue
+        // param lm reference to LatticeModel
+        // param folder output folder, created and cleaned like vtk_fluid
+        result
+        (
+            latticeBase &lb,
+            fluidField &field,
+            const std::string &folder
+        );
         result(const result&) = default;
         result& operator= (const result&) = default;
         // Destructor
@@ -37,11 +51,132 @@ class result
         (
             int time
         );
+        // Writes the flow statistics sampled up to a particular time point to a
+        // .vtk file: mean pressure and velocity, pressure variance and the
+        // Reynolds stresses
+        // param time time point
+        // param statistics flow statistics of the lattice
+        void writeStatisticsVTK
+        (
+            int time,
+            const flowStatistics &statistics
+        );
+        // Writes pressure and velocity at a particular time point to a .lbmz file
+        // compressed by an error-bounded lossy codec, one field component at a
+        // time. convertToVTK() turns the file into the .vtk file of
+        // writeResultVTK()
+        // param time time point
+        // param codec codec and error bound of the fields
+        // return sizes and largest error of the file
+        lossyCodec::statistics writeResultCompressed
+        (
+            int time,
+            const lossyCodec &codec
+        );
+        // Writes pressure, velocity and the distribution functions at a
+        // particular time point to a compressed .lbmz file, e.g. as a checkpoint
+        // which readResultCompressed() restores
+        // param time time point
+        // param codec codec and error bound of the fields
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // return sizes and largest error of the file
+        lossyCodec::statistics writeResultCompressed
+        (
+            int time,
+            const lossyCodec &codec,
+            const latticeArray<double> &df
+        );
+        // Restores pressure, velocity and the distribution functions from a .lbmz
+        // file written with distribution functions. Throws exception if the file
+        // cannot be read or does not match the lattice
+        // param file_name name of the .lbmz file
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // return time point of the file
+        int readResultCompressed
+        (
+            const std::string &file_name,
+            latticeArray<double> &df
+        );
+        // Writes the pressure and velocity of a .lbmz file to a .vtk file of the
+        // same name. Throws exception if the file cannot be read
+        // param file_name name of the .lbmz file
+        // return name of the .vtk file
+        static std::string convertToVTK
+        (
+            const std::string &file_name
+        );
     private:
+        // Fields of a .lbmz file, each component stored row-wise
+        struct compressedFields
+        {
+            std::size_t nx;
+            std::size_t ny;
+            int time;
+            std::vector<std::string> names;
+            std::vector<std::vector<std::vector<double>>> components;
+        };
+        // Writes the header of a .vtk file and the given fields
+        // param file_name name of the .vtk file
+        // param nx number of columns
+        // param ny number of rows
+        // param p relative pressure stored row-wise
+        // param u_x x-component of the velocity stored row-wise
+        // param u_y y-component of the velocity stored row-wise
+        static void writeVTK
+        (
+            const std::string &file_name,
+            std::size_t nx,
+            std::size_t ny,
+            const std::vector<double> &p,
+            const std::vector<double> &u_x,
+            const std::vector<double> &u_y
+        );
+        // Reads all fields of a .lbmz file. Throws exception if the header holds
+        // a lattice size, a number of fields or components or a name length which
+        // the rest of the file cannot hold
+        // param file_name name of the .lbmz file
+        // return fields of the file
+        static compressedFields readCompressed
+        (
+            const std::string &file_name
+        );
+        // Copies a component of a field to a row-wise vector
+        // param values field values with width values per node
+        // param width number of values per node
+        // param d component
+        // return component stored row-wise
+        std::vector<double> getComponent
+        (
+            const double *values,
+            std::size_t width,
+            std::size_t d
+        ) const;
+        // Copies a quantity of the flow statistics to a row-wise vector
+        // param statistics flow statistics of the lattice
+        // param quantity quantity of the nodes
+        // return quantity stored row-wise
+        std::vector<double> getStatistic
+        (
+            const flowStatistics &statistics,
+            flowStatistics::e_quantities quantity
+        ) const;
+        // Writes a compressed .lbmz file
+        // param time time point
+        // param codec codec and error bound of the fields
+        // param df lattice distribution functions, nullptr to leave them out
+        // return sizes and largest error of the file
+        lossyCodec::statistics writeCompressed
+        (
+            int time,
+            const lossyCodec &codec,
+            const latticeArray<double> *df
+        );
         // Reference to LatticeModel
         latticeBase &lb_;
         // define fluid field;
         fluidField &field_;
+        // Output folder of the .vtk and .lbmz files
+        std::string folder_;
 };
 
 #endif // RESULT_HPP_INCLUDED
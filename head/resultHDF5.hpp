@@ -0,0 +1,107 @@
+#ifndef RESULTHDF5_HPP_INCLUDED
+#define RESULTHDF5_HPP_INCLUDED
+
+#ifdef USE_HDF5
+
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeBase.hpp"
+
+class resultHDF5
+{
+    public:
+        // Fields which are written by writeResult()
+        enum e_fields
+        {
+            PRESSURE,
+            VELOCITY,
+            DISTRIBUTION
+        };
+        // Constructor: Creates one HDF5 file per run which stores every output time
+        // point as a group of chunked, deflate-compressed datasets, together with
+        // an XDMF index for ParaView. Throws exception if the file cannot be created
+        // param lb reference to LatticeModel
+        // param field fluid field which contains pressure and velocity
+        // param file_name name of the HDF5 file, the XDMF index gets the extension .xmf
+        // param chunk_size edge length of the square chunks in number of nodes
+        // param compression_level deflate level from 0 (off) to 9 for all fields
+        resultHDF5
+        (
+            latticeBase &lb,
+            fluidField &field,
+            const std::string &file_name,
+            std::size_t chunk_size,
+            int compression_level
+        );
+        resultHDF5(const resultHDF5&) = delete;
+        resultHDF5& operator= (const resultHDF5&) = delete;
+        // Destructor: closes the HDF5 file
+        ~resultHDF5();
+        // Sets the deflate level of a single field
+        // param field one of PRESSURE, VELOCITY and DISTRIBUTION
+        // param compression_level deflate level from 0 (off) to 9
+        void setCompression
+        (
+            e_fields field,
+            int compression_level
+        );
+        // Writes pressure and velocity at a particular time point and updates the
+        // XDMF index
+        // param time time point
+        void writeResult
+        (
+            int time
+        );
+        // Writes pressure, velocity and the distribution functions at a particular
+        // time point and updates the XDMF index
+        // param time time point
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void writeResult
+        (
+            int time,
+            const latticeArray<double> &df
+        );
+    private:
+        // Writes a (ny, nx, width) field as a chunked dataset. Chunks are shuffled
+        // and compressed in parallel and then written directly, so the
+        // serial HDF5 library only copies the compressed bytes
+        // param group HDF5 group of the time point
+        // param name dataset name
+        // param data field values stored row-wise
+        // param width number of values at each node
+        // param compression_level deflate level from 0 (off) to 9
+        void writeDataset
+        (
+            hid_t group,
+            const std::string &name,
+            const double *data,
+            std::size_t width,
+            int compression_level
+        );
+        // Rewrites the XDMF index for all time points written so far
+        void writeXDMF();
+        // Reference to LatticeModel
+        latticeBase &lb_;
+        // define fluid field;
+        fluidField &field_;
+        // Name of the HDF5 file
+        std::string file_name_;
+        // Handle of the HDF5 file
+        hid_t file_;
+        // Edge length of the square chunks in number of nodes
+        std::size_t chunk_size_;
+        // Deflate level of pressure, velocity and distribution functions
+        std::vector<int> compression_;
+        // Written time points and whether they contain distribution functions
+        std::vector<std::pair<int, bool>> times_;
+};
+
+#endif // USE_HDF5
+
+#endif // RESULTHDF5_HPP_INCLUDED
@@ -0,0 +1,303 @@
+#ifndef RUNDRIVER_HPP_INCLUDED
+#define RUNDRIVER_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+
+#include "latticeBase.hpp"
+#include "latticeD2Q9.hpp"
+#include "nodeTypeField.hpp"
+#include "outflowNode.hpp"
+#include "streamD2Q9.hpp"
+#include "latticeBoltzmann.hpp"
+#include "autotuner.hpp"
+#include "loadBalancer.hpp"
+#include "lossyCodec.hpp"
+#include "tracerParticles.hpp"
+
+class runDriver
+{
+    public:
+        // Edges of the lattice
+        enum e_edges
+        {
+            RIGHT,
+            TOP,
+            LEFT,
+            BOTTOM
+        };
+        // Boundaries which can be set on an edge
+        enum e_edge_boundaries
+        {
+            WALL,
+            VELOCITY,
+            PRESSURE,
+            PERIODIC,
+            CONVECTIVE,
+            CHARACTERISTIC
+        };
+        // Boundary of one lattice edge
+        struct edgeBoundary
+        {
+            e_edge_boundaries type;
+            // Velocity of a VELOCITY edge
+            double u_x;
+            double u_y;
+            // Density of a PRESSURE edge, far-field density of a CHARACTERISTIC
+            // edge
+            double rho;
+        };
+        // Parameters of a single case
+        struct scenario
+        {
+            // Name of the case, also the name of its output folder
+            std::string name;
+            // Number of nodes along x and y
+            std::size_t nx;
+            std::size_t ny;
+            // Collision model: BGK, MRT, RBGK, CM, BGK_LES, MRT_LES, BGK_PRE or MRT_PRE
+            std::string collision;
+            // Kinematic viscosity and initial density
+            double viscosity;
+            double density;
+            // Smagorinsky constant of the LES collision models
+            double smagorinsky_constant;
+            // Preconditioning parameter of the preconditioned collision models
+            double gamma;
+            // Initial velocity
+            std::vector<double> u0;
+            // Boundary of each edge, indexed by e_edges
+            std::vector<edgeBoundary> edges;
+            // Maximum number of steps
+            std::size_t max_steps;
+            // Steady state tolerance of checkSteadyState, 0 runs max_steps
+            double tolerance;
+            // Number of steps between two steady state checks
+            std::size_t check_interval;
+            // Number of steps between two .vtk outputs, 0 for none
+            std::size_t output_interval;
+            // Number of steps between two diagnostics evaluations, 0 for none
+            std::size_t diagnostics_interval;
+            // Number of steps between two telemetry records of MLUPS, residual
+            // and mass drift, 0 for none
+            std::size_t telemetry_interval;
+            // Directory of the scratch files of out-of-core distribution
+            // functions, empty to keep them in memory
+            std::string scratch_directory;
+            // Tuning cache of the autotuner which selects the node ordering,
+            // empty to run row-major lattices
+            std::string tuning_cache;
+            // Runs the collision sweeps on the threads of a load balancer
+            bool is_load_balanced;
+            // Number of sweeps between two rebalances of the load balancer, 0
+            // keeps the partition of the estimated costs
+            std::size_t rebalance_interval;
+            // Runs the time steps as task graphs on bands of rows
+            bool is_task_scheduled;
+            // Number of rows of a band of the task graph, 0 for about four bands
+            // per thread
+            std::size_t band_rows;
+            // Writes the outputs as .lbmz files compressed within an error bound
+            // instead of .vtk files
+            bool is_compressed;
+            // Kind of the error bound and absolute error bound or fraction of the
+            // value range of a field
+            lossyCodec::e_bounds bound;
+            double error_bound;
+            // Accumulates time-averaged and fluctuating fields, written with the
+            // outputs and at the end of the case
+            bool is_averaged;
+            // First sampled step and number of steps between two samples
+            std::size_t statistics_start;
+            std::size_t statistics_stride;
+            // Advects tracer particles seeded on a uniform grid over the lattice
+            bool is_traced;
+            // Number of tracers along x and y, their integrator and number of
+            // steps between two trajectory records
+            std::size_t tracers_x;
+            std::size_t tracers_y;
+            tracerParticles::e_integrators integrator;
+            std::size_t trajectory_interval;
+        };
+        // Constructor: Creates a driver which runs cases described by scenario
+        // files one after another in the same process. The lattice, fluid field,
+        // collision model, node types and distribution functions of the last case
+        // are kept and reset for the next case of the same size, OpenMP keeps its
+        // threads between cases
+        runDriver();
+        runDriver(const runDriver&) = delete;
+        runDriver& operator= (const runDriver&) = delete;
+        // Destructor
+        ~runDriver() = default;
+        // Reads a scenario file. Each line holds a key followed by its values,
+        // # starts a comment, e.g.
+        //     name cavity_re100
+        //     size 128 128
+        //     collision MRT
+        //     viscosity 0.0384
+        //     boundary top velocity 0.03 0
+        //     boundary left wall
+        // Keys: name, size, collision, viscosity, density, smagorinsky, gamma,
+        // velocity, boundary <right|top|left|bottom> <wall|velocity u_x u_y|
+        // pressure rho|periodic|convective|characteristic rho>, steps, tolerance, check_interval,
+        // output_interval, diagnostics_interval, telemetry_interval,
+        // out_of_core <scratch directory>, autotune <tuning cache>,
+        // load_balance <rebalance interval>, task_scheduling <band rows>,
+        // compression <absolute|relative> <error bound>,
+        // statistics <first step> <stride> and
+        // tracers <number along x> <number along y> <rk2|rk4> <trajectory interval>. Edges
+        // without a boundary are walls. Throws exception on unknown keys and
+        // invalid values and for task scheduling with autotune or out_of_core
+        // param file_name name of the scenario file
+        // return scenario of the file
+        scenario readScenario
+        (
+            const std::string &file_name
+        );
+        // Runs a case until it is steady or max_steps is reached. Telemetry,
+        // diagnostics, flow statistics, tracer trajectories and .vtk or .lbmz
+        // files are written to the folder named after
+        // the case. With a tuning cache the lattice is stored in the node ordering which the
+        // autotuner selects for the case on this host
+        // param sc scenario of the case
+        // return number of steps taken
+        std::size_t runScenario
+        (
+            const scenario &sc
+        );
+        // Runs the scenario files (*.scn) of a directory in name order. Each file
+        // is renamed to *.scn.done or *.scn.failed after its case, the directory
+        // is scanned again until no scenario file is left, so files can be added
+        // while the queue is running
+        // param directory queue directory
+        // return number of cases run successfully
+        std::size_t runDirectory
+        (
+            const std::string &directory
+        );
+        // Listens on a Unix stream socket for scenario files. Each line received
+        // is the path of a scenario file which is run before the next line is
+        // read, the reply is "done <name> <steps>" or "error <message>". Clients
+        // are served one after another, a line "quit" stops the driver
+        // param socket_path path of the socket
+        // return number of cases run successfully
+        std::size_t listen
+        (
+            const std::string &socket_path
+        );
+        // Get the number of scenario files of runDirectory() and listen() whose
+        // case failed
+        // return number of failed cases
+        std::size_t getNumberOfFailedCases() const;
+    private:
+        // Lattice, fluid field, collision model, node types, stream and
+        // distribution functions kept between cases of the same size
+        struct latticeBuffers
+        {
+            latticeBuffers
+            (
+                std::size_t nx,
+                std::size_t ny,
+                nodeOrdering::e_orderings ordering,
+                std::size_t tile_size
+            );
+            // lattice model D2Q9
+            latticeModelD2Q9 D2Q9;
+            // lattice of the case
+            latticeD2Q9 lattice;
+            // fluid field of the case
+            fluidField field;
+            // storage order and tile size of the lattice
+            nodeOrdering::e_orderings ordering;
+            std::size_t tile_size;
+            // collision model of the last case and its parameters which are kept
+            // by collisionBase::reset()
+            std::unique_ptr<collisionBase> collision;
+            std::string collision_name;
+            double smagorinsky_constant;
+            double gamma;
+            // node types, stream and time stepping of the last case, the time
+            // stepping holds the distribution functions
+            std::unique_ptr<nodeTypeField> types;
+            std::unique_ptr<streamD2Q9> stream;
+            std::unique_ptr<latticeBoltzmann> run;
+            // scratch directory of the out-of-core distribution functions, empty
+            // if they are held in memory
+            std::string scratch_directory;
+        };
+        // Creates the collision model of a case
+        // param sc scenario of the case
+        // param lb lattice of the case
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field of the case
+        std::unique_ptr<collisionBase> makeCollision
+        (
+            const scenario &sc,
+            latticeBase &lb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Sets up the collision model, node types, stream and time stepping of a
+        // case in the buffers, the fluid field must hold the initial velocity. If
+        // the last case had the same collision model, Smagorinsky constant,
+        // preconditioning parameter and scratch directory they are reset instead
+        // of being allocated again
+        // param sc scenario of the case
+        // param buffers buffers of the lattice of the case
+        void prepareBuffers
+        (
+            const scenario &sc,
+            latticeBuffers &buffers
+        );
+        // Sets up a case with a candidate configuration of the autotuner and
+        // measures its MLUPS. Releases the buffers of the last case first
+        // param sc scenario of the case
+        // param candidate node ordering and tile size of the lattice
+        // return million lattice updates per second
+        double measureConfiguration
+        (
+            const scenario &sc,
+            const autotuner::configuration &candidate
+        );
+        // Registers the edge boundaries of a case. Periodic edges first, then
+        // walls, pressure edges without their corners and velocity edges, so that
+        // velocity edges own their corners. Convective and characteristic outflow
+        // edges without their corners become outflowNode objects which have to be
+        // added to the LatticeBoltzmann of the case
+        // param sc scenario of the case
+        // param lb lattice of the case
+        // param cb collision model of the case
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field of the case
+        // param types node type field which is applied by the stream of the case
+        // param outflows outflow nodes of the case, one object per edge
+        void addBoundaries
+        (
+            const scenario &sc,
+            latticeBase &lb,
+            collisionBase &cb,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field,
+            nodeTypeField &types,
+            std::vector<std::unique_ptr<outflowNode>> &outflows
+        );
+        // Runs one scenario file and reports the outcome on the console
+        // param file_name name of the scenario file
+        // param reply "done <name> <steps>" or "error <message>"
+        // return true if the case ran successfully
+        bool runFile
+        (
+            const std::string &file_name,
+            std::string &reply
+        );
+        // Lattice and fluid field of the last case
+        std::unique_ptr<latticeBuffers> buffers_;
+        // Number of scenario files whose case failed
+        std::size_t num_failed_;
+};
+
+#endif // RUNDRIVER_HPP_INCLUDED
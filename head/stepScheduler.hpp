@@ -0,0 +1,145 @@
+#ifndef STEPSCHEDULER_HPP_INCLUDED
+#define STEPSCHEDULER_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "latticeArray.hxx"
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "streamBase.hxx"
+#include "boundaryNode.hxx"
+#include "flowStatistics.hpp"
+
+class stepScheduler
+{
+    public:
+        // Constructor: Creates a scheduler which runs a time step as a graph of
+        // OpenMP tasks instead of one sweep after the other. The lattice is cut
+        // into bands of rows; every band collides, streams and computes its
+        // macroscopic properties as soon as the bands next to it and the boundary
+        // conditions on its rows allow, so interior bands keep the threads busy
+        // while the boundary conditions run. The collision model must support
+        // node ranges and the stream model row ranges
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param cb collision model of the lattice
+        // param sb stream model of the lattice
+        // param band_rows number of rows of a band, 0 for about four bands per
+        //       thread
+        stepScheduler
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            streamBase &sb,
+            std::size_t band_rows
+        );
+        stepScheduler(const stepScheduler&) = delete;
+        stepScheduler& operator= (const stepScheduler&) = delete;
+        // Destructor
+        ~stepScheduler() = default;
+        // Performs one time step like latticeBoltzmann::takeStep() without the
+        // diagnostics. The task graph is built again whenever the boundary
+        // conditions or the rows of their nodes change. The macroscopic task of
+        // each band samples the band into the flow statistics
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param bn boundary conditions of the lattice in the order they are applied
+        // param st flow statistics whose sample of this step has been started
+        void takeStep
+        (
+            latticeArray<double> &df,
+            const std::vector<boundaryNode*> &bn,
+            const std::vector<flowStatistics*> &st
+        );
+        // Get the number of tasks of a time step
+        // return number of tasks
+        std::size_t getNumberOfTasks() const;
+        // Get the number of bands of rows
+        // return number of bands
+        std::size_t getNumberOfBands() const;
+    private:
+        // Kinds of tasks of a time step
+        enum e_tasks
+        {
+            COLLIDE,
+            PRESTREAM,
+            SAVE_ROWS,
+            STREAM,
+            POSTSTREAM,
+            MACROSCOPIC
+        };
+        // Task of the graph, index is the band or the boundary condition
+        struct task
+        {
+            e_tasks kind;
+            std::size_t index;
+            std::vector<std::size_t> successors;
+            std::size_t num_predecessors;
+        };
+        // Tasks which last wrote a resource and which read it since
+        struct access
+        {
+            std::size_t writer;
+            std::vector<std::size_t> readers;
+        };
+        // Builds the task graph of a step. Each band has three resources: its
+        // distribution functions, its macroscopic properties and the copies of its
+        // outer rows which the neighbouring bands stream from. Tasks are added in
+        // the order of latticeBoltzmann::takeStep() and wait for the last task
+        // writing a resource they read or write and for the tasks reading a
+        // resource they write
+        // param bn boundary conditions of the lattice
+        void buildGraph
+        (
+            const std::vector<boundaryNode*> &bn
+        );
+        // Adds a task to the graph
+        // param kind kind of the task
+        // param index band or boundary condition
+        // param written resources written by the task
+        // param read resources read by the task
+        // param accesses last accesses of each resource
+        void addTask
+        (
+            e_tasks kind,
+            std::size_t index,
+            const std::vector<std::size_t> &written,
+            const std::vector<std::size_t> &read,
+            std::vector<access> &accesses
+        );
+        // Runs a task and spawns the successors which no longer wait for another
+        // task
+        // param t index of the task
+        void runTask
+        (
+            std::size_t t
+        );
+        // Lattice model to handle number of rows, columns and directions
+        latticeBase &lb_;
+        // Collision model of the lattice
+        collisionBase &cb_;
+        // Stream model of the lattice
+        streamBase &sb_;
+        // Number of rows of a band
+        std::size_t band_rows_;
+        // Number of bands
+        std::size_t num_bands_;
+        // Boundary conditions and the rows of their nodes the graph was built for
+        std::vector<boundaryNode*> bn_;
+        std::vector<std::pair<std::size_t, std::size_t>> bn_rows_;
+        // Task graph of a time step
+        std::vector<task> tasks_;
+        // Number of predecessors each task still waits for in the current step
+        std::unique_ptr<std::atomic<std::size_t>[]> num_waiting_;
+        // Copies of the first and the last row of each band after the prestream
+        // boundary conditions
+        std::vector<latticeArray<double>> first_rows_;
+        std::vector<latticeArray<double>> last_rows_;
+        // Distribution functions and flow statistics of the current step
+        latticeArray<double> *df_;
+        const std::vector<flowStatistics*> *st_;
+};
+
+#endif // STEPSCHEDULER_HPP_INCLUDED
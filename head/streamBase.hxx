@@ -1,8 +1,10 @@
 #ifndef STREAMBASE_HXX_INCLUDED
 #define STREAMBASE_HXX_INCLUDED
 
+#include <stdexcept>
 #include <vector>
 
+#include "latticeArray.hxx"
 #include "latticeBase.hpp"
 
 class streamBase
@@ -19,17 +21,73 @@ class streamBase
         {};
         //Virtual destruction since we are deriving from this class
         virtual ~streamBase() = default;
-        // Pure virtual function for the streaming function
-        // param df lattice distribution function stored row-wise in a 2D vector
+        // Pure virtual function for the streaming function, streams in place so
+        // that the distribution functions keep their memory between time steps
+        // param df lattice distribution function stored row-wise in a latticeArray
         // df[n][i]: n is the index of grid; i is index of lattice velocity at grid
-        virtual std::vector<std::vector<double>> stream
+        virtual void stream
         (
-            const std::vector<std::vector<double>> &df
+            latticeArray<double> &df
         ) = 0;
+        // Checks if the stream model can stream ranges of rows with streamRows()
+        // return TRUE if rows can be streamed separately
+        virtual bool isRowRangeSupported() const
+        {
+            return false;
+        }
+        // Saves what streamRows() needs of the rows first_row <= y < last_row
+        // before any of them is streamed, e.g. the prestream distribution
+        // functions of the edges for boundary rules
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        virtual void saveRows
+        (
+            const latticeArray<double> &,
+            std::size_t,
+            std::size_t
+        )
+        {}
+        // Streams the rows first_row <= y < last_row like stream(). Rows outside
+        // of the range are not read from df but from copies of the row below and
+        // the row above taken before streaming, so that ranges can be streamed
+        // concurrently. The rows of the range and their neighbours must have been
+        // saved with saveRows(). Throws exception if the stream model cannot
+        // stream rows
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        // param row_below distribution functions of row first_row - 1, unused for
+        //       the first row of the lattice
+        // param row_above distribution functions of row last_row, unused for the
+        //       last row of the lattice
+        virtual void streamRows
+        (
+            latticeArray<double> &,
+            std::size_t,
+            std::size_t,
+            const latticeArray<double> &,
+            const latticeArray<double> &
+        )
+        {
+            throw std::runtime_error("Stream model cannot stream ranges of rows");
+        }
+        // Writes the slabs of file-backed distribution functions behind the
+        // sweeps once they are streamed, for lattices which do not fit into memory
+        // param is_write_behind TRUE to write the slabs behind
+        void setWriteBehind
+        (
+            bool is_write_behind
+        )
+        {
+            is_write_behind_ = is_write_behind;
+        }
     protected:
         // Lattice model to handle number of rows, columns, dimensions, directions,
         // velocity/
         latticeBase &lb_;
+        // Boolean toggle to write streamed slabs behind
+        bool is_write_behind_ = false;
 };
 
 #endif // STREAMBASE_HXX_INCLUDED
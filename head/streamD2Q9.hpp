@@ -6,7 +6,9 @@
 #include "latticeModel.hxx"
 
 #include "latticeBase.hpp"
+#include "nodeOrdering.hpp"
 #include "streamBase.hxx"
+#include "nodeTypeField.hpp"
 
 class streamD2Q9: public streamBase
 {
@@ -19,19 +21,97 @@ class streamD2Q9: public streamBase
             latticeBase &lb,
             latticeModelD2Q9 &D2Q9
         );
+        // Constructor: Creates a streaming model for D2Q9 lattice model which applies
+        // the boundary rules of a node type field inside its sweeps
+        // param lm Lattice model which contains information on the number of rows,
+        // columns, dimensions, discrete directions and lattice velocity
+        // param types node type field with the registered boundary nodes
+        streamD2Q9
+        (
+            latticeBase &lb,
+            latticeModelD2Q9 &D2Q9,
+            nodeTypeField &types
+        );
         // Destructor
         ~streamD2Q9() = default;
         // Performs the streaming function based on "Introduction to Lattice Boltzmann
         // Methods". Distribution functions which require off-lattice streaming are
-        // unchanged
-        // param df lattice distribution functions stored row-wise in a 2D vector
-        std::vector<std::vector<double>> stream
+        // unchanged. Streams in place: directions pointing up the node index are
+        // pulled in a descending sweep, the others in an ascending sweep, so every
+        // source is read before it is overwritten
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void stream
+        (
+            latticeArray<double> &df
+        );
+        // Checks if rows can be streamed separately, only for row-major lattices
+        // return TRUE if the nodes are stored row-wise
+        bool isRowRangeSupported() const;
+        // Saves the prestream edges of the node type field in a range of rows
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        void saveRows
         (
-            const std::vector<std::vector<double>> &df
+            const latticeArray<double> &df,
+            std::size_t first_row,
+            std::size_t last_row
+        );
+        // Streams a range of rows like stream(), with the boundaries of the node
+        // type field. The edges of the rows of the range and their neighbours must
+        // have been saved with saveRows(). Throws exception for lattices not
+        // stored row-wise
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        // param first_row first row of the range
+        // param last_row one past the last row of the range
+        // param row_below distribution functions of row first_row - 1
+        // param row_above distribution functions of row last_row
+        void streamRows
+        (
+            latticeArray<double> &df,
+            std::size_t first_row,
+            std::size_t last_row,
+            const latticeArray<double> &row_below,
+            const latticeArray<double> &row_above
         );
     private:
+        // Streams like stream(), distribution functions which require off-lattice
+        // streaming are resolved by the node type field and the boundary rule of
+        // each node is applied in the ascending sweep, as soon as no other node
+        // reads from it any more
+        // param df lattice distribution functions stored row-wise in a latticeArray
+        void streamTyped
+        (
+            latticeArray<double> &df
+        );
+        // Streams like stream() and streamTyped() for lattices stored in tiles.
+        // The edge rows and columns of the tiles are saved first, then every tile
+        // is streamed on its own in storage order, so the sweep runs through the
+        // memory once. Sources inside the tile are found by index arithmetic,
+        // sources in other tiles are read from the saved edges
+        // param df lattice distribution functions stored in a latticeArray
+        void streamTiled
+        (
+            latticeArray<double> &df
+        );
+        // Saves the prestream distribution functions of the bottom and top row and
+        // of the left and right column of every tile
+        // param df lattice distribution functions stored in a latticeArray
+        void saveTileEdges
+        (
+            const latticeArray<double> &df
+        );
         // define lattice model
         latticeModelD2Q9 &D2Q9_;
+        // Node type field, nullptr if the boundaries are applied by boundaryNode
+        // objects only
+        nodeTypeField *types_;
+        // Prestream distribution functions of the bottom and top row of each tile
+        // row, nx nodes per line and line 2 * j + 1 the top row of tile row j
+        latticeArray<double> edge_rows_;
+        // Prestream distribution functions of the left and right column of each
+        // tile column, ny nodes per line
+        latticeArray<double> edge_columns_;
 };
 
 #endif // STREAMD2Q9_HPP_INCLUDED
@@ -0,0 +1,139 @@
+#ifndef TELEMETRY_HPP_INCLUDED
+#define TELEMETRY_HPP_INCLUDED
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+
+class telemetry
+{
+    public:
+        // Per-step metrics which can be registered with addMetric()
+        enum e_metrics
+        {
+            STEP_TIME,
+            MLUPS,
+            RESIDUAL,
+            MASS_DRIFT
+        };
+        // Destinations of the flushed records
+        enum e_sinks
+        {
+            JSON_FILE,
+            UNIX_SOCKET
+        };
+        // Constructor: Creates a telemetry component owned by the driver, which
+        // brackets every step with startStep() and endStep(). Metrics are recorded
+        // into a ring buffer without touching the console and written as one JSON
+        // object per line, e.g. {"step":64,"step_time":0.0021,"mlups":31.2},
+        // every flush_interval steps or when the buffer is full
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param cb collision model which contains information on lattice density
+        // param field fluid field which contains pressure and velocity
+        // param sink JSON_FILE truncates and writes the file address, UNIX_SOCKET
+        //       connects to a listening stream socket at the path address
+        // param address file name or socket path
+        // param capacity number of records held by the ring buffer
+        // param flush_interval number of steps between two flushes
+        telemetry
+        (
+            latticeBase &lb,
+            collisionBase &cb,
+            fluidField &field,
+            e_sinks sink,
+            const std::string &address,
+            std::size_t capacity,
+            std::size_t flush_interval
+        );
+        telemetry(const telemetry&) = delete;
+        telemetry& operator= (const telemetry&) = delete;
+        // Destructor: Flushes the remaining records and closes the sink
+        ~telemetry();
+        // Adds a metric which is recorded every interval steps. STEP_TIME and MLUPS
+        // are averaged over the interval, RESIDUAL is checkError() of the velocity
+        // over the last step and MASS_DRIFT is the relative change of the total
+        // density since construction
+        // param metric one of STEP_TIME, MLUPS, RESIDUAL and MASS_DRIFT
+        // param interval number of steps between two records of the metric
+        void addMetric
+        (
+            e_metrics metric,
+            std::size_t interval
+        );
+        // Starts the timer of the next step, keeps the velocity if the residual is
+        // due after the step
+        void startStep();
+        // Stops the timer and records the metrics which are due
+        void endStep();
+        // Writes the buffered records to the sink. The socket is written without
+        // blocking, records which it does not take at once are dropped and a
+        // partly sent record is finished first at the next flush, so every line
+        // the listener receives is a whole record. Only a record which is cut
+        // off by closing the sink lacks its newline
+        void flush();
+        // Get the number of records dropped by the socket
+        // return number of dropped records
+        std::size_t getNumberOfDroppedRecords() const;
+    private:
+        // Number of metrics
+        static const std::size_t num_metrics_ = 4;
+        // Metrics recorded at a step, bit i of mask is set if metric i is recorded
+        struct record
+        {
+            std::size_t step;
+            unsigned mask;
+            double values[num_metrics_];
+        };
+        // Computes the total density of the lattice
+        // return total density
+        double computeMass() const;
+        // Reference to LatticeModel
+        latticeBase &lb_;
+        // Collision model which contains information on lattice density
+        collisionBase &cb_;
+        // define fluid field;
+        fluidField &field_;
+        // Destination of the records
+        e_sinks sink_;
+        // Output stream of the JSON lines file
+        std::ofstream file_;
+        // File descriptor of the socket, -1 if not connected
+        int socket_;
+        // Ring buffer of records, first_ is the oldest and size_ the number of
+        // unwritten records
+        std::vector<record> buffer_;
+        std::size_t first_;
+        std::size_t size_;
+        // Number of steps between two flushes
+        std::size_t flush_interval_;
+        // Reporting interval of each metric, 0 if not registered
+        std::vector<std::size_t> intervals_;
+        // Number of steps taken
+        std::size_t step_;
+        // Start of the current step
+        std::chrono::steady_clock::time_point start_;
+        // Time accumulated by STEP_TIME and MLUPS since their last record
+        std::vector<double> elapsed_;
+        // Velocity before the current step if the residual is due
+        latticeArray<double> u_prev_;
+        // Total density at construction
+        double initial_mass_;
+        // Buffer of the formatted JSON lines, reused between flushes. Starts with
+        // the unsent rest of a partly sent line of the socket
+        std::string lines_;
+        // Number of bytes at the start of lines_ which belong to a partly sent
+        // line, they are sent before any other record
+        std::size_t pending_bytes_;
+        // Number of records dropped by the socket
+        std::size_t num_dropped_;
+};
+
+#endif // TELEMETRY_HPP_INCLUDED
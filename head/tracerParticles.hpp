@@ -0,0 +1,237 @@
+#ifndef TRACERPARTICLES_HPP_INCLUDED
+#define TRACERPARTICLES_HPP_INCLUDED
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+
+class tracerParticles
+{
+    public:
+        // Time integrators of the particle paths: midpoint rule and classical
+        // Runge-Kutta
+        enum e_integrators
+        {
+            RK2,
+            RK4
+        };
+        // Behaviour of the particles at an edge of the lattice
+        enum e_boundaries
+        {
+            // reflected at the wall half a node beyond the edge nodes
+            WALL,
+            // moved to the opposite edge
+            PERIODIC,
+            // removed from the lattice, e.g. at an outlet
+            OPEN
+        };
+        // Constructor: Creates massless tracer particles which are advected by the
+        // velocity of the fluid field after every time step. The velocity is
+        // interpolated bilinearly between the nodes and linearly between the last
+        // and the current step for the stages of the integrator. Each node is the
+        // centre of a square cell, particles are reflected at the faces of solid
+        // cells. The particles are binned by tiles of the lattice so that the
+        // particles of a tile read the same nodes, and the tiles are advanced in
+        // parallel. Throws exception for lattices with less than two nodes along
+        // a side and for a zero tile size
+        // param lb lattice model which contains information on the number of rows,
+        //       columns, dimensions, discrete directions and lattice velocity
+        // param field fluid field which contains the velocity
+        // param integrator second (RK2) or fourth (RK4) order Runge-Kutta
+        // param tile_size number of nodes along each side of a tile
+        tracerParticles
+        (
+            latticeBase &lb,
+            fluidField &field,
+            e_integrators integrator,
+            std::size_t tile_size
+        );
+        tracerParticles(const tracerParticles&) = delete;
+        tracerParticles& operator= (const tracerParticles&) = delete;
+        // Destructor
+        ~tracerParticles() = default;
+        // Sets the behaviour of the particles at the edges, all edges are walls by
+        // default. Throws exception if only one of two opposite edges is periodic
+        // param right_edge right edge
+        // param top_edge top edge
+        // param left_edge left edge
+        // param bottom_edge bottom edge
+        void setBoundaries
+        (
+            e_boundaries right_edge,
+            e_boundaries top_edge,
+            e_boundaries left_edge,
+            e_boundaries bottom_edge
+        );
+        // Marks the cell of a node as solid, e.g. a full-way bounceback node of an
+        // obstacle. Particles inside the cell are removed
+        // param x x-coordinate of the node
+        // param y y-coordinate of the node
+        void addSolidNode
+        (
+            std::size_t x,
+            std::size_t y
+        );
+        // Adds a particle. Throws exception if the position lies outside of the
+        // lattice or in a solid cell, or if trajectories have been written
+        // param x x-coordinate of the particle in nodes
+        // param y y-coordinate of the particle in nodes
+        // return ID of the particle, the number of particles added before
+        std::size_t addParticle
+        (
+            double x,
+            double y
+        );
+        // Adds particles on a uniform grid over a rectangle, positions in solid
+        // cells are left out. Throws exception if the rectangle does not lie in
+        // the lattice or if trajectories have been written
+        // param x_min left side of the rectangle
+        // param y_min bottom side of the rectangle
+        // param x_max right side of the rectangle
+        // param y_max top side of the rectangle
+        // param num_x number of particles along x
+        // param num_y number of particles along y
+        void addParticles
+        (
+            double x_min,
+            double y_min,
+            double x_max,
+            double y_max,
+            std::size_t num_x,
+            std::size_t num_y
+        );
+        // Writes the positions of all particles every interval time steps to a
+        // binary file: the magic LBMP, format version, number of particles, nx
+        // and ny as 64-bit integers, then per record the time step as 64-bit
+        // integer and x and y of each particle in ID order as 32-bit floats,
+        // NaN for removed particles. Throws exception if the file cannot be
+        // opened or for a zero interval
+        // param file_name name of the trajectory file
+        // param interval number of time steps between two records
+        void enableTrajectories
+        (
+            const std::string &file_name,
+            std::size_t interval
+        );
+        // Advances the particles by one time step with the velocity of the fluid
+        // field, which must hold the velocity after the step
+        // param time time step after which the particles are advanced
+        void advance
+        (
+            std::size_t time
+        );
+        // Get the positions of the particles in ID order, NaN for removed
+        // particles
+        // param x x-coordinates of the particles
+        // param y y-coordinates of the particles
+        void getPositions
+        (
+            std::vector<double> &x,
+            std::vector<double> &y
+        ) const;
+        // Get the number of particles added
+        // return number of particles
+        std::size_t getNumberOfParticles() const;
+        // Get the number of particles which have not been removed
+        // return number of particles in the lattice
+        std::size_t getNumberOfActiveParticles() const;
+    private:
+        // Copies the velocity of the fluid field row-wise, zero in solid cells,
+        // keeps the copy of the last step and averages both for the half step
+        void copyVelocity();
+        // Sorts the particles by tile, removed particles go behind the last tile
+        void sortParticles();
+        // Applies the edges and the solid cells to a particle which moved in a
+        // time step, removed particles become NaN
+        // param x_last x-coordinate before the step
+        // param y_last y-coordinate before the step
+        // param x x-coordinate after the step
+        // param y y-coordinate after the step
+        void applyBoundaries
+        (
+            double x_last,
+            double y_last,
+            double &x,
+            double &y
+        ) const;
+        // Checks whether a cell is solid, cells beyond periodic edges wrap around
+        // param x x-coordinate of the cell
+        // param y y-coordinate of the cell
+        // return TRUE if the cell is solid or beyond a non-periodic edge
+        bool isSolid
+        (
+            long x,
+            long y
+        ) const;
+        // Tile of a particle
+        // param x x-coordinate of the particle
+        // param y y-coordinate of the particle
+        // return index of the tile, the number of tiles for removed particles
+        std::size_t getTile
+        (
+            double x,
+            double y
+        ) const;
+        // Writes the positions of the particles to the trajectory file
+        // param time time step of the record
+        void writeTrajectories
+        (
+            std::size_t time
+        );
+        // Lattice model to handle number of rows, columns and the node ordering
+        latticeBase &lb_;
+        // Number of nodes along x and y
+        std::size_t nx_;
+        std::size_t ny_;
+        // define fluid field;
+        fluidField &field_;
+        // Time integrator
+        e_integrators integrator_;
+        // Number of nodes along each side of a tile and number of tiles along x
+        // and y
+        std::size_t tile_size_;
+        std::size_t num_tiles_x_;
+        std::size_t num_tiles_y_;
+        // Behaviour of the particles at the edges: right, top, left and bottom
+        std::vector<e_boundaries> boundaries_;
+        // Solid cells stored row-wise
+        std::vector<unsigned char> is_solid_;
+        // Velocity of the current step, the last step and their mean in nodes
+        // per time step, x- and y-component of each node stored row-wise. An
+        // extra column and row repeat the edge, or the opposite edge if it is
+        // periodic, so that every position has an upper neighbour
+        std::vector<float> u_;
+        std::vector<float> u_last_;
+        std::vector<float> u_half_;
+        // Boolean toggle to indicate if u_last_ holds the velocity of a step
+        bool is_started_;
+        // Positions and IDs of the particles sorted by tile, and the sorted
+        // arrays being built
+        std::vector<double> x_;
+        std::vector<double> y_;
+        std::vector<std::uint32_t> id_;
+        std::vector<double> sorted_x_;
+        std::vector<double> sorted_y_;
+        std::vector<std::uint32_t> sorted_id_;
+        // First particle of each tile, the removed particles follow the last tile
+        std::vector<std::size_t> tile_first_;
+        // Boolean toggle to indicate if the particles are sorted by tile
+        bool is_sorted_;
+        // Number of steps since the particles were sorted
+        std::size_t num_unsorted_steps_;
+        // Trajectory file, number of steps between two records and positions of
+        // a record in ID order
+        std::ofstream file_;
+        std::size_t interval_;
+        std::vector<float> record_;
+        // Boolean toggle to indicate if the header of the trajectory file has
+        // been written
+        bool is_header_written_;
+};
+
+#endif // TRACERPARTICLES_HPP_INCLUDED
@@ -0,0 +1,930 @@
+// Python bindings for OpenLBM. The solver buffers (distribution functions,
+// density, pressure and velocity) are exposed through the buffer protocol as
+// memoryviews over the solver's own memory, so numpy.asarray() views them
+// without copying. LatticeBoltzmann.step() releases the GIL while stepping.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeD2Q9.hpp"
+#include "collisionD2Q9_BGK.hpp"
+#include "collisionD2Q9_MRT.hpp"
+#include "collisionD2Q9_RBGK.hpp"
+#include "collisionD2Q9_CM.hpp"
+#include "collisionD2Q9_BGK_LES.hpp"
+#include "collisionD2Q9_MRT_LES.hpp"
+#include "collisionD2Q9_BGK_PRE.hpp"
+#include "collisionD2Q9_MRT_PRE.hpp"
+#include "streamD2Q9.hpp"
+#include "bouncebackNode.hpp"
+#include "ZouHeNode.hpp"
+#include "latticeBoltzmann.hpp"
+
+namespace
+{
+
+// Lattice model, fluid field and lattice which are created together since the
+// lattice rescales the model velocities and everything else refers to them
+struct latticeHolder
+{
+    latticeHolder
+    (
+        std::size_t nx,
+        std::size_t ny,
+        double dl,
+        double dt,
+        const std::vector<double> &u0
+    )
+    : D2Q9 {},
+      field (nx, ny, u0),
+      lattice (nx, ny, dl, dt, D2Q9),
+      num_stepping {0}
+    {};
+    latticeModelD2Q9 D2Q9;
+    fluidField field;
+    latticeD2Q9 lattice;
+    // Number of solvers on the lattice which step without holding the GIL
+    std::size_t num_stepping;
+};
+
+// Python objects, each keeps references to the Python objects its C++ object
+// refers to so that they cannot be destroyed first
+struct arrayViewObject
+{
+    PyObject_HEAD
+    PyObject *owner;
+    double *data;
+    int ndim;
+    Py_ssize_t shape[3];
+    Py_ssize_t strides[3];
+};
+
+struct latticeObject
+{
+    PyObject_HEAD
+    latticeHolder *holder;
+};
+
+struct collisionObject
+{
+    PyObject_HEAD
+    collisionBase *collision;
+    PyObject *lattice;
+};
+
+struct streamObject
+{
+    PyObject_HEAD
+    streamBase *stream;
+    PyObject *lattice;
+};
+
+struct bouncebackObject
+{
+    PyObject_HEAD
+    bouncebackNode *node;
+    PyObject *lattice;
+    PyObject *model;
+};
+
+struct ZouHeObject
+{
+    PyObject_HEAD
+    ZouHeNode *node;
+    PyObject *lattice;
+    PyObject *collision;
+};
+
+struct latticeBoltzmannObject
+{
+    PyObject_HEAD
+    latticeBoltzmann *run;
+    PyObject *lattice;
+    PyObject *collision;
+    PyObject *stream;
+    PyObject *boundaries;
+    // Set under the GIL while step() runs without it
+    bool is_stepping;
+};
+
+PyTypeObject arrayViewType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject latticeType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject collisionType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject streamType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject bouncebackType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject ZouHeType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+PyTypeObject latticeBoltzmannType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+// Converts the active C++ exception into a Python RuntimeError
+void setPythonError()
+{
+    try
+    {
+        throw;
+    }
+    catch (const std::exception &e)
+    {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+    }
+    catch (...)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Unknown C++ exception");
+    }
+}
+
+// Checks that the C++ object behind a Python object has been created, i.e.
+// that __init__ has succeeded
+// param object pointer to the C++ object
+// param name Python type name for the error message
+// return TRUE if the object is ready, FALSE with a Python error set otherwise
+bool isReady
+(
+    const void *object,
+    const char *name
+)
+{
+    if (object) return true;
+    PyErr_Format(PyExc_RuntimeError, "%s is not initialized", name);
+    return false;
+}
+
+// Creates a writable memoryview over solver memory laid out as (ny, nx[, width])
+// param owner Python object which owns the memory
+// param data pointer to the first value
+// param ny number of grid along y coordinate
+// param nx number of grid along x coordinate
+// param width number of values at each node, 1 for scalar fields
+// return new reference to the memoryview, nullptr on error
+PyObject* makeView
+(
+    PyObject *owner,
+    double *data,
+    std::size_t ny,
+    std::size_t nx,
+    std::size_t width
+)
+{
+    auto view = PyObject_New(arrayViewObject, &arrayViewType);
+    if (!view) return nullptr;
+    Py_INCREF(owner);
+    view->owner = owner;
+    view->data = data;
+    view->ndim = width > 1 ? 3 : 2;
+    view->shape[0] = ny;
+    view->shape[1] = nx;
+    view->shape[2] = width;
+    view->strides[2] = sizeof(double);
+    view->strides[1] = width * sizeof(double);
+    view->strides[0] = nx * width * sizeof(double);
+    auto memory_view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(view));
+    Py_DECREF(view);
+    return memory_view;
+}
+
+int arrayViewGetBuffer(PyObject *self, Py_buffer *buffer, int)
+{
+    auto view = reinterpret_cast<arrayViewObject*>(self);
+    Py_INCREF(self);
+    buffer->obj = self;
+    buffer->buf = view->data;
+    buffer->len = view->shape[0] * view->strides[0];
+    buffer->readonly = 0;
+    buffer->itemsize = sizeof(double);
+    buffer->format = const_cast<char*>("d");
+    buffer->ndim = view->ndim;
+    buffer->shape = view->shape;
+    buffer->strides = view->strides;
+    buffer->suboffsets = nullptr;
+    buffer->internal = nullptr;
+    return 0;
+}
+
+void arrayViewDealloc(PyObject *self)
+{
+    Py_XDECREF(reinterpret_cast<arrayViewObject*>(self)->owner);
+    PyObject_Free(self);
+}
+
+PyBufferProcs arrayViewBuffer = {arrayViewGetBuffer, nullptr};
+
+// Lattice(nx, ny, dl=1.0, dt=1.0, u0=(0.0, 0.0))
+int latticeInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"nx", "ny", "dl", "dt", "u0", nullptr};
+    Py_ssize_t nx = 0;
+    Py_ssize_t ny = 0;
+    auto dl = 1.0;
+    auto dt = 1.0;
+    std::vector<double> u0 = {0.0, 0.0};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "nn|dd(dd)", const_cast<char**>(keywords),
+                                     &nx, &ny, &dl, &dt, &u0[0], &u0[1])) return -1;
+    if (nx < 2 || ny < 2)
+    {
+        PyErr_SetString(PyExc_ValueError, "Lattice needs at least 2 x 2 nodes");
+        return -1;
+    }
+    auto lattice = reinterpret_cast<latticeObject*>(self);
+    if (lattice->holder)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Lattice is already initialized");
+        return -1;
+    }
+    try
+    {
+        lattice->holder = new latticeHolder(nx, ny, dl, dt, u0);
+    }
+    catch (...)
+    {
+        setPythonError();
+        return -1;
+    }
+    return 0;
+}
+
+void latticeDealloc(PyObject *self)
+{
+    delete reinterpret_cast<latticeObject*>(self)->holder;
+    Py_TYPE(self)->tp_free(self);
+}
+
+latticeHolder* getHolder(PyObject *lattice)
+{
+    auto holder = reinterpret_cast<latticeObject*>(lattice)->holder;
+    isReady(holder, "Lattice");
+    return holder;
+}
+
+// Checks that an object is built on the same lattice as the objects it is
+// combined with, they index each other's buffers by the nodes of one lattice
+// param lattice Python lattice of the object
+// param other Python lattice of the object it is combined with
+// param name Python type name of the other object for the error message
+// return TRUE if the lattices are the same, FALSE with a Python error set otherwise
+bool isSameLattice
+(
+    PyObject *lattice,
+    PyObject *other,
+    const char *name
+)
+{
+    if (getHolder(lattice) == getHolder(other)) return true;
+    PyErr_Format(PyExc_ValueError, "%s is built on a different Lattice", name);
+    return false;
+}
+
+// Checks that no solver on a lattice is stepping, the boundaries and the
+// solvers on it must not change while a step runs without the GIL
+// param lattice Python lattice of the object which is modified
+// param name Python type name of the object for the error message
+// return TRUE if no solver is stepping, FALSE with a Python error set otherwise
+bool isIdle
+(
+    PyObject *lattice,
+    const char *name
+)
+{
+    if (getHolder(lattice)->num_stepping == 0) return true;
+    PyErr_Format(PyExc_RuntimeError, "%s cannot be modified while a LatticeBoltzmann on its "
+                 "Lattice is stepping", name);
+    return false;
+}
+
+PyObject* latticeGetNx(PyObject *self, void*)
+{
+    if (!getHolder(self)) return nullptr;
+    return PyLong_FromSize_t(getHolder(self)->lattice.getNumberOfNx());
+}
+
+PyObject* latticeGetNy(PyObject *self, void*)
+{
+    if (!getHolder(self)) return nullptr;
+    return PyLong_FromSize_t(getHolder(self)->lattice.getNumberOfNy());
+}
+
+PyObject* latticeGetP(PyObject *self, void*)
+{
+    auto holder = getHolder(self);
+    if (!holder) return nullptr;
+    const auto nx = holder->lattice.getNumberOfNx();
+    const auto ny = holder->lattice.getNumberOfNy();
+    return makeView(self, holder->field.p.data(), ny, nx, 1);
+}
+
+PyObject* latticeGetU(PyObject *self, void*)
+{
+    auto holder = getHolder(self);
+    if (!holder) return nullptr;
+    const auto nx = holder->lattice.getNumberOfNx();
+    const auto ny = holder->lattice.getNumberOfNy();
+    return makeView(self, holder->field.u.data(), ny, nx, holder->field.u.width());
+}
+
+PyGetSetDef latticeGetSet[] =
+{
+    {const_cast<char*>("nx"), latticeGetNx, nullptr, const_cast<char*>("Number of grid along x"), nullptr},
+    {const_cast<char*>("ny"), latticeGetNy, nullptr, const_cast<char*>("Number of grid along y"), nullptr},
+    {const_cast<char*>("p"), latticeGetP, nullptr, const_cast<char*>("Relative pressure, (ny, nx) view"), nullptr},
+    {const_cast<char*>("u"), latticeGetU, nullptr, const_cast<char*>("Velocity, (ny, nx, 2) view"), nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+// Collision(lattice, viscosity, rho0=1.0, model="MRT", smagorinsky=0.1, gamma=0.5),
+// the Smagorinsky constant is only used by the LES models, the preconditioning
+// parameter gamma only by the PRE models
+int collisionInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"lattice", "viscosity", "rho0", "model", "smagorinsky", "gamma",
+                                     nullptr};
+    PyObject *lattice = nullptr;
+    auto viscosity = 0.0;
+    auto rho0 = 1.0;
+    const char *model = "MRT";
+    auto smagorinsky = 0.1;
+    auto gamma = 0.5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!d|dsdd", const_cast<char**>(keywords),
+                                     &latticeType, &lattice, &viscosity, &rho0, &model,
+                                     &smagorinsky, &gamma)) return -1;
+    auto collision = reinterpret_cast<collisionObject*>(self);
+    if (collision->collision)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Collision is already initialized");
+        return -1;
+    }
+    auto holder = getHolder(lattice);
+    if (!holder) return -1;
+    try
+    {
+        const std::string name(model);
+        if (name == "BGK")
+        {
+            collision->collision = new collisionD2Q9_BGK(holder->lattice, viscosity, rho0,
+                                                         holder->D2Q9, holder->field);
+        }
+        else if (name == "MRT")
+        {
+            collision->collision = new collisionD2Q9_MRT(holder->lattice, viscosity, rho0,
+                                                         holder->D2Q9, holder->field);
+        }
+        else if (name == "RBGK")
+        {
+            collision->collision = new collisionD2Q9_RBGK(holder->lattice, viscosity, rho0,
+                                                          holder->D2Q9, holder->field);
+        }
+        else if (name == "CM")
+        {
+            collision->collision = new collisionD2Q9_CM(holder->lattice, viscosity, rho0,
+                                                        holder->D2Q9, holder->field);
+        }
+        else if (name == "BGK_LES")
+        {
+            collision->collision = new collisionD2Q9_BGK_LES(holder->lattice, viscosity, smagorinsky,
+                                                             rho0, holder->D2Q9, holder->field);
+        }
+        else if (name == "MRT_LES")
+        {
+            collision->collision = new collisionD2Q9_MRT_LES(holder->lattice, viscosity, smagorinsky,
+                                                             rho0, holder->D2Q9, holder->field);
+        }
+        else if (name == "BGK_PRE")
+        {
+            collision->collision = new collisionD2Q9_BGK_PRE(holder->lattice, viscosity, gamma,
+                                                             rho0, holder->D2Q9, holder->field);
+        }
+        else if (name == "MRT_PRE")
+        {
+            collision->collision = new collisionD2Q9_MRT_PRE(holder->lattice, viscosity, gamma,
+                                                             rho0, holder->D2Q9, holder->field);
+        }
+        else
+        {
+            PyErr_SetString(PyExc_ValueError,
+                            "model must be \"BGK\", \"MRT\", \"RBGK\", \"CM\", \"BGK_LES\", "
+                            "\"MRT_LES\", \"BGK_PRE\" or \"MRT_PRE\"");
+            return -1;
+        }
+    }
+    catch (...)
+    {
+        setPythonError();
+        return -1;
+    }
+    Py_INCREF(lattice);
+    collision->lattice = lattice;
+    return 0;
+}
+
+void collisionDealloc(PyObject *self)
+{
+    auto collision = reinterpret_cast<collisionObject*>(self);
+    delete collision->collision;
+    Py_XDECREF(collision->lattice);
+    Py_TYPE(self)->tp_free(self);
+}
+
+PyObject* collisionGetRho(PyObject *self, void*)
+{
+    auto collision = reinterpret_cast<collisionObject*>(self);
+    if (!isReady(collision->collision, "Collision")) return nullptr;
+    auto holder = getHolder(collision->lattice);
+    const auto nx = holder->lattice.getNumberOfNx();
+    const auto ny = holder->lattice.getNumberOfNy();
+    return makeView(self, collision->collision->rho_.data(), ny, nx, 1);
+}
+
+PyGetSetDef collisionGetSet[] =
+{
+    {const_cast<char*>("rho"), collisionGetRho, nullptr, const_cast<char*>("Density, (ny, nx) view"), nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+// Stream(lattice)
+int streamInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"lattice", nullptr};
+    PyObject *lattice = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!", const_cast<char**>(keywords),
+                                     &latticeType, &lattice)) return -1;
+    auto stream = reinterpret_cast<streamObject*>(self);
+    if (stream->stream)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Stream is already initialized");
+        return -1;
+    }
+    auto holder = getHolder(lattice);
+    if (!holder) return -1;
+    stream->stream = new streamD2Q9(holder->lattice, holder->D2Q9);
+    Py_INCREF(lattice);
+    stream->lattice = lattice;
+    return 0;
+}
+
+void streamDealloc(PyObject *self)
+{
+    auto stream = reinterpret_cast<streamObject*>(self);
+    delete stream->stream;
+    Py_XDECREF(stream->lattice);
+    Py_TYPE(self)->tp_free(self);
+}
+
+// Bounceback(lattice, model): full-way bounceback if model is a Collision,
+// half-way bounceback if model is a Stream
+int bouncebackInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"lattice", "model", nullptr};
+    PyObject *lattice = nullptr;
+    PyObject *model = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O", const_cast<char**>(keywords),
+                                     &latticeType, &lattice, &model)) return -1;
+    auto bounceback = reinterpret_cast<bouncebackObject*>(self);
+    if (bounceback->node)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Bounceback is already initialized");
+        return -1;
+    }
+    auto holder = getHolder(lattice);
+    if (!holder) return -1;
+    if (PyObject_TypeCheck(model, &collisionType))
+    {
+        auto cb = reinterpret_cast<collisionObject*>(model)->collision;
+        if (!isReady(cb, "Collision") ||
+            !isSameLattice(lattice, reinterpret_cast<collisionObject*>(model)->lattice, "Collision"))
+        {
+            return -1;
+        }
+        bounceback->node = new bouncebackNode(holder->lattice, cb, holder->D2Q9, holder->field);
+    }
+    else if (PyObject_TypeCheck(model, &streamType))
+    {
+        auto sb = reinterpret_cast<streamObject*>(model)->stream;
+        if (!isReady(sb, "Stream") ||
+            !isSameLattice(lattice, reinterpret_cast<streamObject*>(model)->lattice, "Stream"))
+        {
+            return -1;
+        }
+        bounceback->node = new bouncebackNode(holder->lattice, sb, holder->D2Q9, holder->field);
+    }
+    else
+    {
+        PyErr_SetString(PyExc_TypeError, "model must be a Collision or a Stream");
+        return -1;
+    }
+    Py_INCREF(lattice);
+    bounceback->lattice = lattice;
+    Py_INCREF(model);
+    bounceback->model = model;
+    return 0;
+}
+
+void bouncebackDealloc(PyObject *self)
+{
+    auto bounceback = reinterpret_cast<bouncebackObject*>(self);
+    delete bounceback->node;
+    Py_XDECREF(bounceback->lattice);
+    Py_XDECREF(bounceback->model);
+    Py_TYPE(self)->tp_free(self);
+}
+
+// Bounceback.add_node(x, y, obstacle_id=0)
+PyObject* bouncebackAddNode(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"x", "y", "obstacle_id", nullptr};
+    Py_ssize_t x = 0;
+    Py_ssize_t y = 0;
+    Py_ssize_t obstacle_id = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "nn|n", const_cast<char**>(keywords),
+                                     &x, &y, &obstacle_id)) return nullptr;
+    auto bounceback = reinterpret_cast<bouncebackObject*>(self);
+    if (!isReady(bounceback->node, "Bounceback") ||
+        !isIdle(bounceback->lattice, "Bounceback")) return nullptr;
+    auto holder = getHolder(bounceback->lattice);
+    if (x < 0 || y < 0 || obstacle_id < 0 ||
+        static_cast<std::size_t>(x) >= holder->lattice.getNumberOfNx() ||
+        static_cast<std::size_t>(y) >= holder->lattice.getNumberOfNy())
+    {
+        PyErr_SetString(PyExc_IndexError, "Node outside of lattice");
+        return nullptr;
+    }
+    bounceback->node->addObstacleNode(x, y, obstacle_id);
+    Py_RETURN_NONE;
+}
+
+PyObject* bouncebackToggleForce(PyObject *self, PyObject*)
+{
+    auto bounceback = reinterpret_cast<bouncebackObject*>(self);
+    auto node = bounceback->node;
+    if (!isReady(node, "Bounceback") || !isIdle(bounceback->lattice, "Bounceback")) return nullptr;
+    node->toggleForceEvaluation();
+    Py_RETURN_NONE;
+}
+
+PyObject* bouncebackGetForce(PyObject *self, void*)
+{
+    auto node = reinterpret_cast<bouncebackObject*>(self)->node;
+    if (!isReady(node, "Bounceback")) return nullptr;
+    const auto &force = node->force;
+    auto list = PyList_New(force.size());
+    if (!list) return nullptr;
+    for (auto k = 0u; k < force.size(); ++k)
+    {
+        auto item = Py_BuildValue("(dd)", force[k][0], force[k][1]);
+        if (!item)
+        {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, k, item);
+    }  // k
+    return list;
+}
+
+PyMethodDef bouncebackMethods[] =
+{
+    {"add_node", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(bouncebackAddNode)),
+     METH_VARARGS | METH_KEYWORDS, "Adds a bounceback node, optionally to an obstacle ID"},
+    {"toggle_force_evaluation", bouncebackToggleForce, METH_NOARGS,
+     "Toggles momentum-exchange force evaluation"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef bouncebackGetSet[] =
+{
+    {const_cast<char*>("force"), bouncebackGetForce, nullptr,
+     const_cast<char*>("Force of the last step per obstacle ID"), nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+// ZouHe(lattice, collision)
+int ZouHeInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"lattice", "collision", nullptr};
+    PyObject *lattice = nullptr;
+    PyObject *collision = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!", const_cast<char**>(keywords),
+                                     &latticeType, &lattice, &collisionType, &collision)) return -1;
+    auto zou_he = reinterpret_cast<ZouHeObject*>(self);
+    if (zou_he->node)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "ZouHe is already initialized");
+        return -1;
+    }
+    auto holder = getHolder(lattice);
+    auto cb = reinterpret_cast<collisionObject*>(collision)->collision;
+    if (!holder || !isReady(cb, "Collision") ||
+        !isSameLattice(lattice, reinterpret_cast<collisionObject*>(collision)->lattice, "Collision"))
+    {
+        return -1;
+    }
+    zou_he->node = new ZouHeNode(holder->lattice, *cb, holder->D2Q9, holder->field);
+    Py_INCREF(lattice);
+    zou_he->lattice = lattice;
+    Py_INCREF(collision);
+    zou_he->collision = collision;
+    return 0;
+}
+
+void ZouHeDealloc(PyObject *self)
+{
+    auto zou_he = reinterpret_cast<ZouHeObject*>(self);
+    delete zou_he->node;
+    Py_XDECREF(zou_he->lattice);
+    Py_XDECREF(zou_he->collision);
+    Py_TYPE(self)->tp_free(self);
+}
+
+// ZouHe.add_node(x, y, ux, uy)
+PyObject* ZouHeAddNode(PyObject *self, PyObject *args)
+{
+    Py_ssize_t x = 0;
+    Py_ssize_t y = 0;
+    auto u_x = 0.0;
+    auto u_y = 0.0;
+    if (!PyArg_ParseTuple(args, "nndd", &x, &y, &u_x, &u_y)) return nullptr;
+    auto zou_he = reinterpret_cast<ZouHeObject*>(self);
+    if (!isReady(zou_he->node, "ZouHe") || !isIdle(zou_he->lattice, "ZouHe")) return nullptr;
+    auto holder = getHolder(zou_he->lattice);
+    const auto nx = holder->lattice.getNumberOfNx();
+    const auto ny = holder->lattice.getNumberOfNy();
+    const auto is_on_edge = x == 0 || y == 0 || static_cast<std::size_t>(x) == nx - 1 ||
+                            static_cast<std::size_t>(y) == ny - 1;
+    if (x < 0 || y < 0 || static_cast<std::size_t>(x) >= nx ||
+        static_cast<std::size_t>(y) >= ny || !is_on_edge)
+    {
+        PyErr_SetString(PyExc_IndexError, "Zou/He nodes must lie on the lattice edge");
+        return nullptr;
+    }
+    zou_he->node->addNode(x, y, u_x, u_y);
+    Py_RETURN_NONE;
+}
+
+PyObject* ZouHeToggleNormalFlow(PyObject *self, PyObject*)
+{
+    auto zou_he = reinterpret_cast<ZouHeObject*>(self);
+    auto node = zou_he->node;
+    if (!isReady(node, "ZouHe") || !isIdle(zou_he->lattice, "ZouHe")) return nullptr;
+    node->toggleNormalFlow();
+    Py_RETURN_NONE;
+}
+
+PyMethodDef ZouHeMethods[] =
+{
+    {"add_node", ZouHeAddNode, METH_VARARGS, "Adds a Zou/He velocity node"},
+    {"toggle_normal_flow", ZouHeToggleNormalFlow, METH_NOARGS,
+     "Extrapolates the node velocity from the neighbouring nodes (outlet)"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+// LatticeBoltzmann(lattice, collision, stream)
+int latticeBoltzmannInit(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static const char *keywords[] = {"lattice", "collision", "stream", nullptr};
+    PyObject *lattice = nullptr;
+    PyObject *collision = nullptr;
+    PyObject *stream = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!O!", const_cast<char**>(keywords),
+                                     &latticeType, &lattice, &collisionType, &collision,
+                                     &streamType, &stream)) return -1;
+    auto solver = reinterpret_cast<latticeBoltzmannObject*>(self);
+    if (solver->run)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "LatticeBoltzmann is already initialized");
+        return -1;
+    }
+    auto holder = getHolder(lattice);
+    auto cb = reinterpret_cast<collisionObject*>(collision)->collision;
+    auto sb = reinterpret_cast<streamObject*>(stream)->stream;
+    if (!holder || !isReady(cb, "Collision") || !isReady(sb, "Stream") ||
+        !isSameLattice(lattice, reinterpret_cast<collisionObject*>(collision)->lattice, "Collision") ||
+        !isSameLattice(lattice, reinterpret_cast<streamObject*>(stream)->lattice, "Stream"))
+    {
+        return -1;
+    }
+    solver->boundaries = PyList_New(0);
+    if (!solver->boundaries) return -1;
+    try
+    {
+        solver->run = new latticeBoltzmann(holder->lattice, *cb, *sb);
+    }
+    catch (...)
+    {
+        setPythonError();
+        return -1;
+    }
+    Py_INCREF(lattice);
+    solver->lattice = lattice;
+    Py_INCREF(collision);
+    solver->collision = collision;
+    Py_INCREF(stream);
+    solver->stream = stream;
+    return 0;
+}
+
+void latticeBoltzmannDealloc(PyObject *self)
+{
+    auto solver = reinterpret_cast<latticeBoltzmannObject*>(self);
+    delete solver->run;
+    Py_XDECREF(solver->lattice);
+    Py_XDECREF(solver->collision);
+    Py_XDECREF(solver->stream);
+    Py_XDECREF(solver->boundaries);
+    Py_TYPE(self)->tp_free(self);
+}
+
+// LatticeBoltzmann.add_boundary(node)
+PyObject* latticeBoltzmannAddBoundary(PyObject *self, PyObject *node)
+{
+    boundaryNode *bn = nullptr;
+    PyObject *lattice = nullptr;
+    if (PyObject_TypeCheck(node, &bouncebackType))
+    {
+        bn = reinterpret_cast<bouncebackObject*>(node)->node;
+        lattice = reinterpret_cast<bouncebackObject*>(node)->lattice;
+    }
+    else if (PyObject_TypeCheck(node, &ZouHeType))
+    {
+        bn = reinterpret_cast<ZouHeObject*>(node)->node;
+        lattice = reinterpret_cast<ZouHeObject*>(node)->lattice;
+    }
+    if (!bn)
+    {
+        PyErr_SetString(PyExc_TypeError, "node must be an initialized Bounceback or ZouHe");
+        return nullptr;
+    }
+    auto solver = reinterpret_cast<latticeBoltzmannObject*>(self);
+    if (!isReady(solver->run, "LatticeBoltzmann") ||
+        !isSameLattice(solver->lattice, lattice, Py_TYPE(node)->tp_name)) return nullptr;
+    if (solver->is_stepping)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "LatticeBoltzmann cannot add a boundary while stepping");
+        return nullptr;
+    }
+    if (PyList_Append(solver->boundaries, node) != 0) return nullptr;
+    solver->run->addBoundaryNode(bn);
+    Py_RETURN_NONE;
+}
+
+// LatticeBoltzmann.step(n=1), the GIL is released while stepping so other Python
+// threads keep running. The busy flags are set under the GIL, so that step(),
+// add_boundary() and the add_node() and toggle methods of the boundaries on the
+// lattice raise RuntimeError in other threads meanwhile
+PyObject* latticeBoltzmannStep(PyObject *self, PyObject *args)
+{
+    Py_ssize_t num_steps = 1;
+    if (!PyArg_ParseTuple(args, "|n", &num_steps)) return nullptr;
+    auto solver = reinterpret_cast<latticeBoltzmannObject*>(self);
+    auto run = solver->run;
+    if (!isReady(run, "LatticeBoltzmann")) return nullptr;
+    if (solver->is_stepping)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "LatticeBoltzmann is already stepping in another thread");
+        return nullptr;
+    }
+    auto holder = getHolder(solver->lattice);
+    solver->is_stepping = true;
+    ++holder->num_stepping;
+    auto is_failed = false;
+    std::string message;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        for (Py_ssize_t t = 0; t < num_steps; ++t) run->takeStep();
+    }
+    catch (const std::exception &e)
+    {
+        is_failed = true;
+        message = e.what();
+    }
+    Py_END_ALLOW_THREADS
+    solver->is_stepping = false;
+    --holder->num_stepping;
+    if (is_failed)
+    {
+        PyErr_SetString(PyExc_RuntimeError, message.c_str());
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject* latticeBoltzmannGetDf(PyObject *self, void*)
+{
+    auto solver = reinterpret_cast<latticeBoltzmannObject*>(self);
+    if (!isReady(solver->run, "LatticeBoltzmann")) return nullptr;
+    auto holder = getHolder(solver->lattice);
+    const auto nx = holder->lattice.getNumberOfNx();
+    const auto ny = holder->lattice.getNumberOfNy();
+    auto &df = solver->run->getDistributionFunctions();
+    return makeView(self, df.data(), ny, nx, df.width());
+}
+
+PyMethodDef latticeBoltzmannMethods[] =
+{
+    {"add_boundary", latticeBoltzmannAddBoundary, METH_O, "Adds a boundary condition"},
+    {"step", latticeBoltzmannStep, METH_VARARGS, "Takes n steps without holding the GIL"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyGetSetDef latticeBoltzmannGetSet[] =
+{
+    {const_cast<char*>("df"), latticeBoltzmannGetDf, nullptr,
+     const_cast<char*>("Distribution functions, (ny, nx, 9) view"), nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+// Fills the common slots of a type and readies it
+// return 0 if successful
+int readyType
+(
+    PyTypeObject &type,
+    const char *name,
+    std::size_t size,
+    const char *doc,
+    initproc init,
+    destructor dealloc
+)
+{
+    type.tp_name = name;
+    type.tp_basicsize = size;
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = doc;
+    type.tp_new = PyType_GenericNew;
+    type.tp_init = init;
+    type.tp_dealloc = dealloc;
+    return PyType_Ready(&type);
+}
+
+PyModuleDef openlbmModule =
+{
+    PyModuleDef_HEAD_INIT,
+    "openlbm",
+    "Python bindings for OpenLBM with zero-copy views of the solver buffers",
+    -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit_openlbm()
+{
+    arrayViewType.tp_name = "openlbm._ArrayView";
+    arrayViewType.tp_basicsize = sizeof(arrayViewObject);
+    arrayViewType.tp_flags = Py_TPFLAGS_DEFAULT;
+    arrayViewType.tp_dealloc = arrayViewDealloc;
+    arrayViewType.tp_as_buffer = &arrayViewBuffer;
+    if (PyType_Ready(&arrayViewType) < 0) return nullptr;
+
+    latticeType.tp_getset = latticeGetSet;
+    collisionType.tp_getset = collisionGetSet;
+    bouncebackType.tp_methods = bouncebackMethods;
+    bouncebackType.tp_getset = bouncebackGetSet;
+    ZouHeType.tp_methods = ZouHeMethods;
+    latticeBoltzmannType.tp_methods = latticeBoltzmannMethods;
+    latticeBoltzmannType.tp_getset = latticeBoltzmannGetSet;
+    if (readyType(latticeType, "openlbm.Lattice", sizeof(latticeObject),
+                  "Lattice(nx, ny, dl=1.0, dt=1.0, u0=(0.0, 0.0)): D2Q9 lattice and fluid field",
+                  latticeInit, latticeDealloc) < 0 ||
+        readyType(collisionType, "openlbm.Collision", sizeof(collisionObject),
+                  "Collision(lattice, viscosity, rho0=1.0, model=\"MRT\", smagorinsky=0.1, "
+                  "gamma=0.5): BGK, MRT, RBGK, CM, BGK_LES, MRT_LES, BGK_PRE or MRT_PRE collision",
+                  collisionInit, collisionDealloc) < 0 ||
+        readyType(streamType, "openlbm.Stream", sizeof(streamObject),
+                  "Stream(lattice): non-periodic D2Q9 streaming",
+                  streamInit, streamDealloc) < 0 ||
+        readyType(bouncebackType, "openlbm.Bounceback", sizeof(bouncebackObject),
+                  "Bounceback(lattice, model): full-way with a Collision, half-way with a Stream",
+                  bouncebackInit, bouncebackDealloc) < 0 ||
+        readyType(ZouHeType, "openlbm.ZouHe", sizeof(ZouHeObject),
+                  "ZouHe(lattice, collision): Zou/He velocity boundary",
+                  ZouHeInit, ZouHeDealloc) < 0 ||
+        readyType(latticeBoltzmannType, "openlbm.LatticeBoltzmann", sizeof(latticeBoltzmannObject),
+                  "LatticeBoltzmann(lattice, collision, stream): time stepping",
+                  latticeBoltzmannInit, latticeBoltzmannDealloc) < 0) return nullptr;
+
+    auto module = PyModule_Create(&openlbmModule);
+    if (!module) return nullptr;
+    const std::vector<std::pair<const char*, PyTypeObject*>> types =
+    {
+        {"Lattice", &latticeType},
+        {"Collision", &collisionType},
+        {"Stream", &streamType},
+        {"Bounceback", &bouncebackType},
+        {"ZouHe", &ZouHeType},
+        {"LatticeBoltzmann", &latticeBoltzmannType}
+    };
+    for (auto &type : types)
+    {
+        Py_INCREF(type.second);
+        if (PyModule_AddObject(module, type.first, reinterpret_cast<PyObject*>(type.second)) < 0)
+        {
+            Py_DECREF(type.second);
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }  // type
+    return module;
+}
@@ -0,0 +1,154 @@
+# Tests of the openlbm Python module, run by ctest with the module directory
+# on PYTHONPATH
+import threading
+import time
+import unittest
+
+import openlbm
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+class latticeMismatchTest(unittest.TestCase):
+    def setUp(self):
+        self.lattice = openlbm.Lattice(8, 8)
+        self.other = openlbm.Lattice(512, 512)
+        self.collision = openlbm.Collision(self.lattice, 0.1, model="BGK")
+        self.stream = openlbm.Stream(self.lattice)
+
+    def test_solver_with_stream_of_other_lattice(self):
+        with self.assertRaises(ValueError):
+            openlbm.LatticeBoltzmann(self.lattice, self.collision, openlbm.Stream(self.other))
+
+    def test_solver_with_collision_of_other_lattice(self):
+        collision = openlbm.Collision(self.other, 0.1, model="BGK")
+        with self.assertRaises(ValueError):
+            openlbm.LatticeBoltzmann(self.lattice, collision, self.stream)
+
+    def test_boundaries_with_model_of_other_lattice(self):
+        with self.assertRaises(ValueError):
+            openlbm.Bounceback(self.other, self.collision)
+        with self.assertRaises(ValueError):
+            openlbm.Bounceback(self.other, self.stream)
+        with self.assertRaises(ValueError):
+            openlbm.ZouHe(self.other, self.collision)
+
+    def test_boundary_of_other_lattice(self):
+        solver = openlbm.LatticeBoltzmann(self.lattice, self.collision, self.stream)
+        node = openlbm.Bounceback(self.other, openlbm.Stream(self.other))
+        with self.assertRaises(ValueError):
+            solver.add_boundary(node)
+
+    def test_matching_lattice_steps(self):
+        solver = openlbm.LatticeBoltzmann(self.lattice, self.collision, self.stream)
+        wall = openlbm.Bounceback(self.lattice, self.stream)
+        for x in range(8):
+            wall.add_node(x, 0)
+        solver.add_boundary(wall)
+        solver.step(5)
+        self.assertAlmostEqual(self.collision.rho[4, 4], 1.0)
+
+
+
+@unittest.skipUnless(numpy, "numpy is not installed")
+class zeroCopyTest(unittest.TestCase):
+    # viscosity 0.1 gives tau = 0.8, one BGK step from rest moves the interior
+    # nodes by 1 / tau towards the equilibrium of the velocity and density the
+    # solver reads, the edges lose populations
+    def setUp(self):
+        self.tau = 0.8
+        self.lattice = openlbm.Lattice(8, 8)
+        self.collision = openlbm.Collision(self.lattice, 0.1, model="BGK")
+        self.stream = openlbm.Stream(self.lattice)
+        self.solver = openlbm.LatticeBoltzmann(self.lattice, self.collision, self.stream)
+
+    def test_views_share_memory(self):
+        views = [lambda: self.lattice.u, lambda: self.lattice.p,
+                 lambda: self.collision.rho, lambda: self.solver.df]
+        for view in views:
+            self.assertTrue(numpy.shares_memory(numpy.asarray(view()), numpy.asarray(view())))
+
+    def test_shapes(self):
+        self.assertEqual(numpy.asarray(self.lattice.u).shape, (8, 8, 2))
+        self.assertEqual(numpy.asarray(self.lattice.p).shape, (8, 8))
+        self.assertEqual(numpy.asarray(self.collision.rho).shape, (8, 8))
+        self.assertEqual(numpy.asarray(self.solver.df).shape, (8, 8, 9))
+
+    def test_velocity_write_reaches_solver(self):
+        numpy.asarray(self.lattice.u)[:, :, 0] = 0.05
+        self.solver.step()
+        u = numpy.asarray(self.lattice.u)
+        self.assertAlmostEqual(float(u[4, 4, 0]), 0.05 / self.tau, places=12)
+
+    def test_arrays_update_in_place(self):
+        u = numpy.asarray(self.lattice.u)
+        rho = numpy.asarray(self.collision.rho)
+        df = numpy.asarray(self.solver.df)
+        u[:, :, 0] = 0.05
+        u_before = u.copy()
+        df_before = df.copy()
+        self.solver.step()
+        # the arrays taken before the step show its result without a refetch
+        self.assertFalse(numpy.array_equal(u, u_before))
+        self.assertFalse(numpy.array_equal(df, df_before))
+        self.assertAlmostEqual(float(u[4, 4, 0]), 0.05 / self.tau, places=12)
+        self.assertAlmostEqual(float(df[4, 4].sum()), float(rho[4, 4]), places=12)
+
+    def test_df_write_reaches_solver(self):
+        df = numpy.asarray(self.solver.df)
+        df *= 2.0
+        self.solver.step()
+        # the doubled populations relax towards the equilibrium of density 1
+        rho = numpy.asarray(self.collision.rho)
+        self.assertAlmostEqual(float(rho[4, 4]), 2.0 - 1.0 / self.tau, places=12)
+
+
+class threadingTest(unittest.TestCase):
+    def setUp(self):
+        self.lattice = openlbm.Lattice(128, 128)
+        self.collision = openlbm.Collision(self.lattice, 0.1, model="BGK")
+        self.stream = openlbm.Stream(self.lattice)
+        self.solver = openlbm.LatticeBoltzmann(self.lattice, self.collision, self.stream)
+        self.wall = openlbm.Bounceback(self.lattice, self.stream)
+        self.wall.add_node(1, 0)
+
+    def test_modifications_while_stepping(self):
+        errors = []
+
+        def step():
+            try:
+                self.solver.step(2000)
+            except RuntimeError as e:
+                errors.append(e)
+
+        thread = threading.Thread(target=step)
+        thread.start()
+        # step(0) raises as soon as the other thread is stepping
+        deadline = time.time() + 10.0
+        is_stepping = False
+        while not is_stepping and thread.is_alive() and time.time() < deadline:
+            try:
+                self.solver.step(0)
+            except RuntimeError:
+                is_stepping = True
+        try:
+            self.assertTrue(is_stepping)
+            with self.assertRaises(RuntimeError):
+                self.solver.step()
+            with self.assertRaises(RuntimeError):
+                self.solver.add_boundary(self.wall)
+            with self.assertRaises(RuntimeError):
+                self.wall.add_node(2, 0)
+        finally:
+            thread.join()
+        self.assertEqual(errors, [])
+        self.solver.add_boundary(self.wall)
+        self.wall.add_node(2, 0)
+        self.solver.step()
+
+
+if __name__ == "__main__":
+    unittest.main()
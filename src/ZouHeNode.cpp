@@ -9,6 +9,7 @@
 #include "latticeModel.hxx"
 
 #include "ZouHeNode.hpp"
+#include "nodeTypeField.hpp"
 #include "latticeNode.hxx"
 
 ZouHeNode::ZouHeNode
@@ -45,7 +46,7 @@ void ZouHeNode::addNode
 {
     const auto nx = lb_.getNumberOfNx();
     const auto ny = lb_.getNumberOfNy();
-    const auto n  = y * nx + x;
+    const auto n  = lb_.getNodeIndex(x, y);
     const auto left   = x == 0;
     const auto right  = x == nx - 1;
     const auto bottom = y == 0;
@@ -75,13 +76,13 @@ void ZouHeNode::addNode
 
 void ZouHeNode::updateNode
 (
-    std::vector<std::vector<double>> &df,
+    latticeArray<double> &df,
     bool is_modify_stream
 )
 {
     if (!is_modify_stream)
     {
-        for (auto node : nodes)
+        for (auto &node : nodes)
         {
             if (node.corner)
             {
@@ -95,20 +96,44 @@ void ZouHeNode::updateNode
     }
 }
 
+void ZouHeNode::getRows
+(
+    std::size_t &first_row,
+    std::size_t &last_row
+) const
+{
+    getRowsOfNodes(nodes, 1, first_row, last_row);
+}
+
+void ZouHeNode::registerNodes
+(
+    nodeTypeField &types
+)
+{
+    for (auto &node : nodes)
+    {
+        types.addVelocity(node.x_node, node.y_node, node.u_node[0], node.u_node[1],
+                          is_normal_flow_);
+    }  // node
+}
+
 void ZouHeNode::updateEdge
 (
-    std::vector<std::vector<double>> &df,
+    latticeArray<double> &df,
     latticeNode &node
 )
 {
     const auto n = node.n_node;
-    const auto nx = lb_.getNumberOfNx();
+    const auto x = node.x_node;
+    const auto y = node.y_node;
     const auto c = lb_.getLatticeSpeed();
     switch(node.index_i)
     {
         case 0:
         {  // right
-            auto vel = is_normal_flow_ ? field_.u[n - 1] : node.u_node;
+            const auto *u_known = is_normal_flow_ ? field_.u[lb_.getNodeIndex(x - 1, y)] :
+                                                    node.u_node.data();
+            double vel[] = {u_known[0], u_known[1]};
             const auto rho_node = (df[n][0] + df[n][D2Q9_.N] + df[n][D2Q9_.S] + 2.0 * (df[n][D2Q9_.E] +
                                    df[n][D2Q9_.NE] + df[n][D2Q9_.SE])) / (1.0 + vel[0] / c);
             const auto df_diff = 0.5 * (df[n][D2Q9_.S] - df[n][D2Q9_.N]);
@@ -120,7 +145,9 @@ void ZouHeNode::updateEdge
         }
         case 1:
         {  // top
-            auto vel = is_normal_flow_ ? field_.u[n - nx] : node.u_node;
+            const auto *u_known = is_normal_flow_ ? field_.u[lb_.getNodeIndex(x, y - 1)] :
+                                                    node.u_node.data();
+            double vel[] = {u_known[0], u_known[1]};
             const auto rho_node = (df[n][0] + df[n][D2Q9_.E] + df[n][D2Q9_.W] + 2.0 * (df[n][D2Q9_.N] +
                                    df[n][D2Q9_.NE] + df[n][D2Q9_.NW])) / (1.0 + vel[1] / c);
             const auto df_diff = 0.5 * (df[n][D2Q9_.E] - df[n][D2Q9_.W]);
@@ -132,7 +159,9 @@ void ZouHeNode::updateEdge
         }
         case 2:
         {  // left
-            auto vel = is_normal_flow_ ? field_.u[n + 1] : node.u_node;
+            const auto *u_known = is_normal_flow_ ? field_.u[lb_.getNodeIndex(x + 1, y)] :
+                                                    node.u_node.data();
+            double vel[] = {u_known[0], u_known[1]};
             const auto rho_node = (df[n][0] + df[n][D2Q9_.N] + df[n][D2Q9_.S] + 2.0 * (df[n][D2Q9_.W] +
                                    df[n][D2Q9_.NW] + df[n][D2Q9_.SW])) / (1.0 - vel[0] / c);
             const auto df_diff = 0.5 * (df[n][D2Q9_.S] - df[n][D2Q9_.N]);
@@ -144,7 +173,9 @@ void ZouHeNode::updateEdge
         }
         case 3:
         {  // bottom
-            auto vel = is_normal_flow_ ? field_.u[n + nx] : node.u_node;
+            const auto *u_known = is_normal_flow_ ? field_.u[lb_.getNodeIndex(x, y + 1)] :
+                                                    node.u_node.data();
+            double vel[] = {u_known[0], u_known[1]};
             const auto rho_node = (df[n][0] + df[n][D2Q9_.E] + df[n][D2Q9_.W] + 2.0 * (df[n][D2Q9_.S] +
                                    df[n][D2Q9_.SW] + df[n][D2Q9_.SE])) / (1.0 - vel[1] / c);
             const auto df_diff = 0.5 * (df[n][D2Q9_.W] - df[n][D2Q9_.E]);
@@ -163,19 +194,21 @@ void ZouHeNode::updateEdge
 
 void ZouHeNode::updateCorner
 (
-    std::vector<std::vector<double>> &df,
+    latticeArray<double> &df,
     latticeNode &node
 )
 {
     const auto n = node.n_node;
-    auto vel = node.u_node;
-    const auto nx = lb_.getNumberOfNx();
+    double vel[] = {node.u_node[0], node.u_node[1]};
+    const auto x = node.x_node;
+    const auto y = node.y_node;
     const auto nc = lb_.getNumberOfDirections();
     switch (node.index_i)
     {
         case 0:
         {  // bottom-left
-            auto rho_node = 0.5 * (cb_.rho_[n + nx] + cb_.rho_[n + 1]);
+            auto rho_node = 0.5 * (cb_.rho_[lb_.getNodeIndex(x, y + 1)] +
+                                   cb_.rho_[lb_.getNodeIndex(x + 1, y)]);
             for (auto &u : vel) u *= rho_node;
             df[n][D2Q9_.E]  = df[n][D2Q9_.W] + 2.0 * beta1_ * vel[0];
             df[n][D2Q9_.N]  = df[n][D2Q9_.S] + 2.0 * beta1_ * vel[1];
@@ -188,7 +221,8 @@ void ZouHeNode::updateCorner
         }
         case 1:
         {  // bottom-right
-            auto rho_node = 0.5 * (cb_.rho_[n + nx] + cb_.rho_[n - 1]);
+            auto rho_node = 0.5 * (cb_.rho_[lb_.getNodeIndex(x, y + 1)] +
+                                   cb_.rho_[lb_.getNodeIndex(x - 1, y)]);
             for (auto &u : vel) u *= rho_node;
             df[n][D2Q9_.W]  = df[n][D2Q9_.E] - 2.0 * beta1_ * vel[0];
             df[n][D2Q9_.N]  = df[n][D2Q9_.S] + 2.0 * beta1_ * vel[1];
@@ -201,7 +235,8 @@ void ZouHeNode::updateCorner
         }
         case 2:
         {  // top-left
-            auto rho_node = 0.5 * (cb_.rho_[n - nx] + cb_.rho_[n + 1]);
+            auto rho_node = 0.5 * (cb_.rho_[lb_.getNodeIndex(x, y - 1)] +
+                                   cb_.rho_[lb_.getNodeIndex(x + 1, y)]);
             for (auto &u : vel) u *= rho_node;
             df[n][D2Q9_.E]  = df[n][D2Q9_.W] + 2.0 * beta1_ * vel[0];
             df[n][D2Q9_.S]  = df[n][D2Q9_.N] - 2.0 * beta1_ * vel[1];
@@ -214,7 +249,8 @@ void ZouHeNode::updateCorner
         }
         case 3:
         {  // top-right
-            auto rho_node = 0.5 * (cb_.rho_[n - nx] + cb_.rho_[n - 1]);
+            auto rho_node = 0.5 * (cb_.rho_[lb_.getNodeIndex(x, y - 1)] +
+                                   cb_.rho_[lb_.getNodeIndex(x - 1, y)]);
             for (auto &u : vel) u *= rho_node;
             df[n][D2Q9_.W]  = df[n][D2Q9_.E] - 2.0 * beta1_ * vel[0];
             df[n][D2Q9_.S]  = df[n][D2Q9_.N] - 2.0 * beta1_ * vel[1];
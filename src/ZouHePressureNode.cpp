@@ -0,0 +1,90 @@
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "ZouHePressureNode.hpp"
+#include "nodeTypeField.hpp"
+
+ZouHePressureNode::ZouHePressureNode
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: ZouHeNode(lb, cb, D2Q9, field),
+  D2Q9_ (D2Q9)
+{}
+
+void ZouHePressureNode::addNode
+(
+    std::size_t x,
+    std::size_t y,
+    double rho
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto left   = x == 0;
+    const auto right  = x == nx - 1;
+    const auto bottom = y == 0;
+    const auto top    = y == ny - 1;
+    if ((top || bottom) && (left || right))
+    {
+        throw std::runtime_error("Zou/He pressure nodes cannot be corner nodes");
+    }
+    auto edge_i = -1;
+    if (right)  edge_i = 0;
+    if (top)    edge_i = 1;
+    if (left)   edge_i = 2;
+    if (bottom) edge_i = 3;
+    if (edge_i < 0) throw std::runtime_error("Zou/He pressure nodes must lie on an edge");
+    nodes.push_back(latticeNode(x, y, lb_.getNodeIndex(x, y), rho, false, edge_i));
+    // the normal velocity is stored here every update for updateEdge()
+    nodes.back().u_node.assign(2, 0.0);
+}
+
+void ZouHePressureNode::updateNode
+(
+    latticeArray<double> &df,
+    bool is_modify_stream
+)
+{
+    if (is_modify_stream) return;
+    const auto c = lb_.getLatticeSpeed();
+    const auto nc = lb_.getNumberOfDirections();
+    for (auto &node : nodes)
+    {
+        const auto n = node.n_node;
+        // outward normal of the edge
+        const auto o_x = node.index_i == 0 ? 1.0 : (node.index_i == 2 ? -1.0 : 0.0);
+        const auto o_y = node.index_i == 1 ? 1.0 : (node.index_i == 3 ? -1.0 : 0.0);
+        // the distribution functions leaving the lattice are known, tangential
+        // ones count once and outgoing ones twice: known sum = rho * (1 + u_n / c)
+        auto known_sum = 0.0;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            const auto e_o = D2Q9_.e[i][0] * o_x + D2Q9_.e[i][1] * o_y;
+            if (e_o == 0.0) known_sum += df[n][i];
+            if (e_o > 0.0) known_sum += 2.0 * df[n][i];
+        }  // i
+        const auto u_normal = c * (known_sum / node.pressure_node - 1.0);
+        node.u_node[0] = u_normal * o_x;
+        node.u_node[1] = u_normal * o_y;
+        ZouHeNode::updateEdge(df, node);
+    }  // node
+}
+
+void ZouHePressureNode::registerNodes
+(
+    nodeTypeField &types
+)
+{
+    for (auto &node : nodes) types.addPressure(node.x_node, node.y_node, node.pressure_node);
+}
@@ -0,0 +1,118 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocationCounter.hpp"
+
+#ifdef COUNT_ALLOCATIONS
+
+namespace
+{
+    // Number of allocations since the start of the program. Starts as zero
+    // before any dynamic initialization, so allocations of static objects count
+    std::atomic<std::size_t> num_allocations {0};
+
+    // Allocates like the default operator new: retries through the new handler
+    // and throws std::bad_alloc if there is none
+    void* allocate(std::size_t num_bytes)
+    {
+        ++num_allocations;
+        if (num_bytes == 0) num_bytes = 1;
+        while (true)
+        {
+            auto *memory = std::malloc(num_bytes);
+            if (memory) return memory;
+            const auto handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+void* operator new(std::size_t num_bytes)
+{
+    return allocate(num_bytes);
+}
+
+void* operator new[](std::size_t num_bytes)
+{
+    return allocate(num_bytes);
+}
+
+void* operator new(std::size_t num_bytes, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocate(num_bytes);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t num_bytes, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return allocate(num_bytes);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+bool isAllocationCounted()
+{
+    return true;
+}
+
+std::size_t getNumberOfAllocations()
+{
+    return num_allocations;
+}
+
+#else
+
+bool isAllocationCounted()
+{
+    return false;
+}
+
+std::size_t getNumberOfAllocations()
+{
+    return 0;
+}
+
+#endif // COUNT_ALLOCATIONS
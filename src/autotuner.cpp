@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "nodeOrdering.hpp"
+#include "latticeBoltzmann.hpp"
+#include "autotuner.hpp"
+
+namespace
+{
+    // Number of timing windows of a candidate
+    const std::size_t num_windows = 5;
+
+    // Minimum number of node updates of a timing window
+    const std::size_t window_updates = 1u << 20;
+
+    // Exclusive lock on a file next to the tuning cache, held while the cache is
+    // read, merged and replaced so that hosts sharing the cache do not drop each
+    // other's entries. Released when the lock goes out of scope
+    class cacheLock
+    {
+        public:
+            // Constructor: Blocks until the lock is acquired, throws exception if
+            // the lock file cannot be opened or locked
+            // param lock_file name of the lock file, created if missing
+            explicit cacheLock
+            (
+                const std::string &lock_file
+            )
+            : fd_ {open(lock_file.c_str(), O_RDWR | O_CREAT, 0644)}
+            {
+                if (fd_ < 0) throw std::runtime_error("Error in opening " + lock_file);
+                if (flock(fd_, LOCK_EX) != 0)
+                {
+                    close(fd_);
+                    throw std::runtime_error("Error in locking " + lock_file);
+                }
+            }
+            // Destructor: releases the lock
+            ~cacheLock()
+            {
+                close(fd_);
+            }
+            cacheLock(const cacheLock&) = delete;
+            cacheLock& operator=(const cacheLock&) = delete;
+        private:
+            // File descriptor of the lock file
+            int fd_;
+    };
+
+    // Tile sizes tried for the tiled orders
+    const std::vector<std::size_t> tile_sizes = {16, 32, 64, 128};
+
+    // Margin by which a tiled order has to beat the row-major order, smaller
+    // differences are within the noise of a few steps
+    const double tiled_margin = 1.05;
+
+    // Replaces the separators of the cache file in a signature
+    std::string sanitize
+    (
+        std::string text
+    )
+    {
+        std::replace(text.begin(), text.end(), ',', ';');
+        std::replace(text.begin(), text.end(), ' ', '_');
+        return text;
+    }
+}
+
+autotuner::autotuner
+(
+    const std::string &cache_file
+)
+: cache_file_ {cache_file},
+  host_ {},
+  cache_ {},
+  is_cached_ {false}
+{
+    host_ = getHostSignature();
+    readCache();
+}
+
+autotuner::configuration autotuner::tune
+(
+    const std::string &problem,
+    std::size_t nx,
+    std::size_t ny,
+    const std::function<double(const configuration&)> &measure
+)
+{
+    const auto key = host_ + "," + sanitize(problem) + "," + std::to_string(nx) + "," +
+                     std::to_string(ny);
+    const auto entry = cache_.find(key);
+    is_cached_ = entry != cache_.end();
+    if (is_cached_) return entry->second;
+
+    auto best = configuration {nodeOrdering::ROW_MAJOR, 0, 0.0};
+    for (auto candidate : getCandidates(nx, ny))
+    {
+        candidate.mlups = measure(candidate);
+        std::cout << "autotune " << getOrderingName(candidate.ordering);
+        if (candidate.tile_size > 0) std::cout << " tile " << candidate.tile_size;
+        std::cout << ": " << candidate.mlups << " MLUPS" << std::endl;
+        const auto margin = best.ordering == nodeOrdering::ROW_MAJOR ? tiled_margin : 1.0;
+        if (candidate.mlups > margin * best.mlups) best = candidate;
+    }  // candidate
+    // other hosts may have added entries to a shared cache meanwhile. A cache
+    // which cannot be written only costs the measurement on the next run
+    try
+    {
+        cacheLock lock(cache_file_ + ".lock");
+        readCache();
+        cache_[key] = best;
+        writeCache();
+    }
+    catch (const std::runtime_error &e)
+    {
+        cache_[key] = best;
+        std::cerr << cache_file_ << ": " << e.what() << std::endl;
+    }
+    return best;
+}
+
+bool autotuner::isCached() const
+{
+    return is_cached_;
+}
+
+std::vector<autotuner::configuration> autotuner::getCandidates
+(
+    std::size_t nx,
+    std::size_t ny
+) const
+{
+    std::vector<configuration> candidates = {{nodeOrdering::ROW_MAJOR, 0, 0.0}};
+    for (auto ordering : {nodeOrdering::MORTON, nodeOrdering::HILBERT})
+    {
+        for (auto tile_size : tile_sizes)
+        {
+            // a single tile is stored row-wise anyway
+            if (tile_size < std::max(nx, ny)) candidates.push_back({ordering, tile_size, 0.0});
+        }  // tile_size
+    }  // ordering
+    return candidates;
+}
+
+double autotuner::measureMLUPS
+(
+    latticeBoltzmann &run,
+    std::size_t num_nodes
+)
+{
+    const auto window_steps = std::max(window_updates / num_nodes, std::size_t {1});
+    run.takeStep();
+    auto mlups = 0.0;
+    for (auto w = 0u; w < num_windows; ++w)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto t = 0u; t < window_steps; ++t) run.takeStep();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        mlups = std::max(mlups, num_nodes * window_steps / elapsed.count() / 1.0e6);
+    }  // w
+    return mlups;
+}
+
+std::string autotuner::getOrderingName
+(
+    nodeOrdering::e_orderings ordering
+)
+{
+    switch (ordering)
+    {
+        case nodeOrdering::MORTON:
+            return "MORTON";
+        case nodeOrdering::HILBERT:
+            return "HILBERT";
+        default:
+            return "ROW_MAJOR";
+    }
+}
+
+std::string autotuner::getHostSignature() const
+{
+    char host_name[256] = {};
+    gethostname(host_name, sizeof(host_name) - 1);
+    std::string cpu_model = "unknown";
+    std::ifstream cpu_info("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpu_info, line))
+    {
+        const auto colon = line.find(':');
+        if (line.compare(0, 10, "model name") == 0 && colon != std::string::npos)
+        {
+            cpu_model = line.substr(std::min(colon + 2, line.size()));
+            break;
+        }
+    }
+    return sanitize(std::string(host_name) + "/" + cpu_model + "/" +
+                    std::to_string(std::thread::hardware_concurrency()));
+}
+
+void autotuner::readCache()
+{
+    std::ifstream cache_file(cache_file_);
+    std::string line;
+    while (std::getline(cache_file, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        // the last three fields are the configuration, the others the key
+        auto end = line.size();
+        std::vector<std::string> fields;
+        for (auto i = 0u; i < 3 && end != std::string::npos; ++i)
+        {
+            const auto comma = line.find_last_of(',', end - 1);
+            if (comma == std::string::npos || comma == 0)
+            {
+                end = std::string::npos;
+                break;
+            }
+            fields.push_back(line.substr(comma + 1, end - comma - 1));
+            end = comma;
+        }  // i
+        if (end == std::string::npos) continue;
+        auto entry = configuration {nodeOrdering::ROW_MAJOR, 0, 0.0};
+        if (fields[2] == "MORTON") entry.ordering = nodeOrdering::MORTON;
+        if (fields[2] == "HILBERT") entry.ordering = nodeOrdering::HILBERT;
+        std::istringstream values(fields[1] + " " + fields[0]);
+        if (values >> entry.tile_size >> entry.mlups) cache_[line.substr(0, end)] = entry;
+    }
+}
+
+void autotuner::writeCache()
+{
+    // readers never see a partially written cache, the complete file replaces
+    // the cache in a single rename
+    std::string temp_name = cache_file_ + ".XXXXXX";
+    const auto fd = mkstemp(&temp_name[0]);
+    if (fd < 0) throw std::runtime_error("Error in creating a temporary file for " + cache_file_);
+    fchmod(fd, 0644);
+    close(fd);
+    std::ofstream cache_file;
+    cache_file.open(temp_name);
+    cache_file << "# host,problem,nx,ny,ordering,tile_size,MLUPS" << std::endl;
+    for (auto &entry : cache_)
+    {
+        cache_file << entry.first << "," << getOrderingName(entry.second.ordering) << ","
+                   << entry.second.tile_size << "," << entry.second.mlups << std::endl;
+    }
+    cache_file.close();
+    if (!cache_file)
+    {
+        std::remove(temp_name.c_str());
+        throw std::runtime_error("Error in writing " + temp_name);
+    }
+    if (std::rename(temp_name.c_str(), cache_file_.c_str()) != 0)
+    {
+        std::remove(temp_name.c_str());
+        throw std::runtime_error("Error in renaming " + temp_name);
+    }
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <utility>
 #include <vector>
 
 #include "latticeBase.hpp"
@@ -9,6 +10,7 @@
 
 #include "latticeNode.hxx"
 #include "boundaryNode.hxx"
+#include "nodeTypeField.hpp"
 
 #include "bouncebackNode.hpp"
 
@@ -20,8 +22,13 @@ bouncebackNode::bouncebackNode
     fluidField &field
 )
 : boundaryNode(true, true, lb),
+  force {},
   nodes {},
   cb_ {cb},
+  obstacle_ {},
+  links_ {},
+  is_force_ {false},
+  is_links_built_ {false},
   D2Q9_ (D2Q9),
   field_ (field)
 {}
@@ -34,8 +41,13 @@ bouncebackNode::bouncebackNode
     fluidField &field
 )
 : boundaryNode(true, true, lb),
+  force {},
   nodes {},
   sb_ {sb},
+  obstacle_ {},
+  links_ {},
+  is_force_ {false},
+  is_links_built_ {false},
   D2Q9_ (D2Q9),
   field_ (field)
 {}
@@ -46,12 +58,7 @@ void bouncebackNode::addNode
     std::size_t y
 )
 {
-    const auto nx = lb_.getNumberOfNx();
-    const auto n = y * nx + x;
-    nodes.push_back(latticeNode(x, y, n));
-    if (cb_) cb_->addNodeToSkip(n);
-    // add node position to position vector
-    position.push_back(n);
+    addObstacleNode(x, y, 0);
 }
 
 void bouncebackNode::addNode
@@ -61,31 +68,112 @@ void bouncebackNode::addNode
     std::size_t z
 )
 {
-    const auto nx = lb_.getNumberOfNx();
-    const auto n = y * nx + x;
+    const auto n = lb_.getNodeIndex(x, y);
     nodes.push_back(latticeNode(x, y, z, n));
+    // the copy of the distribution functions keeps its memory between steps
+    nodes.back().df_node.assign(lb_.getNumberOfDirections(), 0.0);
     if (cb_) cb_->addNodeToSkip(n);
     // add node position to position vector
     position.push_back(n);
+    obstacle_.push_back(0);
+    if (force.empty()) force.assign(1, std::vector<double>(lb_.getNumberOfDimensions(), 0.0));
+    is_links_built_ = false;
+}
+
+void bouncebackNode::addObstacleNode
+(
+    std::size_t x,
+    std::size_t y,
+    std::size_t obstacle_id
+)
+{
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto n = lb_.getNodeIndex(x, y);
+    nodes.push_back(latticeNode(x, y, n));
+    nodes.back().df_node.assign(lb_.getNumberOfDirections(), 0.0);
+    if (cb_) cb_->addNodeToSkip(n);
+    // add node position to position vector
+    position.push_back(n);
+    obstacle_.push_back(obstacle_id);
+    if (force.size() <= obstacle_id) force.resize(obstacle_id + 1, std::vector<double>(nd, 0.0));
+    is_links_built_ = false;
+}
+
+void bouncebackNode::toggleForceEvaluation()
+{
+    is_force_ = true;
+}
+
+void bouncebackNode::registerNodes
+(
+    nodeTypeField &types
+)
+{
+    for (auto &node : nodes)
+    {
+        if (cb_)
+        {
+            types.addBounceback(node.x_node, node.y_node);
+        }
+        else
+        {
+            types.addHalfwayBounceback(node.x_node, node.y_node);
+        }
+    }  // node
+}
+
+void bouncebackNode::buildLinks()
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    std::vector<bool> is_solid(nx * ny, false);
+    for (auto &node : nodes) is_solid[node.n_node] = true;
+    links_.assign(nodes.size(), 0u);
+    for (auto k = 0u; k < nodes.size(); ++k)
+    {
+        const long x = nodes[k].x_node;
+        const long y = nodes[k].y_node;
+        for (auto i = 1u; i < nc; ++i)
+        {
+            // upstream neighbour the distribution function has streamed in from
+            const long x_up = x - (D2Q9_.e[i][0] > 0.0) + (D2Q9_.e[i][0] < 0.0);
+            const long y_up = y - (D2Q9_.e[i][1] > 0.0) + (D2Q9_.e[i][1] < 0.0);
+            const auto is_on_lattice = x_up >= 0 && x_up < static_cast<long>(nx) &&
+                                       y_up >= 0 && y_up < static_cast<long>(ny);
+            if (is_on_lattice && !is_solid[lb_.getNodeIndex(x_up, y_up)]) links_[k] |= 1u << i;
+        }  // i
+    }  // k
+    is_links_built_ = true;
 }
 
 void bouncebackNode::updateNode
 (
-    std::vector<std::vector<double>> &df,
+    latticeArray<double> &df,
     bool is_modify_stream
 )
 {
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
     if (is_modify_stream)
     {
         const auto nx = lb_.getNumberOfNx();
         const auto ny = lb_.getNumberOfNy();
-        for (auto &node : nodes)
+        // half-way bounceback: the distribution functions leaving towards the wall
+        // come back reversed, each link transfers 2 * e_i * f_i to the wall
+        const auto is_half_way_force = is_force_ && sb_;
+        if (is_half_way_force)
         {
+            for (auto &f : force) f.assign(nd, 0.0);
+        }
+        for (auto k = 0u; k < nodes.size(); ++k)
+        {
+            auto &node = nodes[k];
             const auto n = node.n_node;
-            const auto left =   n % nx == 0;
-            const auto right =  n % nx == nx - 1;
-            const auto bottom = n / nx == 0;
-            const auto top =    n / nx == ny - 1;
+            const auto left =   node.x_node == 0;
+            const auto right =  node.x_node == nx - 1;
+            const auto bottom = node.y_node == 0;
+            const auto top =    node.y_node == ny - 1;
             if (bottom)          df[n][D2Q9_.N]  = node.df_node[D2Q9_.S];
             if (top)             df[n][D2Q9_.S]  = node.df_node[D2Q9_.N];
             if (left)            df[n][D2Q9_.E]  = node.df_node[D2Q9_.W];
@@ -94,30 +182,67 @@ void bouncebackNode::updateNode
             if (bottom || right) df[n][D2Q9_.NW] = node.df_node[D2Q9_.SE];
             if (top || right)    df[n][D2Q9_.SW] = node.df_node[D2Q9_.NE];
             if (top || left)     df[n][D2Q9_.SE] = node.df_node[D2Q9_.NW];
-        }  // node
+            if (is_half_way_force)
+            {
+                auto &f = force[obstacle_[k]];
+                for (auto i = 1u; i < nc; ++i)
+                {
+                    const auto is_wall_link = (bottom && D2Q9_.e[i][1] < 0.0) ||
+                                              (top    && D2Q9_.e[i][1] > 0.0) ||
+                                              (left   && D2Q9_.e[i][0] < 0.0) ||
+                                              (right  && D2Q9_.e[i][0] > 0.0);
+                    if (!is_wall_link) continue;
+                    for (auto d = 0u; d < nd; ++d) f[d] += 2.0 * D2Q9_.e[i][d] * node.df_node[i];
+                }  // i
+            }
+        }  // k
     }
     else
     {
         if (cb_)
         {
-            for (auto &node : nodes)
+            // full-way bounceback: every distribution function which has streamed
+            // in from a fluid node is reversed, transferring 2 * e_i * f_i
+            if (is_force_)
             {
+                if (!is_links_built_) buildLinks();
+                for (auto &f : force) f.assign(nd, 0.0);
+            }
+            for (auto k = 0u; k < nodes.size(); ++k)
+            {
+                auto &node = nodes[k];
                 const auto n = node.n_node;
-                auto temp_node = df[n];
-                df[n][D2Q9_.E]  = temp_node[D2Q9_.W];
-                df[n][D2Q9_.N]  = temp_node[D2Q9_.S];
-                df[n][D2Q9_.W]  = temp_node[D2Q9_.E];
-                df[n][D2Q9_.S]  = temp_node[D2Q9_.N];
-                df[n][D2Q9_.NE] = temp_node[D2Q9_.SW];
-                df[n][D2Q9_.NW] = temp_node[D2Q9_.SE];
-                df[n][D2Q9_.SW] = temp_node[D2Q9_.NE];
-                df[n][D2Q9_.SE] = temp_node[D2Q9_.NW];
-                node.df_node = df[n];
-            }  // node
+                if (is_force_ && links_[k])
+                {
+                    auto &f = force[obstacle_[k]];
+                    for (auto i = 1u; i < nc; ++i)
+                    {
+                        if (!(links_[k] & (1u << i))) continue;
+                        for (auto d = 0u; d < nd; ++d) f[d] += 2.0 * D2Q9_.e[i][d] * df[n][i];
+                    }  // i
+                }
+                std::swap(df[n][D2Q9_.E],  df[n][D2Q9_.W]);
+                std::swap(df[n][D2Q9_.N],  df[n][D2Q9_.S]);
+                std::swap(df[n][D2Q9_.NE], df[n][D2Q9_.SW]);
+                std::swap(df[n][D2Q9_.NW], df[n][D2Q9_.SE]);
+                node.df_node.assign(df[n], df[n] + nc);
+            }  // k
         }
         if (sb_)
         {
-            for (auto &node : nodes) node.df_node = df[node.n_node];
+            for (auto &node : nodes)
+            {
+                node.df_node.assign(df[node.n_node], df[node.n_node] + nc);
+            }  // node
         }
     }
 }
+
+void bouncebackNode::getRows
+(
+    std::size_t &first_row,
+    std::size_t &last_row
+) const
+{
+    getRowsOfNodes(nodes, 0, first_row, last_row);
+}
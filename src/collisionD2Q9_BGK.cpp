@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 
 #include "momentComputing.h"
@@ -57,60 +58,92 @@ collisionD2Q9_BGK::collisionD2Q9_BGK
 
 void collisionD2Q9_BGK::computefEq()
 {
-    auto nx = lb_.getNumberOfNx();
-    auto ny = lb_.getNumberOfNy();
+    auto nd = lb_.getNumberOfDimensions();
     auto nc = lb_.getNumberOfDirections();
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        double u_sqr = innerProduct(field_.u[n], field_.u[n]);
-        u_sqr /= 2.0 * cs_sqr_;
-        for (auto i = 0u; i < nc; ++i)
+        for (auto n = first; n < last; ++n)
         {
-            double c_dot_u = innerProduct(D2Q9_.e.at(i), field_.u[n]);
-            c_dot_u /= cs_sqr_;
-            eqdf[n][i] = D2Q9_.weight[i] * rho_[n] *
-                         (1.0 + c_dot_u * (1.0 + c_dot_u / 2.0) - u_sqr);
-        }  // i
-    }  // n
+            const auto u = field_.u[n];
+            double u_sqr = 0.0;
+            for (auto d = 0u; d < nd; ++d) u_sqr += u[d] * u[d];
+            u_sqr /= 2.0 * cs_sqr_;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                double c_dot_u = 0.0;
+                for (auto d = 0u; d < nd; ++d) c_dot_u += D2Q9_.e[i][d] * u[d];
+                c_dot_u /= cs_sqr_;
+                eqdf[n][i] = D2Q9_.weight[i] * rho_[n] *
+                             (1.0 + c_dot_u * (1.0 + c_dot_u / 2.0) - u_sqr);
+            }  // i
+        }  // n
+    });
 }
 
 std::vector<double> collisionD2Q9_BGK::computeRho
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
+    const auto nc = df.width();
     std::vector<double> rho_update(df.size(), 0.0);
-    auto it_rho = begin(rho_update);
-    for (auto it_df : df) (*it_rho++) = getZerothMoment(it_df);
+    for (auto n = 0u; n < df.size(); ++n)
+    {
+        for (auto i = 0u; i < nc; ++i) rho_update[n] += df[n][i];
+    }  // n
     return rho_update;
 }
 
-std::vector<std::vector<double>> collisionD2Q9_BGK::computeU
+latticeArray<double> collisionD2Q9_BGK::computeU
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
-    std::vector<std::vector<double>> rhou;
-    auto index = 0u;
-    for (auto it_df : df) rhou.push_back(getFirstMoment(it_df, D2Q9_.e)); //now is rho*u
-    for (auto &it_rhou : rhou)
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    latticeArray<double> rhou(df.size(), nd, 0.0);
+    for (auto n = 0u; n < df.size(); ++n)
     {
-        for (auto &it_u : it_rhou) it_u /= rho_[index]; //now is rho*u/rho
-        ++index;
-    }  // node
+        for (auto i = 0u; i < nc; ++i)
+        {
+            for (auto d = 0u; d < nd; ++d) rhou[n][d] += df[n][i] * D2Q9_.e[i][d]; //now is rho*u
+        }  // i
+        for (auto d = 0u; d < nd; ++d) rhou[n][d] /= rho_[n]; //now is rho*u/rho
+    }  // n
     return rhou; //now is only u
 }
 
 void collisionD2Q9_BGK::computeMacroscopicProperties
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
-    rho_ = computeRho(df);
-    auto rho = rho_;
-    for (auto &it_rho : rho) it_rho = cs_sqr_ * (it_rho - 1.0);  //now rho is pressure
-    field_.p = rho;
-    field_.u = computeU(df);
+    // density, pressure and velocity are written in place so that rho_, field_.p
+    // and field_.u keep their memory between time steps
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    forEachNodeRange([&](std::size_t first, std::size_t last)
+    {
+        for (auto n = first; n < last; ++n)
+        {
+            auto rho = 0.0;
+            auto u = field_.u[n];
+            for (auto d = 0u; d < nd; ++d) u[d] = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                rho += df[n][i];
+                for (auto d = 0u; d < nd; ++d) u[d] += df[n][i] * D2Q9_.e[i][d];
+            }  // i
+            for (auto d = 0u; d < nd; ++d) u[d] /= rho;
+            rho_[n] = rho;
+            field_.p[n] = cs_sqr_ * (rho - 1.0);  //now rho is pressure
+        }  // n
+    });
+}
+
+bool collisionD2Q9_BGK::isNodeRangeSupported() const
+{
+    return true;
 }
 
 void collisionD2Q9_BGK::addNodeToSkip(std::size_t n)
@@ -118,22 +151,40 @@ void collisionD2Q9_BGK::addNodeToSkip(std::size_t n)
   skip[n] = true;
 }
 
+bool collisionD2Q9_BGK::isNodeSkipped(std::size_t n) const
+{
+  return skip[n];
+}
+
+void collisionD2Q9_BGK::reset
+(
+    double kinematic_viscosity,
+    double initial_density
+)
+{
+    std::fill(rho_.begin(), rho_.end(), initial_density);
+    std::fill(skip.begin(), skip.end(), false);
+    const auto dt = lb_.getTimeStep();
+    tau_ = 0.5 + kinematic_viscosity / (cs_sqr_ * dt);
+}
+
 void collisionD2Q9_BGK::collide
 (
-    std::vector<std::vector<double>> &df_lattice
+    latticeArray<double> &df_lattice
 )
 {
-    const auto nx = lb_.getNumberOfNx();
-    const auto ny = lb_.getNumberOfNy();
     const auto nc = lb_.getNumberOfDirections();
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        if (!skip[n])
+        for (auto n = first; n < last; ++n)
         {
-            for (auto i = 0u; i < nc; ++i)
+            if (!skip[n])
             {
-                df_lattice[n][i] += (eqdf[n][i] - df_lattice[n][i]) / tau_;
-            }  // i
-        }
-    }  // n
+                for (auto i = 0u; i < nc; ++i)
+                {
+                    df_lattice[n][i] += (eqdf[n][i] - df_lattice[n][i]) / tau_;
+                }  // i
+            }
+        }  // n
+    });
 }
@@ -0,0 +1,243 @@
+#include <utility>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_BGK_ADE.hpp"
+
+namespace
+{
+    // Number of directions of the D2Q5 scalar
+    const std::size_t num_scalar_directions = 5;
+
+    // Weights of the D2Q5 scalar, cs^2 = c^2 / 3
+    const double scalar_weight[] = {1.0 / 3.0, 1.0 / 6.0, 1.0 / 6.0, 1.0 / 6.0, 1.0 / 6.0};
+
+    // Opposite directions of D2Q5
+    const std::size_t scalar_opposite[] = {0, 3, 4, 1, 2};
+
+    // Neighbour offsets of the D2Q5 directions in grid units
+    const int scalar_offset_x[] = {0, 1, 0, -1, 0};
+    const int scalar_offset_y[] = {0, 0, 1, 0, -1};
+}
+
+collisionD2Q9_BGK_ADE::collisionD2Q9_BGK_ADE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double diffusivity,
+    double initial_density,
+    const std::vector<double> &initial_scalar,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  tau_scalar_ {0.5 + diffusivity / (cs_sqr_ * lb.getTimeStep())},
+  buoyancy_ {0.0, 0.0},
+  reference_scalar_ {0},
+  edge_boundary_ (4, ADIABATIC),
+  edge_value_ (4, 0.0),
+  scalar_ {initial_scalar},
+  scalar_df_ {},
+  scalar_df_next_ {},
+  force_ {}
+{
+    initialize(initial_scalar);
+}
+
+collisionD2Q9_BGK_ADE::collisionD2Q9_BGK_ADE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double diffusivity,
+    const std::vector<double> &initial_density,
+    const std::vector<double> &initial_scalar,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  tau_scalar_ {0.5 + diffusivity / (cs_sqr_ * lb.getTimeStep())},
+  buoyancy_ {0.0, 0.0},
+  reference_scalar_ {0},
+  edge_boundary_ (4, ADIABATIC),
+  edge_value_ (4, 0.0),
+  scalar_ {initial_scalar},
+  scalar_df_ {},
+  scalar_df_next_ {},
+  force_ {}
+{
+    initialize(initial_scalar);
+}
+
+void collisionD2Q9_BGK_ADE::initialize
+(
+    const std::vector<double> &initial_scalar
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    scalar_df_.assign(nx * ny, num_scalar_directions, 0.0);
+    scalar_df_next_.assign(nx * ny, num_scalar_directions, 0.0);
+    force_.assign(nd, 0.0);
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        const auto u = field_.u[n];
+        for (auto i = 0u; i < num_scalar_directions; ++i)
+        {
+            auto c_dot_u = 0.0;
+            for (auto d = 0u; d < nd; ++d) c_dot_u += D2Q9_.e[i][d] * u[d];
+            scalar_df_[n][i] = scalar_weight[i] * initial_scalar[n] * (1.0 + c_dot_u / cs_sqr_);
+        }  // i
+    }  // n
+}
+
+void collisionD2Q9_BGK_ADE::setBuoyancy
+(
+    double b_x,
+    double b_y,
+    double reference_scalar
+)
+{
+    buoyancy_ = {b_x, b_y};
+    reference_scalar_ = reference_scalar;
+}
+
+void collisionD2Q9_BGK_ADE::setEdge
+(
+    e_edges edge,
+    e_scalar_boundaries boundary,
+    double value
+)
+{
+    edge_boundary_[edge] = boundary;
+    edge_value_[edge] = value;
+}
+
+void collisionD2Q9_BGK_ADE::computeMacroscopicProperties
+(
+    const latticeArray<double> &df
+)
+{
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    const auto dt = lb_.getTimeStep();
+    for (auto n = 0u; n < df.size(); ++n)
+    {
+        auto rho = 0.0;
+        auto u = field_.u[n];
+        for (auto d = 0u; d < nd; ++d) u[d] = 0.0;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            rho += df[n][i];
+            for (auto d = 0u; d < nd; ++d) u[d] += df[n][i] * D2Q9_.e[i][d];
+        }  // i
+        auto scalar = 0.0;
+        for (auto i = 0u; i < num_scalar_directions; ++i) scalar += scalar_df_[n][i];
+        const auto force_coeff = 0.5 * dt * rho * (scalar - reference_scalar_);
+        for (auto d = 0u; d < nd; ++d) u[d] = (u[d] + force_coeff * buoyancy_[d]) / rho;
+        rho_[n] = rho;
+        scalar_[n] = scalar;
+        field_.p[n] = cs_sqr_ * (rho - 1.0);
+    }  // n
+}
+
+void collisionD2Q9_BGK_ADE::collide
+(
+    latticeArray<double> &df_lattice
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto dt = lb_.getTimeStep();
+    const auto source_coeff = dt * (1.0 - 0.5 / tau_);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb_.getNodeIndex(x, y);
+            if (skip[n]) continue;
+            auto df = df_lattice[n];
+            const auto feq = eqdf[n];
+            const auto u = field_.u[n];
+            const auto scalar = scalar_[n];
+            auto u_dot_f = 0.0;
+            for (auto d = 0u; d < nd; ++d)
+            {
+                force_[d] = rho_[n] * (scalar - reference_scalar_) * buoyancy_[d];
+                u_dot_f += u[d] * force_[d];
+            }  // d
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto &e = D2Q9_.e[i];
+                auto c_dot_u = 0.0;
+                auto c_dot_f = 0.0;
+                for (auto d = 0u; d < nd; ++d)
+                {
+                    c_dot_u += e[d] * u[d];
+                    c_dot_f += e[d] * force_[d];
+                }  // d
+                const auto source = D2Q9_.weight[i] * ((c_dot_f - u_dot_f) / cs_sqr_ +
+                                                       c_dot_u * c_dot_f / (cs_sqr_ * cs_sqr_));
+                df[i] += (feq[i] - df[i]) / tau_ + source_coeff * source;
+            }  // i
+            // collide the scalar and push it to the neighbours, links which leave
+            // the lattice or end on a solid node are resolved at this node
+            for (auto i = 0u; i < num_scalar_directions; ++i)
+            {
+                auto c_dot_u = 0.0;
+                for (auto d = 0u; d < nd; ++d) c_dot_u += D2Q9_.e[i][d] * u[d];
+                const auto g_eq = scalar_weight[i] * scalar * (1.0 + c_dot_u / cs_sqr_);
+                const auto g = scalar_df_[n][i] - (scalar_df_[n][i] - g_eq) / tau_scalar_;
+                if (i == 0)
+                {
+                    scalar_df_next_[n][0] = g;
+                    continue;
+                }
+                auto x_nb = x + nx + scalar_offset_x[i];
+                auto y_nb = y + ny + scalar_offset_y[i];
+                auto edge = -1;
+                if (x_nb < nx) edge = LEFT;
+                if (x_nb >= 2 * nx) edge = RIGHT;
+                if (y_nb < ny) edge = BOTTOM;
+                if (y_nb >= 2 * ny) edge = TOP;
+                const auto opposite = scalar_opposite[i];
+                if (edge < 0 || edge_boundary_[edge] == PERIODIC)
+                {
+                    const auto n_nb = lb_.getNodeIndex(x_nb % nx, y_nb % ny);
+                    if (skip[n_nb])
+                    {
+                        scalar_df_next_[n][opposite] = g;
+                    }
+                    else
+                    {
+                        scalar_df_next_[n_nb][i] = g;
+                    }
+                }
+                else if (edge_boundary_[edge] == FIXED)
+                {
+                    // anti-bounceback sets the scalar on the wall half a node away
+                    scalar_df_next_[n][opposite] = -g + 2.0 * scalar_weight[i] * edge_value_[edge];
+                }
+                else
+                {
+                    scalar_df_next_[n][opposite] = g;
+                }
+            }  // i
+        }  // x
+    }  // y
+    std::swap(scalar_df_, scalar_df_next_);
+}
+
+const std::vector<double> &collisionD2Q9_BGK_ADE::getScalar() const
+{
+    return scalar_;
+}
+
+bool collisionD2Q9_BGK_ADE::isNodeRangeSupported() const
+{
+    return false;
+}
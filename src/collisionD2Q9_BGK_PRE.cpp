@@ -0,0 +1,66 @@
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_BGK_PRE.hpp"
+#include "preconditioning.hpp"
+
+// The viscosity of Guo2004 is nu = gamma * cs^2 * (tau - 0.5) * dt, so the base
+// class computes tau_ from nu / gamma
+
+collisionD2Q9_BGK_PRE::collisionD2Q9_BGK_PRE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double gamma,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity / checkPreconditioning(gamma), initial_density,
+                    D2Q9, field),
+  gamma_ {gamma}
+{}
+
+collisionD2Q9_BGK_PRE::collisionD2Q9_BGK_PRE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double gamma,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity / checkPreconditioning(gamma), initial_density,
+                    D2Q9, field),
+  gamma_ {gamma}
+{}
+
+void collisionD2Q9_BGK_PRE::computefEq()
+{
+    computePreconditionedfEq(lb_, D2Q9_, field_, rho_, gamma_, eqdf);
+}
+
+void collisionD2Q9_BGK_PRE::computeMacroscopicProperties
+(
+    const latticeArray<double> &df
+)
+{
+    collisionD2Q9_BGK::computeMacroscopicProperties(df);
+    for (auto &p : field_.p) p *= gamma_;
+}
+
+void collisionD2Q9_BGK_PRE::reset
+(
+    double kinematic_viscosity,
+    double initial_density
+)
+{
+    collisionD2Q9_BGK::reset(kinematic_viscosity / gamma_, initial_density);
+}
+
+bool collisionD2Q9_BGK_PRE::isNodeRangeSupported() const
+{
+    return false;
+}
@@ -0,0 +1,171 @@
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_CM.hpp"
+
+namespace
+{
+    // Exponents (p, q) of the moments sum f_i * e_ix^p * e_iy^q, in the order
+    // 00, 10, 01, 20, 02, 11, 21, 12, 22
+    const unsigned moment_px[] = {0, 1, 0, 2, 0, 1, 2, 1, 2};
+    const unsigned moment_py[] = {0, 0, 1, 0, 2, 1, 1, 2, 2};
+}
+
+collisionD2Q9_CM::collisionD2Q9_CM
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  mInv_ {}
+{
+    initialize();
+}
+
+collisionD2Q9_CM::collisionD2Q9_CM
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  mInv_ {}
+{
+    initialize();
+}
+
+void collisionD2Q9_CM::initialize()
+{
+    const auto nc = lb_.getNumberOfDirections();
+    // Raw moment matrix of the (scaled) lattice velocities, inverted once with
+    // Gauss-Jordan elimination
+    std::vector<std::vector<double>> m(nc, std::vector<double>(nc, 0.0));
+    mInv_.assign(nc, std::vector<double>(nc, 0.0));
+    for (auto k = 0u; k < nc; ++k)
+    {
+        for (auto i = 0u; i < nc; ++i)
+        {
+            m[k][i] = std::pow(D2Q9_.e[i][0], moment_px[k]) *
+                      std::pow(D2Q9_.e[i][1], moment_py[k]);
+        }  // i
+        mInv_[k][k] = 1.0;
+    }  // k
+    for (auto k = 0u; k < nc; ++k)
+    {
+        auto pivot = k;
+        for (auto r = k + 1; r < nc; ++r)
+        {
+            if (std::abs(m[r][k]) > std::abs(m[pivot][k])) pivot = r;
+        }  // r
+        if (std::abs(m[pivot][k]) < 1e-12)
+        {
+            throw std::runtime_error("Singular central moment transformation");
+        }
+        std::swap(m[k], m[pivot]);
+        std::swap(mInv_[k], mInv_[pivot]);
+        const auto diag = m[k][k];
+        for (auto i = 0u; i < nc; ++i)
+        {
+            m[k][i] /= diag;
+            mInv_[k][i] /= diag;
+        }  // i
+        for (auto r = 0u; r < nc; ++r)
+        {
+            if (r == k) continue;
+            const auto factor = m[r][k];
+            for (auto i = 0u; i < nc; ++i)
+            {
+                m[r][i] -= factor * m[k][i];
+                mInv_[r][i] -= factor * mInv_[k][i];
+            }  // i
+        }  // r
+    }  // k
+}
+
+void collisionD2Q9_CM::collide
+(
+    latticeArray<double> &df_lattice
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto omega = 1.0 / tau_;
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        if (!skip[n])
+        {
+            auto df = df_lattice[n];
+            // density and velocity of the incoming distribution functions, so that
+            // the first order central moments vanish exactly
+            auto rho = 0.0;
+            auto ux = 0.0;
+            auto uy = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                rho += df[i];
+                ux += df[i] * D2Q9_.e[i][0];
+                uy += df[i] * D2Q9_.e[i][1];
+            }  // i
+            ux /= rho;
+            uy /= rho;
+            // second and higher order central moments
+            auto k20 = 0.0;
+            auto k02 = 0.0;
+            auto k11 = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto cx = D2Q9_.e[i][0] - ux;
+                const auto cy = D2Q9_.e[i][1] - uy;
+                k20 += df[i] * cx * cx;
+                k02 += df[i] * cy * cy;
+                k11 += df[i] * cx * cy;
+            }  // i
+            // relax: the trace (bulk) goes to equilibrium, the deviatoric part and
+            // the shear stress with 1/tau, third and fourth order moments go to
+            // their equilibrium 0 and rho*cs^4
+            const auto trace = 2.0 * rho * cs_sqr_;
+            const auto deviator = (1.0 - omega) * (k20 - k02);
+            k20 = 0.5 * (trace + deviator);
+            k02 = 0.5 * (trace - deviator);
+            k11 *= 1.0 - omega;
+            const auto k22 = rho * cs_sqr_ * cs_sqr_;
+            // shift back to raw moments, all terms with the vanishing k10, k01,
+            // k21 and k12 are left out
+            const double m[] =
+            {
+                rho,
+                rho * ux,
+                rho * uy,
+                k20 + rho * ux * ux,
+                k02 + rho * uy * uy,
+                k11 + rho * ux * uy,
+                2.0 * ux * k11 + uy * k20 + rho * ux * ux * uy,
+                2.0 * uy * k11 + ux * k02 + rho * ux * uy * uy,
+                k22 + ux * ux * k02 + uy * uy * k20 + 4.0 * ux * uy * k11 +
+                    rho * ux * ux * uy * uy
+            };
+            for (auto i = 0u; i < nc; ++i)
+            {
+                auto f = 0.0;
+                for (auto k = 0u; k < nc; ++k) f += mInv_[i][k] * m[k];
+                df[i] = f;
+            }  // i
+        }
+    }  // n
+}
+
+bool collisionD2Q9_CM::isNodeRangeSupported() const
+{
+    return false;
+}
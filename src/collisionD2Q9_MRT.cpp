@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 
 #include "momentComputing.h"
@@ -33,6 +34,10 @@ collisionD2Q9_MRT::collisionD2Q9_MRT
     // the lattice Boltzmann method" Guo2002
     tau_ = 0.5 + kinematic_viscosity / (cs_sqr_ * dt);  //BGK
     auto nc = lb_.getNumberOfDirections();
+    // the moments are overwritten every step, sweeps over node ranges must not
+    // resize them
+    m_.assign(lat_size, nc, 0.0);
+    mEq_.assign(lat_size, nc, 0.0);
     s_.assign(nc, 0.0);
     s_[7] = 1.0 / tau_;
     s_[1] = 1.6;
@@ -69,6 +74,10 @@ collisionD2Q9_MRT::collisionD2Q9_MRT
     // the lattice Boltzmann method" Guo2002
     tau_ = 0.5 + kinematic_viscosity / (cs_sqr_ * dt);  //BGK
     auto nc = lb_.getNumberOfDirections();
+    // the moments are overwritten every step, sweeps over node ranges must not
+    // resize them
+    m_.assign(lat_size, nc, 0.0);
+    mEq_.assign(lat_size, nc, 0.0);
     s_.assign(nc, 0.0);
     s_[7] = 1.0 / tau_;
     s_[1] = 1.6;
@@ -80,104 +89,135 @@ collisionD2Q9_MRT::collisionD2Q9_MRT
 
 void collisionD2Q9_MRT::computefEq()
 {
-    auto nx = lb_.getNumberOfNx();
-    auto ny = lb_.getNumberOfNy();
+    auto nd = lb_.getNumberOfDimensions();
     auto nc = lb_.getNumberOfDirections();
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        double u_sqr = innerProduct(field_.u[n], field_.u[n]);
-        u_sqr /= 2.0 * cs_sqr_;
-        for (auto i = 0u; i < nc; ++i)
+        for (auto n = first; n < last; ++n)
         {
-            double c_dot_u = innerProduct(D2Q9_.e.at(i), field_.u[n]);
-            c_dot_u /= cs_sqr_;
-            eqdf[n][i] = D2Q9_.weight[i] * rho_[n] * (1.0 + c_dot_u * (1.0 + c_dot_u / 2.0) - u_sqr);
-        }  // i
-    }  // n
+            const auto u = field_.u[n];
+            double u_sqr = 0.0;
+            for (auto d = 0u; d < nd; ++d) u_sqr += u[d] * u[d];
+            u_sqr /= 2.0 * cs_sqr_;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                double c_dot_u = 0.0;
+                for (auto d = 0u; d < nd; ++d) c_dot_u += D2Q9_.e[i][d] * u[d];
+                c_dot_u /= cs_sqr_;
+                eqdf[n][i] = D2Q9_.weight[i] * rho_[n] *
+                             (1.0 + c_dot_u * (1.0 + c_dot_u / 2.0) - u_sqr);
+            }  // i
+        }  // n
+    });
 }
 
 void collisionD2Q9_MRT::computemEq()
 {
-    const auto nx = lb_.getNumberOfNx();
-    const auto ny = lb_.getNumberOfNy();
-    auto nc = lb_.getNumberOfDirections();
-    const auto lat_size = nx * ny;
-    mEq_.assign(lat_size, std::vector<double>(nc, 0.0));
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        double jx = rho_[n] * field_.u[n][0];
-        double jy = rho_[n] * field_.u[n][1];
-
-        mEq_[n][0] = rho_[n];
-        mEq_[n][1] = -2.0 * rho_[n] + 3.0 * (jx * jx + jy * jy);
-        mEq_[n][2] = rho_[n] - 3.0 * (jx * jx + jy * jy);
-        mEq_[n][3] = jx;
-        mEq_[n][4] = -jx;
-        mEq_[n][5] = jy;
-        mEq_[n][6] = -jy;
-        mEq_[n][7] = (jx * jx - jy * jy);
-        mEq_[n][8] = jx * jy;
-    }  // n
+        for (auto n = first; n < last; ++n)
+        {
+            double jx = rho_[n] * field_.u[n][0];
+            double jy = rho_[n] * field_.u[n][1];
+
+            mEq_[n][0] = rho_[n];
+            mEq_[n][1] = -2.0 * rho_[n] + 3.0 * (jx * jx + jy * jy);
+            mEq_[n][2] = rho_[n] - 3.0 * (jx * jx + jy * jy);
+            mEq_[n][3] = jx;
+            mEq_[n][4] = -jx;
+            mEq_[n][5] = jy;
+            mEq_[n][6] = -jy;
+            mEq_[n][7] = (jx * jx - jy * jy);
+            mEq_[n][8] = jx * jy;
+        }  // n
+    });
 }
 
 void collisionD2Q9_MRT::computeM
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
-    auto nx = lb_.getNumberOfNx();
-    auto ny = lb_.getNumberOfNy();
     auto nc = lb_.getNumberOfDirections();
-    const auto lat_size = nx * ny;
-    m_.assign(lat_size, std::vector<double>(nc, 0.0));
     computemEq();
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        m_.at(n) = MVmultiplyProduct(D2Q9_.M, df.at(n));
-        for (auto i = 0u; i < nc; ++i)
+        for (auto n = first; n < last; ++n)
         {
-            m_[n][i] += s_[i] * (mEq_[n][i] - m_[n][i]);
-        }
-    }  // n
+            for (auto i = 0u; i < nc; ++i)
+            {
+                m_[n][i] = 0.0;
+                for (auto j = 0u; j < nc; ++j) m_[n][i] += D2Q9_.M[i][j] * df[n][j];
+                m_[n][i] += s_[i] * (mEq_[n][i] - m_[n][i]);
+            }
+        }  // n
+    });
 }
 
 std::vector<double> collisionD2Q9_MRT::computeRho
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
+    const auto nc = df.width();
     std::vector<double> rho_update(df.size(), 0.0);
-    auto it_rho = begin(rho_update);
-    for (auto it_df : df) (*it_rho++) = getZerothMoment(it_df);
+    for (auto n = 0u; n < df.size(); ++n)
+    {
+        for (auto i = 0u; i < nc; ++i) rho_update[n] += df[n][i];
+    }  // n
     return rho_update;
 }
 
-std::vector<std::vector<double>> collisionD2Q9_MRT::computeU
+latticeArray<double> collisionD2Q9_MRT::computeU
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
-    std::vector<std::vector<double>> rhou;
-    auto index = 0u;
-    for (auto it_df : df) rhou.push_back(getFirstMoment(it_df, D2Q9_.e)); //now is rho*u
-    for (auto &it_rhou : rhou)
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    latticeArray<double> rhou(df.size(), nd, 0.0);
+    for (auto n = 0u; n < df.size(); ++n)
     {
-        for (auto &it_u : it_rhou) it_u /= rho_[index]; //now is rho*u/rho
-        ++index;
-    }  // node
+        for (auto i = 0u; i < nc; ++i)
+        {
+            for (auto d = 0u; d < nd; ++d) rhou[n][d] += df[n][i] * D2Q9_.e[i][d]; //now is rho*u
+        }  // i
+        for (auto d = 0u; d < nd; ++d) rhou[n][d] /= rho_[n]; //now is rho*u/rho
+    }  // n
     return rhou; //now is only u
 }
 
 void collisionD2Q9_MRT::computeMacroscopicProperties
 (
-    const std::vector<std::vector<double>> &df
+    const latticeArray<double> &df
 )
 {
-    rho_ = computeRho(df);
-    auto rho = rho_;
-    for (auto &it_rho : rho) it_rho = cs_sqr_ * (it_rho - 1.0);  //now rho is pressure
-    field_.p = rho;
-    field_.u = computeU(df);
+    // density, pressure and velocity are written in place so that rho_, field_.p
+    // and field_.u keep their memory between time steps
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    forEachNodeRange([&](std::size_t first, std::size_t last)
+    {
+        for (auto n = first; n < last; ++n)
+        {
+            auto rho = 0.0;
+            auto u = field_.u[n];
+            for (auto d = 0u; d < nd; ++d) u[d] = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                rho += df[n][i];
+                for (auto d = 0u; d < nd; ++d) u[d] += df[n][i] * D2Q9_.e[i][d];
+            }  // i
+            for (auto d = 0u; d < nd; ++d) u[d] /= rho;
+            rho_[n] = rho;
+            field_.p[n] = cs_sqr_ * (rho - 1.0);  //now rho is pressure
+        }  // n
+    });
+}
+
+bool collisionD2Q9_MRT::isNodeRangeSupported() const
+{
+    return true;
 }
 
 void collisionD2Q9_MRT::addNodeToSkip(std::size_t n)
@@ -185,22 +225,48 @@ void collisionD2Q9_MRT::addNodeToSkip(std::size_t n)
   skip[n] = true;
 }
 
+bool collisionD2Q9_MRT::isNodeSkipped(std::size_t n) const
+{
+  return skip[n];
+}
+
+void collisionD2Q9_MRT::reset
+(
+    double kinematic_viscosity,
+    double initial_density
+)
+{
+    std::fill(rho_.begin(), rho_.end(), initial_density);
+    std::fill(skip.begin(), skip.end(), false);
+    const auto dt = lb_.getTimeStep();
+    tau_ = 0.5 + kinematic_viscosity / (cs_sqr_ * dt);
+    s_[7] = 1.0 / tau_;
+    s_[4] = 8.0*(2.0-s_[7])/(8.0-s_[7]);
+    s_[6] = s_[4];
+    s_[8] = s_[7];
+}
+
 void collisionD2Q9_MRT::collide
 (
-    std::vector<std::vector<double>> &df_lattice
+    latticeArray<double> &df_lattice
 )
 {
-    const auto nx = lb_.getNumberOfNx();
-    const auto ny = lb_.getNumberOfNy();
     auto nc = lb_.getNumberOfDirections();
 
     computeM(df_lattice);
 
-    for (auto n = 0u; n < nx * ny; ++n)
+    forEachNodeRange([&](std::size_t first, std::size_t last)
     {
-        if (!skip[n])
+        for (auto n = first; n < last; ++n)
         {
-            df_lattice.at(n) = MVmultiplyProduct(D2Q9_.Minv, m_.at(n));
-        }
-    }  // n
+            if (!skip[n])
+            {
+                for (auto i = 0u; i < nc; ++i)
+                {
+                    df_lattice[n][i] = 0.0;
+                    for (auto j = 0u; j < nc; ++j) df_lattice[n][i] += D2Q9_.Minv[i][j] * m_[n][j];
+                }  // i
+            }
+        }  // n
+    });
 }
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_MRT_LES.hpp"
+
+collisionD2Q9_MRT_LES::collisionD2Q9_MRT_LES
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double smagorinsky_constant,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_MRT(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  les_coeff_ {0}
+{
+    const auto dl = lb_.getSpaceStep();
+    const auto dt = lb_.getTimeStep();
+    const auto cs_dl = smagorinsky_constant * dl;
+    les_coeff_ = 2.0 * cs_dl * cs_dl / (cs_sqr_ * cs_sqr_ * dt * dt);
+}
+
+collisionD2Q9_MRT_LES::collisionD2Q9_MRT_LES
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double smagorinsky_constant,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_MRT(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  les_coeff_ {0}
+{
+    const auto dl = lb_.getSpaceStep();
+    const auto dt = lb_.getTimeStep();
+    const auto cs_dl = smagorinsky_constant * dl;
+    les_coeff_ = 2.0 * cs_dl * cs_dl / (cs_sqr_ * cs_sqr_ * dt * dt);
+}
+
+void collisionD2Q9_MRT_LES::collide
+(
+    latticeArray<double> &df_lattice
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    computemEq();
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        if (!skip[n])
+        {
+            auto df = df_lattice[n];
+            const auto feq = eqdf[n];
+            auto m = m_[n];
+            // non-equilibrium momentum flux Pi_xx, Pi_yy and Pi_xy
+            auto pi_xx = 0.0;
+            auto pi_yy = 0.0;
+            auto pi_xy = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto fneq = df[i] - feq[i];
+                const auto &e = D2Q9_.e[i];
+                pi_xx += e[0] * e[0] * fneq;
+                pi_yy += e[1] * e[1] * fneq;
+                pi_xy += e[0] * e[1] * fneq;
+            }  // i
+            // tau = tau_ + 3 * nu_t / (c^2 * dt) with nu_t = (C_s * dl)^2 * |S| and
+            // |S| proportional to |Pi| / tau, solved for the positive root
+            const auto pi_norm = std::sqrt(2.0 * (pi_xx * pi_xx + pi_yy * pi_yy +
+                                                  2.0 * pi_xy * pi_xy));
+            const auto tau = 0.5 * (tau_ + std::sqrt(tau_ * tau_ +
+                                                     les_coeff_ * pi_norm / rho_[n]));
+            for (auto i = 0u; i < nc; ++i)
+            {
+                m[i] = 0.0;
+                for (auto j = 0u; j < nc; ++j) m[i] += D2Q9_.M[i][j] * df[j];
+                // moments 7 and 8 are the stresses p_xx and p_xy
+                const auto s = (i == 7 || i == 8) ? 1.0 / tau : s_[i];
+                m[i] += s * (mEq_[n][i] - m[i]);
+            }  // i
+            for (auto i = 0u; i < nc; ++i)
+            {
+                df[i] = 0.0;
+                for (auto j = 0u; j < nc; ++j) df[i] += D2Q9_.Minv[i][j] * m[j];
+            }  // i
+        }
+    }  // n
+}
+
+bool collisionD2Q9_MRT_LES::isNodeRangeSupported() const
+{
+    return false;
+}
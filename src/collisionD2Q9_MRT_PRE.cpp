@@ -0,0 +1,87 @@
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_MRT_PRE.hpp"
+#include "preconditioning.hpp"
+
+// The viscosity of Guo2004 is nu = gamma * cs^2 * (1 / s_nu - 0.5) * dt, so the
+// base class computes the stress relaxation rates from nu / gamma
+
+collisionD2Q9_MRT_PRE::collisionD2Q9_MRT_PRE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double gamma,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_MRT(lb, kinematic_viscosity / checkPreconditioning(gamma), initial_density,
+                    D2Q9, field),
+  gamma_ {gamma}
+{}
+
+collisionD2Q9_MRT_PRE::collisionD2Q9_MRT_PRE
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double gamma,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_MRT(lb, kinematic_viscosity / checkPreconditioning(gamma), initial_density,
+                    D2Q9, field),
+  gamma_ {gamma}
+{}
+
+void collisionD2Q9_MRT_PRE::computefEq()
+{
+    computePreconditionedfEq(lb_, D2Q9_, field_, rho_, gamma_, eqdf);
+}
+
+void collisionD2Q9_MRT_PRE::computemEq()
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        const auto jx = rho_[n] * field_.u[n][0];
+        const auto jy = rho_[n] * field_.u[n][1];
+
+        mEq_[n][0] = rho_[n];
+        mEq_[n][1] = -2.0 * rho_[n] + 3.0 * (jx * jx + jy * jy) / gamma_;
+        mEq_[n][2] = rho_[n] - 3.0 * (jx * jx + jy * jy) / gamma_;
+        mEq_[n][3] = jx;
+        mEq_[n][4] = -jx;
+        mEq_[n][5] = jy;
+        mEq_[n][6] = -jy;
+        mEq_[n][7] = (jx * jx - jy * jy) / gamma_;
+        mEq_[n][8] = jx * jy / gamma_;
+    }  // n
+}
+
+void collisionD2Q9_MRT_PRE::computeMacroscopicProperties
+(
+    const latticeArray<double> &df
+)
+{
+    collisionD2Q9_MRT::computeMacroscopicProperties(df);
+    for (auto &p : field_.p) p *= gamma_;
+}
+
+void collisionD2Q9_MRT_PRE::reset
+(
+    double kinematic_viscosity,
+    double initial_density
+)
+{
+    collisionD2Q9_MRT::reset(kinematic_viscosity / gamma_, initial_density);
+}
+
+bool collisionD2Q9_MRT_PRE::isNodeRangeSupported() const
+{
+    return false;
+}
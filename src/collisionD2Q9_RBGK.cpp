@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_RBGK.hpp"
+
+collisionD2Q9_RBGK::collisionD2Q9_RBGK
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field)
+{}
+
+collisionD2Q9_RBGK::collisionD2Q9_RBGK
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field)
+{}
+
+void collisionD2Q9_RBGK::collide
+(
+    latticeArray<double> &df_lattice
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto omega = 1.0 - 1.0 / tau_;
+    const auto cs_4 = 2.0 * cs_sqr_ * cs_sqr_;
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        if (!skip[n])
+        {
+            auto df = df_lattice[n];
+            const auto feq = eqdf[n];
+            // non-equilibrium momentum flux Pi_xx, Pi_yy and Pi_xy
+            auto pi_xx = 0.0;
+            auto pi_yy = 0.0;
+            auto pi_xy = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto fneq = df[i] - feq[i];
+                const auto &e = D2Q9_.e[i];
+                pi_xx += e[0] * e[0] * fneq;
+                pi_yy += e[1] * e[1] * fneq;
+                pi_xy += e[0] * e[1] * fneq;
+            }  // i
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto &e = D2Q9_.e[i];
+                const auto q_pi = (e[0] * e[0] - cs_sqr_) * pi_xx +
+                                  (e[1] * e[1] - cs_sqr_) * pi_yy +
+                                  2.0 * e[0] * e[1] * pi_xy;
+                df[i] = feq[i] + omega * D2Q9_.weight[i] * q_pi / cs_4;
+            }  // i
+        }
+    }  // n
+}
+
+bool collisionD2Q9_RBGK::isNodeRangeSupported() const
+{
+    return false;
+}
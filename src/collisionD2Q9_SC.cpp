@@ -0,0 +1,248 @@
+#include <cmath>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionD2Q9_SC.hpp"
+
+collisionD2Q9_SC::collisionD2Q9_SC
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double interaction_strength,
+    double wall_density,
+    double initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  G_ {interaction_strength},
+  psi_wall_ {getPseudopotential(wall_density)},
+  is_periodic_x_ {false},
+  is_periodic_y_ {false},
+  is_force_current_ {false},
+  offset_x_ {},
+  offset_y_ {},
+  psi_ {},
+  force_ {}
+{
+    initialize();
+}
+
+collisionD2Q9_SC::collisionD2Q9_SC
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    double interaction_strength,
+    double wall_density,
+    const std::vector<double> &initial_density,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: collisionD2Q9_BGK(lb, kinematic_viscosity, initial_density, D2Q9, field),
+  G_ {interaction_strength},
+  psi_wall_ {getPseudopotential(wall_density)},
+  is_periodic_x_ {false},
+  is_periodic_y_ {false},
+  is_force_current_ {false},
+  offset_x_ {},
+  offset_y_ {},
+  psi_ {},
+  force_ {}
+{
+    initialize();
+}
+
+void collisionD2Q9_SC::initialize()
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto c = lb_.getLatticeSpeed();
+    for (auto i = 0u; i < nc; ++i)
+    {
+        offset_x_.push_back(static_cast<int>(std::lround(D2Q9_.e[i][0] / c)));
+        offset_y_.push_back(static_cast<int>(std::lround(D2Q9_.e[i][1] / c)));
+    }  // i
+    psi_.assign(nx * ny, 0.0);
+    force_.assign(nx * ny, nd, 0.0);
+}
+
+void collisionD2Q9_SC::setPeriodic
+(
+    bool is_periodic_x,
+    bool is_periodic_y
+)
+{
+    is_periodic_x_ = is_periodic_x;
+    is_periodic_y_ = is_periodic_y;
+    is_force_current_ = false;
+}
+
+void collisionD2Q9_SC::computeMacroscopicProperties
+(
+    const latticeArray<double> &df
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = df.width();
+    const auto dt = lb_.getTimeStep();
+    // adds half of the force to the momentum stored in field_.u of a row whose
+    // force is known
+    auto finishRow = [&](std::size_t y)
+    {
+        computeForceRow(y);
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb_.getNodeIndex(x, y);
+            auto u = field_.u[n];
+            for (auto d = 0u; d < nd; ++d) u[d] = (u[d] + 0.5 * dt * force_[n][d]) / rho_[n];
+        }  // x
+    };
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb_.getNodeIndex(x, y);
+            auto rho = 0.0;
+            auto u = field_.u[n];
+            for (auto d = 0u; d < nd; ++d) u[d] = 0.0;
+            for (auto i = 0u; i < nc; ++i)
+            {
+                rho += df[n][i];
+                for (auto d = 0u; d < nd; ++d) u[d] += df[n][i] * D2Q9_.e[i][d];
+            }  // i
+            rho_[n] = rho;
+            const auto psi = getPseudopotential(rho);
+            psi_[n] = skip[n] ? psi_wall_ : psi;
+            // Shan-Chen equation of state p = cs^2 * rho + G * cs^2 / 2 * psi^2
+            field_.p[n] = cs_sqr_ * (rho - 1.0 + 0.5 * G_ * psi * psi);
+        }  // x
+        if (y >= 2) finishRow(y - 1);
+    }  // y
+    // the first and last rows may need the pseudopotential of the opposite edge
+    finishRow(0);
+    if (ny > 1) finishRow(ny - 1);
+    is_force_current_ = true;
+}
+
+void collisionD2Q9_SC::addNodeToSkip
+(
+    std::size_t n
+)
+{
+    skip[n] = true;
+    psi_[n] = psi_wall_;
+    is_force_current_ = false;
+}
+
+void collisionD2Q9_SC::collide
+(
+    latticeArray<double> &df_lattice
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto dt = lb_.getTimeStep();
+    // the initial density and newly added solid nodes have no force yet
+    if (!is_force_current_)
+    {
+        for (auto n = 0u; n < nx * ny; ++n)
+        {
+            psi_[n] = skip[n] ? psi_wall_ : getPseudopotential(rho_[n]);
+        }  // n
+        for (auto y = 0u; y < ny; ++y) computeForceRow(y);
+        is_force_current_ = true;
+    }
+    const auto source_coeff = dt * (1.0 - 0.5 / tau_);
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        if (!skip[n])
+        {
+            auto df = df_lattice[n];
+            const auto feq = eqdf[n];
+            const auto u = field_.u[n];
+            const auto force = force_[n];
+            auto u_dot_f = 0.0;
+            for (auto d = 0u; d < nd; ++d) u_dot_f += u[d] * force[d];
+            for (auto i = 0u; i < nc; ++i)
+            {
+                const auto &e = D2Q9_.e[i];
+                auto c_dot_u = 0.0;
+                auto c_dot_f = 0.0;
+                for (auto d = 0u; d < nd; ++d)
+                {
+                    c_dot_u += e[d] * u[d];
+                    c_dot_f += e[d] * force[d];
+                }  // d
+                const auto source = D2Q9_.weight[i] * ((c_dot_f - u_dot_f) / cs_sqr_ +
+                                                       c_dot_u * c_dot_f / (cs_sqr_ * cs_sqr_));
+                df[i] += (feq[i] - df[i]) / tau_ + source_coeff * source;
+            }  // i
+        }
+    }  // n
+}
+
+const latticeArray<double> &collisionD2Q9_SC::getForce() const
+{
+    return force_;
+}
+
+double collisionD2Q9_SC::getPseudopotential
+(
+    double rho
+) const
+{
+    return 1.0 - std::exp(-rho);
+}
+
+void collisionD2Q9_SC::computeForceRow
+(
+    std::size_t y
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    // pseudopotential of the neighbour at (x + dx, y + dy), dx and dy in -1, 0, 1
+    auto getNeighbour = [&](std::size_t x, int dx, int dy)
+    {
+        auto x_nb = x + nx + dx;
+        auto y_nb = y + ny + dy;
+        if (x_nb < nx || x_nb >= 2 * nx)
+        {
+            if (!is_periodic_x_) return psi_wall_;
+        }
+        if (y_nb < ny || y_nb >= 2 * ny)
+        {
+            if (!is_periodic_y_) return psi_wall_;
+        }
+        return psi_[lb_.getNodeIndex(x_nb % nx, y_nb % ny)];
+    };
+    for (auto x = 0u; x < nx; ++x)
+    {
+        const auto n = lb_.getNodeIndex(x, y);
+        auto force = force_[n];
+        for (auto d = 0u; d < nd; ++d) force[d] = 0.0;
+        if (skip[n]) continue;
+        for (auto i = 1u; i < nc; ++i)
+        {
+            const auto &e = D2Q9_.e[i];
+            const auto psi = D2Q9_.weight[i] * getNeighbour(x, offset_x_[i], offset_y_[i]);
+            for (auto d = 0u; d < nd; ++d) force[d] += psi * e[d];
+        }  // i
+        for (auto d = 0u; d < nd; ++d) force[d] *= -G_ * psi_[n];
+    }  // x
+}
+
+bool collisionD2Q9_SC::isNodeRangeSupported() const
+{
+    return false;
+}
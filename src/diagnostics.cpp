@@ -0,0 +1,299 @@
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "bouncebackNode.hpp"
+#include "diagnostics.hpp"
+
+diagnostics::diagnostics
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    fluidField &field,
+    const std::string &file_name,
+    std::size_t interval
+)
+: values {},
+  lb_ (lb),
+  cb_ (cb),
+  field_ (field),
+  interval_ {interval},
+  probes_ {},
+  lines_ {},
+  integrals_ {},
+  walls_ {},
+  forces_ {},
+  file_ {},
+  is_header_written_ {false}
+{
+    if (interval_ == 0) throw std::runtime_error("Diagnostics interval must be positive");
+    file_.open(file_name);
+    if (!file_) throw std::runtime_error("Error in opening " + file_name);
+}
+
+void diagnostics::addProbe
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (x >= nx || y >= ny) throw std::runtime_error("Probe outside of lattice");
+    probes_.push_back(lb_.getNodeIndex(x, y));
+}
+
+void diagnostics::addLineSample
+(
+    bool is_vertical,
+    std::size_t position
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (position >= (is_vertical ? nx : ny)) throw std::runtime_error("Line sample outside of lattice");
+    lines_.push_back(std::make_pair(is_vertical, position));
+}
+
+void diagnostics::addIntegral
+(
+    e_integrals quantity
+)
+{
+    integrals_.push_back(quantity);
+}
+
+void diagnostics::addWallShear
+(
+    e_walls wall,
+    double kinematic_viscosity
+)
+{
+    walls_.push_back(std::make_pair(wall, kinematic_viscosity));
+}
+
+void diagnostics::addForce
+(
+    bouncebackNode &bb,
+    std::size_t obstacle_id
+)
+{
+    if (obstacle_id >= bb.force.size()) throw std::runtime_error("Not an obstacle");
+    bb.toggleForceEvaluation();
+    forces_.push_back(std::make_pair(&bb, obstacle_id));
+}
+
+void diagnostics::writeHeader()
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    file_ << "time";
+    for (auto n : probes_)
+    {
+        const auto &ordering = lb_.getNodeOrdering();
+        const auto tag = std::to_string(ordering.getX(n)) + "_" + std::to_string(ordering.getY(n));
+        file_ << ",p_" << tag << ",ux_" << tag << ",uy_" << tag;
+    }  // n
+    for (auto &line : lines_)
+    {
+        const auto length = line.first ? ny : nx;
+        for (auto i = 0u; i < length; ++i)
+        {
+            // a vertical line records the tangential velocity u_x and vice versa
+            if (line.first) file_ << ",ux_" << line.second << "_" << i;
+            else            file_ << ",uy_" << i << "_" << line.second;
+        }  // i
+    }  // line
+    const char *integral_names[] = {"mass", "kinetic_energy", "enstrophy"};
+    for (auto quantity : integrals_) file_ << "," << integral_names[quantity];
+    const char *wall_names[] = {"right", "top", "left", "bottom"};
+    for (auto &wall : walls_) file_ << ",wall_shear_" << wall_names[wall.first];
+    for (auto &obstacle : forces_)
+    {
+        file_ << ",fx_" << obstacle.second << ",fy_" << obstacle.second;
+    }  // obstacle
+    file_ << "\n";
+    is_header_written_ = true;
+}
+
+double diagnostics::computeIntegral
+(
+    e_integrals quantity
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const long lat_size = nx * ny;
+    const auto &rho = cb_.rho_;
+    const auto &u = field_.u;
+    auto sum = 0.0;
+    switch (quantity)
+    {
+        case MASS:
+        {
+            #pragma omp parallel for reduction(+:sum)
+            for (long n = 0; n < lat_size; ++n)
+            {
+                if (!cb_.isNodeSkipped(n)) sum += rho[n];
+            }  // n
+            break;
+        }
+        case KINETIC_ENERGY:
+        {
+            #pragma omp parallel for reduction(+:sum)
+            for (long n = 0; n < lat_size; ++n)
+            {
+                if (cb_.isNodeSkipped(n)) continue;
+                sum += 0.5 * rho[n] * (u[n][0] * u[n][0] + u[n][1] * u[n][1]);
+            }  // n
+            break;
+        }
+        case ENSTROPHY:
+        {
+            // vorticity from central differences, interior fluid nodes only. A
+            // solid neighbour is a wall at rest
+            const auto velocity = [&](long x, long y, std::size_t d)
+            {
+                const auto n = lb_.getNodeIndex(x, y);
+                return cb_.isNodeSkipped(n) ? 0.0 : u[n][d];
+            };
+            const long inner_nx = nx - 1;
+            const long inner_ny = ny - 1;
+            #pragma omp parallel for reduction(+:sum)
+            for (long y = 1; y < inner_ny; ++y)
+            {
+                for (long x = 1; x < inner_nx; ++x)
+                {
+                    if (cb_.isNodeSkipped(lb_.getNodeIndex(x, y))) continue;
+                    const auto omega = 0.5 * (velocity(x + 1, y, 1) - velocity(x - 1, y, 1)) -
+                                       0.5 * (velocity(x, y + 1, 0) - velocity(x, y - 1, 0));
+                    sum += 0.5 * omega * omega;
+                }  // x
+            }  // y
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Not an integral");
+        }
+    }
+    return sum;
+}
+
+double diagnostics::computeWallShear
+(
+    e_walls wall,
+    double kinematic_viscosity
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto &rho = cb_.rho_;
+    const auto &u = field_.u;
+    // first wall node, inward normal, tangential velocity component, step
+    // between two wall nodes and wall length
+    long first_x = 0;
+    long first_y = 0;
+    long normal_x = 0;
+    long normal_y = 0;
+    std::size_t tangent = 0;
+    long step_x = 0;
+    long step_y = 0;
+    long length = 0;
+    switch (wall)
+    {
+        case RIGHT:
+        {
+            first_x = nx - 1;
+            normal_x = -1;
+            tangent = 1;
+            step_y = 1;
+            length = ny;
+            break;
+        }
+        case TOP:
+        {
+            first_y = ny - 1;
+            normal_y = -1;
+            tangent = 0;
+            step_x = 1;
+            length = nx;
+            break;
+        }
+        case LEFT:
+        {
+            normal_x = 1;
+            tangent = 1;
+            step_y = 1;
+            length = ny;
+            break;
+        }
+        case BOTTOM:
+        {
+            normal_y = 1;
+            tangent = 0;
+            step_x = 1;
+            length = nx;
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Not a wall");
+        }
+    }
+    auto sum = 0.0;
+    #pragma omp parallel for reduction(+:sum)
+    for (long i = 0; i < length; ++i)
+    {
+        const auto x = first_x + i * step_x;
+        const auto y = first_y + i * step_y;
+        const auto n = lb_.getNodeIndex(x, y);
+        const auto m = lb_.getNodeIndex(x + normal_x, y + normal_y);
+        sum += rho[n] * kinematic_viscosity * (u[m][tangent] - u[n][tangent]);
+    }  // i
+    return sum / length;
+}
+
+void diagnostics::evaluate
+(
+    std::size_t time
+)
+{
+    if (time % interval_ != 0) return;
+    if (!is_header_written_) writeHeader();
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    values.clear();
+    for (auto n : probes_)
+    {
+        values.push_back(field_.p.empty() ? 0.0 : field_.p[n]);
+        values.push_back(field_.u[n][0]);
+        values.push_back(field_.u[n][1]);
+    }  // n
+    for (auto &line : lines_)
+    {
+        if (line.first)
+        {
+            for (auto y = 0u; y < ny; ++y) values.push_back(field_.u[lb_.getNodeIndex(line.second, y)][0]);
+        }
+        else
+        {
+            for (auto x = 0u; x < nx; ++x) values.push_back(field_.u[lb_.getNodeIndex(x, line.second)][1]);
+        }
+    }  // line
+    for (auto quantity : integrals_) values.push_back(computeIntegral(quantity));
+    for (auto &wall : walls_) values.push_back(computeWallShear(wall.first, wall.second));
+    for (auto &obstacle : forces_)
+    {
+        for (auto f : obstacle.first->force[obstacle.second]) values.push_back(f);
+    }  // obstacle
+    file_ << time;
+    for (auto value : values) file_ << "," << value;
+    file_ << "\n";
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "flowStatistics.hpp"
+
+namespace
+{
+    // Number of moments of a node
+    const std::size_t num_moments = 7;
+}
+
+flowStatistics::flowStatistics
+(
+    latticeBase &lb,
+    fluidField &field,
+    std::size_t first_step,
+    std::size_t stride
+)
+: lb_ (lb),
+  field_ (field),
+  first_step_ {first_step},
+  stride_ {stride},
+  num_samples_ {0},
+  moments_ {}
+{
+    if (stride_ == 0) throw std::runtime_error("Sampling stride must be positive");
+    moments_.assign(lb_.getNumberOfNx() * lb_.getNumberOfNy(), num_moments, 0.0);
+}
+
+bool flowStatistics::isSampled
+(
+    std::size_t time
+) const
+{
+    return time >= first_step_ && (time - first_step_) % stride_ == 0;
+}
+
+void flowStatistics::sample
+(
+    std::size_t time
+)
+{
+    if (!isSampled(time)) return;
+    startSample();
+    const long num_nodes = moments_.size();
+    // blocks of nodes keep the parallel loop cheap for the few arithmetic
+    // operations of a node
+    const long block_size = 1024;
+    #pragma omp parallel for schedule(static)
+    for (long first = 0; first < num_nodes; first += block_size)
+    {
+        sampleNodes(first, std::min(first + block_size, num_nodes));
+    }  // first
+}
+
+void flowStatistics::startSample()
+{
+    ++num_samples_;
+}
+
+void flowStatistics::sampleNodes
+(
+    std::size_t first_node,
+    std::size_t last_node
+)
+{
+    const auto inv_samples = 1.0 / num_samples_;
+    const auto is_pressure = !field_.p.empty();
+    for (auto n = first_node; n < last_node; ++n)
+    {
+        auto *moment = moments_[n];
+        const auto p = is_pressure ? field_.p[n] : 0.0;
+        const auto u_x = field_.u[n][0];
+        const auto u_y = field_.u[n][1];
+        // deviations from the old means times deviations from the new means
+        // accumulate the sums of squares without cancellation
+        const auto dp = p - moment[MEAN_PRESSURE];
+        const auto du_x = u_x - moment[MEAN_VELOCITY_X];
+        const auto du_y = u_y - moment[MEAN_VELOCITY_Y];
+        moment[MEAN_PRESSURE] += dp * inv_samples;
+        moment[MEAN_VELOCITY_X] += du_x * inv_samples;
+        moment[MEAN_VELOCITY_Y] += du_y * inv_samples;
+        moment[PRESSURE_VARIANCE] += dp * (p - moment[MEAN_PRESSURE]);
+        moment[REYNOLDS_STRESS_XX] += du_x * (u_x - moment[MEAN_VELOCITY_X]);
+        moment[REYNOLDS_STRESS_YY] += du_y * (u_y - moment[MEAN_VELOCITY_Y]);
+        moment[REYNOLDS_STRESS_XY] += du_x * (u_y - moment[MEAN_VELOCITY_Y]);
+    }  // n
+}
+
+void flowStatistics::reset()
+{
+    num_samples_ = 0;
+    moments_.assign(moments_.size(), num_moments, 0.0);
+}
+
+std::size_t flowStatistics::getNumberOfSamples() const
+{
+    return num_samples_;
+}
+
+double flowStatistics::getValue
+(
+    std::size_t n,
+    e_quantities quantity
+) const
+{
+    if (num_samples_ == 0) return 0.0;
+    const auto value = moments_[n][quantity];
+    return quantity < PRESSURE_VARIANCE ? value : value / num_samples_;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+#include "latticeArray.hxx"
+#include "momentComputing.h"
+
+#include "latticeBase.hpp"
+#include "latticeD2Q9.hpp"
+#include "streamD2Q9.hpp"
+#include "nodeTypeField.hpp"
+#include "latticeBoltzmann.hpp"
+#include "gridSequencing.hpp"
+
+gridSequencing::gridSequencing
+(
+    latticeBase &lb,
+    double kinematic_viscosity,
+    std::size_t num_levels,
+    double tolerance,
+    std::size_t check_interval,
+    std::size_t max_steps
+)
+: lb_ (lb),
+  kinematic_viscosity_ {kinematic_viscosity},
+  num_levels_ {num_levels},
+  tolerance_ {tolerance},
+  check_interval_ {check_interval},
+  max_steps_ {max_steps}
+{
+    if (num_levels_ == 0) throw std::runtime_error("Grid sequencing needs at least one level");
+    if (check_interval_ == 0) throw std::runtime_error("Steady state check interval must be positive");
+    const auto factor = std::size_t {1} << (num_levels_ - 1);
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (nx % factor != 0 || ny % factor != 0 || nx / factor < 2 || ny / factor < 2)
+    {
+        throw std::runtime_error("Lattice size not divisible into the coarse levels");
+    }
+}
+
+std::size_t gridSequencing::initialize
+(
+    latticeBoltzmann &run,
+    collisionBase &cb,
+    fluidField &field
+)
+{
+    const auto nc = lb_.getNumberOfDirections();
+    auto num_steps = std::size_t {0};
+    levelSolution coarse {0, 0, 0.0, {}, {}, {}};
+    for (auto level = num_levels_ - 1; level > 0; --level)
+    {
+        const auto factor = std::size_t {1} << level;
+        const auto nx = lb_.getNumberOfNx() / factor;
+        const auto ny = lb_.getNumberOfNy() / factor;
+        const auto visco = kinematic_viscosity_ / factor;
+        const auto tau = getRelaxationTime(visco);
+        fluidField level_field(nx, ny, {0.0, 0.0});
+        latticeModelD2Q9 D2Q9;
+        latticeD2Q9 lattice(nx, ny, lb_.getSpaceStep(), lb_.getTimeStep(), D2Q9);
+        auto collision = makeCollision(lattice, visco, D2Q9, level_field);
+        nodeTypeField types(lattice, *collision, D2Q9, level_field);
+        streamD2Q9 stream(lattice, D2Q9, types);
+        addBoundaries(lattice, *collision, D2Q9, level_field, types);
+        latticeBoltzmann level_run(lattice, *collision, stream);
+        if (coarse.nx > 0)
+        {
+            prolongate(coarse, lattice, tau, level_run.getDistributionFunctions(), *collision,
+                       level_field);
+        }
+
+        auto u_prev = level_field.u;
+        for (auto t = std::size_t {0}; t < max_steps_; t += check_interval_)
+        {
+            for (auto i = 0u; i < check_interval_; ++i) level_run.takeStep();
+            num_steps += check_interval_;
+            if (checkSteadyState(u_prev, level_field.u, tolerance_)) break;
+            u_prev = level_field.u;
+        }  // t
+
+        // keep the converged solution row-wise, the equilibrium of the final
+        // macroscopic properties splits off the non-equilibrium part
+        collision->computefEq();
+        const auto &df = level_run.getDistributionFunctions();
+        coarse.nx = nx;
+        coarse.ny = ny;
+        coarse.tau = tau;
+        coarse.rho.assign(nx * ny, 0.0);
+        coarse.u.assign(nx * ny, level_field.u.width(), 0.0);
+        coarse.fneq.assign(nx * ny, nc, 0.0);
+        for (auto y = 0u; y < ny; ++y)
+        {
+            for (auto x = 0u; x < nx; ++x)
+            {
+                const auto n = lattice.getNodeIndex(x, y);
+                const auto k = y * nx + x;
+                coarse.rho[k] = collision->rho_[n];
+                for (auto d = 0u; d < coarse.u.width(); ++d) coarse.u[k][d] = level_field.u[n][d];
+                for (auto i = 0u; i < nc; ++i) coarse.fneq[k][i] = df[n][i] - collision->eqdf[n][i];
+            }  // x
+        }  // y
+    }  // level
+    if (coarse.nx > 0)
+    {
+        prolongate(coarse, lb_, getRelaxationTime(kinematic_viscosity_),
+                   run.getDistributionFunctions(), cb, field);
+    }
+    return num_steps;
+}
+
+double gridSequencing::getRelaxationTime
+(
+    double kinematic_viscosity
+) const
+{
+    const auto c = lb_.getLatticeSpeed();
+    const auto cs_sqr = c * c / 3.0;
+    return 0.5 + kinematic_viscosity / (cs_sqr * lb_.getTimeStep());
+}
+
+void gridSequencing::prolongate
+(
+    const levelSolution &coarse,
+    latticeBase &lb,
+    double tau,
+    latticeArray<double> &df,
+    collisionBase &cb,
+    fluidField &field
+)
+{
+    const auto nx = lb.getNumberOfNx();
+    const auto ny = lb.getNumberOfNy();
+    const auto nc = lb.getNumberOfDirections();
+    // nodes are cell centres, fine node x lies at (x + 0.5) / 2 - 0.5 on the coarse
+    // lattice and is clamped to the coarse edge nodes
+    std::vector<std::size_t> x0(nx);
+    std::vector<double> wx(nx);
+    for (auto x = 0u; x < nx; ++x)
+    {
+        const auto x_c = std::min(std::max(0.5 * x - 0.25, 0.0), coarse.nx - 1.0);
+        x0[x] = std::min(static_cast<std::size_t>(x_c), coarse.nx - 2);
+        wx[x] = x_c - x0[x];
+    }  // x
+    std::vector<std::size_t> y0(ny);
+    std::vector<double> wy(ny);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        const auto y_c = std::min(std::max(0.5 * y - 0.25, 0.0), coarse.ny - 1.0);
+        y0[y] = std::min(static_cast<std::size_t>(y_c), coarse.ny - 2);
+        wy[y] = y_c - y0[y];
+    }  // y
+    auto interpolate = [&](const double *values, std::size_t width, std::size_t x, std::size_t y)
+    {
+        const auto k = y0[y] * coarse.nx + x0[x];
+        const auto k_up = k + coarse.nx;
+        return (1.0 - wy[y]) * ((1.0 - wx[x]) * values[k * width] + wx[x] * values[(k + 1) * width]) +
+               wy[y] * ((1.0 - wx[x]) * values[k_up * width] + wx[x] * values[(k_up + 1) * width]);
+    };
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb.getNodeIndex(x, y);
+            cb.rho_[n] = interpolate(coarse.rho.data(), 1, x, y);
+            for (auto d = 0u; d < coarse.u.width(); ++d)
+            {
+                field.u[n][d] = interpolate(coarse.u.data() + d, coarse.u.width(), x, y);
+            }  // d
+        }  // x
+    }  // y
+    // with the lattice velocity fixed, gradients in lattice units halve with every
+    // refinement and f_neq ~ -tau * w_i * rho * Q_i : grad u / cs^2
+    const auto scale = tau / (2.0 * coarse.tau);
+    cb.computefEq();
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb.getNodeIndex(x, y);
+            for (auto i = 0u; i < nc; ++i)
+            {
+                df[n][i] = cb.eqdf[n][i] + scale * interpolate(coarse.fneq.data() + i, nc, x, y);
+            }  // i
+        }  // x
+    }  // y
+}
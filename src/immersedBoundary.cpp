@@ -0,0 +1,266 @@
+#include <cmath>
+#include <vector>
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "immersedBoundary.hpp"
+
+immersedBoundary::immersedBoundary
+(
+    latticeBase &lb,
+    latticeModelD2Q9 &D2Q9,
+    double centre_x,
+    double centre_y,
+    std::size_t num_iterations
+)
+: boundaryNode(false, false, lb),
+  markers {},
+  centre_x_ {centre_x},
+  centre_y_ {centre_y},
+  u_x_ {0},
+  u_y_ {0},
+  angle_ {0},
+  angular_velocity_ {0},
+  time_ {0},
+  D2Q9_ (D2Q9),
+  num_iterations_ {num_iterations},
+  support_index_ {},
+  support_nodes_ {},
+  support_rho_ {},
+  support_u_ {},
+  support_du_ {},
+  stencil_nodes_ {},
+  stencil_weights_ {}
+{
+    const auto num_nodes = lb_.getNumberOfNx() * lb_.getNumberOfNy();
+    support_index_.assign(num_nodes, num_nodes);
+}
+
+void immersedBoundary::addMarker
+(
+    double x,
+    double y,
+    double length
+)
+{
+    // reference position at zero rotation angle
+    const auto dx = x - centre_x_;
+    const auto dy = y - centre_y_;
+    const auto cos_a = std::cos(angle_);
+    const auto sin_a = std::sin(angle_);
+    const auto x_ref = cos_a * dx + sin_a * dy;
+    const auto y_ref = -sin_a * dx + cos_a * dy;
+    markers.push_back({x, y, u_x_ - angular_velocity_ * dy, u_y_ + angular_velocity_ * dx,
+                       x_ref, y_ref, length, 0.0, 0.0});
+}
+
+void immersedBoundary::setMotion
+(
+    double u_x,
+    double u_y,
+    double angular_velocity
+)
+{
+    u_x_ = u_x;
+    u_y_ = u_y;
+    angular_velocity_ = angular_velocity;
+}
+
+void immersedBoundary::moveMarkers
+(
+    double time
+)
+{
+    const auto dt = time - time_;
+    centre_x_ += u_x_ * dt;
+    centre_y_ += u_y_ * dt;
+    angle_ += angular_velocity_ * dt;
+    time_ = time;
+    const auto cos_a = std::cos(angle_);
+    const auto sin_a = std::sin(angle_);
+    for (auto &m : markers)
+    {
+        const auto dx = cos_a * m.x_ref - sin_a * m.y_ref;
+        const auto dy = sin_a * m.x_ref + cos_a * m.y_ref;
+        m.x = centre_x_ + dx;
+        m.y = centre_y_ + dy;
+        m.u_x = u_x_ - angular_velocity_ * dy;
+        m.u_y = u_y_ + angular_velocity_ * dx;
+    }  // m
+}
+
+void immersedBoundary::updateNode
+(
+    latticeArray<double> &df,
+    bool
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto dt = lb_.getTimeStep();
+    const auto dl = lb_.getSpaceStep();
+    const auto c = lb_.getLatticeSpeed();
+    const auto cs_sqr = c * c / 3.0;
+    const auto num_nodes = nx * ny;
+    const auto num_markers = markers.size();
+    moveMarkers(time_ + dt);
+
+    // collect the 3 x 3 stencil of each marker, nodes shared by several markers
+    // are stored once
+    support_nodes_.clear();
+    stencil_nodes_.resize(9 * num_markers);
+    stencil_weights_.resize(9 * num_markers);
+    for (auto m = 0u; m < num_markers; ++m)
+    {
+        const auto x_m = markers[m].x;
+        const auto y_m = markers[m].y;
+        const auto x_0 = static_cast<long>(std::lround(x_m)) - 1;
+        const auto y_0 = static_cast<long>(std::lround(y_m)) - 1;
+        for (auto j = 0u; j < 3; ++j)
+        {
+            const auto y = y_0 + j;
+            const auto w_y = getKernel(y - y_m);
+            const auto y_wrap = static_cast<std::size_t>((y % static_cast<long>(ny) + ny) % ny);
+            for (auto i = 0u; i < 3; ++i)
+            {
+                const auto x = x_0 + i;
+                const auto x_wrap = static_cast<std::size_t>((x % static_cast<long>(nx) + nx) % nx);
+                const auto n = lb_.getNodeIndex(x_wrap, y_wrap);
+                if (support_index_[n] == num_nodes)
+                {
+                    support_index_[n] = support_nodes_.size();
+                    support_nodes_.push_back(n);
+                }
+                stencil_nodes_[9 * m + 3 * j + i] = support_index_[n];
+                stencil_weights_[9 * m + 3 * j + i] = getKernel(x - x_m) * w_y;
+            }  // i
+        }  // j
+    }  // m
+
+    // density and velocity of the streamed distribution functions
+    const auto num_support = support_nodes_.size();
+    support_rho_.assign(num_support, 0.0);
+    support_u_.assign(num_support, nd, 0.0);
+    support_du_.assign(num_support, nd, 0.0);
+    for (auto k = 0u; k < num_support; ++k)
+    {
+        const auto n = support_nodes_[k];
+        auto rho = 0.0;
+        auto u = support_u_[k];
+        for (auto i = 0u; i < nc; ++i)
+        {
+            rho += df[n][i];
+            for (auto d = 0u; d < nd; ++d) u[d] += df[n][i] * D2Q9_.e[i][d];
+        }  // i
+        for (auto d = 0u; d < nd; ++d) u[d] /= rho;
+        support_rho_[k] = rho;
+    }  // k
+
+    // multi-direct forcing, each pass corrects the velocity by the remaining
+    // difference at the markers
+    for (auto &m : markers)
+    {
+        m.f_x = 0.0;
+        m.f_y = 0.0;
+    }  // m
+    const auto force_scale = dl * dl / dt;
+    for (auto iteration = 0u; iteration < num_iterations_; ++iteration)
+    {
+        for (auto m = 0u; m < num_markers; ++m)
+        {
+            const auto *nodes = &stencil_nodes_[9 * m];
+            const auto *weights = &stencil_weights_[9 * m];
+            auto rho = 0.0;
+            auto u_x = 0.0;
+            auto u_y = 0.0;
+            for (auto s = 0u; s < 9; ++s)
+            {
+                rho += weights[s] * support_rho_[nodes[s]];
+                u_x += weights[s] * support_u_[nodes[s]][0];
+                u_y += weights[s] * support_u_[nodes[s]][1];
+            }  // s
+            const auto du_x = (markers[m].u_x - u_x) * markers[m].length;
+            const auto du_y = (markers[m].u_y - u_y) * markers[m].length;
+            for (auto s = 0u; s < 9; ++s)
+            {
+                support_du_[nodes[s]][0] += weights[s] * du_x;
+                support_du_[nodes[s]][1] += weights[s] * du_y;
+                support_u_[nodes[s]][0] += weights[s] * du_x;
+                support_u_[nodes[s]][1] += weights[s] * du_y;
+            }  // s
+            markers[m].f_x -= rho * du_x * force_scale;
+            markers[m].f_y -= rho * du_y * force_scale;
+        }  // m
+    }  // iteration
+
+    // exact difference method, f_i += f_eq(rho, u + du) - f_eq(rho, u), then the
+    // support is released for the next step
+    for (auto k = 0u; k < num_support; ++k)
+    {
+        const auto n = support_nodes_[k];
+        const auto rho = support_rho_[k];
+        const auto u_new = support_u_[k];
+        const auto du = support_du_[k];
+        auto u_sqr_old = 0.0;
+        auto u_sqr_new = 0.0;
+        for (auto d = 0u; d < nd; ++d)
+        {
+            u_sqr_old += (u_new[d] - du[d]) * (u_new[d] - du[d]);
+            u_sqr_new += u_new[d] * u_new[d];
+        }  // d
+        for (auto i = 0u; i < nc; ++i)
+        {
+            auto c_dot_u_old = 0.0;
+            auto c_dot_u_new = 0.0;
+            for (auto d = 0u; d < nd; ++d)
+            {
+                c_dot_u_old += D2Q9_.e[i][d] * (u_new[d] - du[d]);
+                c_dot_u_new += D2Q9_.e[i][d] * u_new[d];
+            }  // d
+            df[n][i] += D2Q9_.weight[i] * rho *
+                        ((c_dot_u_new - c_dot_u_old) / cs_sqr +
+                         (c_dot_u_new * c_dot_u_new - c_dot_u_old * c_dot_u_old) /
+                         (2.0 * cs_sqr * cs_sqr) - (u_sqr_new - u_sqr_old) / (2.0 * cs_sqr));
+        }  // i
+        support_index_[n] = num_nodes;
+    }  // k
+}
+
+std::vector<double> immersedBoundary::getForce() const
+{
+    std::vector<double> force = {0.0, 0.0};
+    for (const auto &m : markers)
+    {
+        force[0] += m.f_x;
+        force[1] += m.f_y;
+    }  // m
+    return force;
+}
+
+double immersedBoundary::getTorque() const
+{
+    auto torque = 0.0;
+    for (const auto &m : markers)
+    {
+        torque += (m.x - centre_x_) * m.f_y - (m.y - centre_y_) * m.f_x;
+    }  // m
+    return torque;
+}
+
+double immersedBoundary::getKernel
+(
+    double r
+) const
+{
+    const auto r_abs = std::fabs(r);
+    if (r_abs <= 0.5) return (1.0 + std::sqrt(1.0 - 3.0 * r_abs * r_abs)) / 3.0;
+    if (r_abs <= 1.5)
+    {
+        return (5.0 - 3.0 * r_abs - std::sqrt(1.0 - 3.0 * (1.0 - r_abs) * (1.0 - r_abs))) / 6.0;
+    }
+    return 0.0;
+}
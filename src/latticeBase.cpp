@@ -14,7 +14,28 @@ latticeBase::latticeBase
   number_of_dimensions_ {num_dims},
   number_of_directions_ {num_dirs},
   space_step_ {dl},
-  time_step_ {dt}
+  time_step_ {dt},
+  ordering_ (nx, ny)
+{}
+
+latticeBase::latticeBase
+(
+    std::size_t nx,
+    std::size_t ny,
+    std::size_t num_dims,
+    std::size_t num_dirs,
+    double dl,
+    double dt,
+    nodeOrdering::e_orderings ordering,
+    std::size_t tile_size
+)
+: number_of_nx_ {nx},
+  number_of_ny_ {ny},
+  number_of_dimensions_ {num_dims},
+  number_of_directions_ {num_dirs},
+  space_step_ {dl},
+  time_step_ {dt},
+  ordering_ (nx, ny, ordering, tile_size)
 {}
 
 latticeBase::latticeBase
@@ -33,7 +54,8 @@ latticeBase::latticeBase
   number_of_dimensions_ {num_dims},
   number_of_directions_ {num_dirs},
   space_step_ {dl},
-  time_step_ {dt}
+  time_step_ {dt},
+  ordering_ (nx, ny)
 {}
 
 std::size_t latticeBase::getNumberOfNx() const
@@ -76,6 +98,11 @@ double latticeBase::getLatticeSpeed() const
     return c_;
 }
 
+const nodeOrdering& latticeBase::getNodeOrdering() const
+{
+    return ordering_;
+}
+
 bool latticeBase::checkInput()
 {
     return number_of_dimensions_ == 0 || number_of_directions_ == 0 ||
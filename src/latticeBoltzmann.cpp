@@ -1,12 +1,20 @@
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>  // std::runtime_error
+#include <string>
 #include <vector>
 
+#include <unistd.h>
+
 #include "latticeBoltzmann.hpp"
 #include "latticeBase.hpp"
 #include "collisionBase.hxx"
 #include "streamBase.hxx"
 #include "boundaryNode.hxx"
+#include "diagnostics.hpp"
+#include "flowStatistics.hpp"
+#include "tracerParticles.hpp"
+#include "stepScheduler.hpp"
 
 latticeBoltzmann::latticeBoltzmann
 (
@@ -18,7 +26,15 @@ latticeBoltzmann::latticeBoltzmann
   cb_ (cb),
   sb_ (sb),
   df {},
-  bn_ {}
+  bn_ {},
+  dg_ {},
+  st_ {},
+  sampled_ {},
+  tp_ {},
+  time_ {0},
+  slab_nodes_ {0},
+  is_paging_ {false},
+  scheduler_ {}
 {
     cb_.computefEq();
     df = cb_.eqdf;
@@ -32,19 +48,158 @@ void latticeBoltzmann::addBoundaryNode
     bn_.push_back(bn);
 }
 
-void latticeBoltzmann::takeStep()
+void latticeBoltzmann::addDiagnostics
+(
+    diagnostics *dg
+)
+{
+    dg_.push_back(dg);
+}
+
+void latticeBoltzmann::addStatistics
+(
+    flowStatistics *st
+)
+{
+    st_.push_back(st);
+    sampled_.reserve(st_.size());
+}
+
+void latticeBoltzmann::addTracers
+(
+    tracerParticles *tp
+)
+{
+    tp_.push_back(tp);
+}
+
+void latticeBoltzmann::enableOutOfCore
+(
+    const std::string &directory
+)
+{
+    if (scheduler_) throw std::runtime_error("Task scheduled steps cannot run out of core");
+    df.mapToFile(directory);
+    cb_.eqdf.mapToFile(directory);
+    slab_nodes_ = df.getSlabNodes(lb_.getNumberOfNx());
+    // arrays which fit into the page cache stay there, dropping and writing
+    // them every step would only add page faults
+    const auto num_bytes = (df.size() * df.width() + cb_.eqdf.size() * cb_.eqdf.width()) * sizeof(double);
+    const auto memory = static_cast<std::size_t>(sysconf(_SC_PHYS_PAGES)) *
+                        static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    is_paging_ = num_bytes > memory / 2;
+    sb_.setWriteBehind(is_paging_);
+}
+
+void latticeBoltzmann::enableTaskScheduling
+(
+    std::size_t band_rows
+)
+{
+    if (slab_nodes_ > 0) throw std::runtime_error("Task scheduled steps cannot run out of core");
+    scheduler_.reset(new stepScheduler(lb_, cb_, sb_, band_rows));
+}
+
+void latticeBoltzmann::reset()
 {
+    bn_.clear();
+    dg_.clear();
+    st_.clear();
+    sampled_.clear();
+    tp_.clear();
+    time_ = 0;
+    scheduler_.reset();
     cb_.computefEq();
-    cb_.collide(df);
+    // the copy reuses the memory or scratch file of df
+    df = cb_.eqdf;
+}
+
+void latticeBoltzmann::takeStep()
+{
+    if (scheduler_)
+    {
+        sampled_.clear();
+        for (auto st : st_)
+        {
+            if (!st->isSampled(time_ + 1)) continue;
+            st->startSample();
+            sampled_.push_back(st);
+        }  // st
+        scheduler_->takeStep(df, bn_, sampled_);
+        ++time_;
+        for (auto dg : dg_) dg->evaluate(time_);
+        for (auto tp : tp_) tp->advance(time_);
+        return;
+    }
+    if (slab_nodes_ > 0 && cb_.isNodeRangeSupported())
+    {
+        sweepSlabs(true, [this]()
+        {
+            cb_.computefEq();
+            cb_.collide(df);
+        });
+    }
+    else
+    {
+        cb_.computefEq();
+        if (slab_nodes_ > 0)
+        {
+            df.prefetch(0, slab_nodes_);
+            cb_.eqdf.prefetch(0, slab_nodes_);
+        }
+        cb_.collide(df);
+    }
+    // the equilibrium is computed again in the next step
+    if (is_paging_) cb_.eqdf.discard();
     for(auto bdr : bn_)
     {
         if(bdr->prestream) bdr->updateNode(df, false);
     }  // bdr
-    df = sb_.stream(df);
+    sb_.stream(df);
     for(auto bdr : bn_)
     {
         if (bdr->streaming) bdr->updateNode(df, true);
         if (!bdr->prestream) bdr->updateNode(df, false);
     }  // bdr
-    cb_.computeMacroscopicProperties(df);
+    if (slab_nodes_ > 0 && cb_.isNodeRangeSupported())
+    {
+        sweepSlabs(false, [this]()
+        {
+            cb_.computeMacroscopicProperties(df);
+        });
+    }
+    else
+    {
+        if (slab_nodes_ > 0) df.prefetch(0, slab_nodes_);
+        cb_.computeMacroscopicProperties(df);
+        if (is_paging_) df.writeBehind(0, df.size());
+    }
+    ++time_;
+    for (auto st : st_) st->sample(time_);
+    for (auto dg : dg_) dg->evaluate(time_);
+    for (auto tp : tp_) tp->advance(time_);
+}
+
+void latticeBoltzmann::sweepSlabs
+(
+    bool is_eqdf,
+    const std::function<void()> &sweep
+)
+{
+    const auto num_nodes = df.size();
+    df.prefetch(0, slab_nodes_);
+    if (is_eqdf) cb_.eqdf.prefetch(0, slab_nodes_);
+    for (auto first = std::size_t {0}; first < num_nodes; first += slab_nodes_)
+    {
+        const auto last = std::min(first + slab_nodes_, num_nodes);
+        df.prefetch(last, slab_nodes_);
+        if (is_eqdf) cb_.eqdf.prefetch(last, slab_nodes_);
+        cb_.restrictToNodes(first, last, sweep);
+        if (is_paging_) df.writeBehind(first, last - first);
+    }  // first
+}
+
+latticeArray<double>& latticeBoltzmann::getDistributionFunctions()
+{
+    return df;
 }
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "latticeBase.hpp"
+#include "loadBalancer.hpp"
+
+loadBalancer::loadBalancer
+(
+    latticeBase &lb,
+    std::size_t chunk_nodes,
+    std::size_t rebalance_interval
+)
+: lb_ (lb),
+  num_nodes_ {lb.getNumberOfNx() * lb.getNumberOfNy()},
+  chunk_nodes_ {chunk_nodes == 0 ? lb.getNumberOfNx() : chunk_nodes},
+  num_chunks_ {0},
+  num_threads_ {1},
+  rebalance_interval_ {rebalance_interval},
+  num_sweeps_ {0},
+  cost_ {},
+  chunk_time_ {},
+  thread_time_ {},
+  imbalance_ {1.0},
+  num_stolen_ {0},
+  queues_ {}
+{
+    if (num_nodes_ == 0) throw std::runtime_error("Load balancer needs a non-empty lattice");
+    num_chunks_ = (num_nodes_ + chunk_nodes_ - 1) / chunk_nodes_;
+#ifdef _OPENMP
+    num_threads_ = static_cast<std::size_t>(omp_get_max_threads());
+#endif
+    // every thread gets at least one chunk to start with
+    num_threads_ = std::min(num_threads_, num_chunks_);
+    chunk_time_.assign(num_chunks_, 0.0);
+    thread_time_.assign(num_threads_, 0.0);
+    queues_.reset(new chunkQueue[num_threads_]);
+    for (auto t = 0u; t < num_threads_; ++t) queues_[t].num_stolen = 0;
+    // each node of a chunk costs the same until setCosts() is called
+    cost_.assign(num_chunks_, 0.0);
+    for (auto c = 0u; c < num_chunks_; ++c)
+    {
+        cost_[c] = static_cast<double>(std::min((c + 1) * chunk_nodes_, num_nodes_) -
+                                       c * chunk_nodes_);
+    }  // c
+    partition(cost_);
+}
+
+void loadBalancer::setCosts
+(
+    const std::vector<bool> &solid,
+    double link_weight
+)
+{
+    if (solid.size() != num_nodes_)
+    {
+        throw std::runtime_error("Solid nodes do not match the lattice of the load balancer");
+    }
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    cost_.assign(num_chunks_, 0.0);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb_.getNodeIndex(x, y);
+            if (!solid[n])
+            {
+                cost_[n / chunk_nodes_] += 1.0 + link_weight *
+                                           getNumberOfBoundaryLinks(solid, x, y);
+            }
+        }  // x
+    }  // y
+    partition(cost_);
+    std::fill(chunk_time_.begin(), chunk_time_.end(), 0.0);
+    std::fill(thread_time_.begin(), thread_time_.end(), 0.0);
+    num_sweeps_ = 0;
+}
+
+std::size_t loadBalancer::getNumberOfThreads() const
+{
+    return num_threads_;
+}
+
+double loadBalancer::getImbalance() const
+{
+    return imbalance_;
+}
+
+std::size_t loadBalancer::getNumberOfStolenChunks() const
+{
+    return num_stolen_;
+}
+
+std::size_t loadBalancer::getThreadNumber()
+{
+#ifdef _OPENMP
+    return static_cast<std::size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+std::size_t loadBalancer::getNumberOfBoundaryLinks
+(
+    const std::vector<bool> &solid,
+    std::size_t x,
+    std::size_t y
+) const
+{
+    const auto nx = static_cast<long>(lb_.getNumberOfNx());
+    const auto ny = static_cast<long>(lb_.getNumberOfNy());
+    auto num_links = 0u;
+    for (auto d_y = -1l; d_y <= 1; ++d_y)
+    {
+        for (auto d_x = -1l; d_x <= 1; ++d_x)
+        {
+            if (d_x == 0 && d_y == 0) continue;
+            const auto x_neighbor = static_cast<long>(x) + d_x;
+            const auto y_neighbor = static_cast<long>(y) + d_y;
+            if (x_neighbor < 0 || x_neighbor >= nx || y_neighbor < 0 || y_neighbor >= ny ||
+                solid[lb_.getNodeIndex(x_neighbor, y_neighbor)])
+            {
+                ++num_links;
+            }
+        }  // d_x
+    }  // d_y
+    return num_links;
+}
+
+void loadBalancer::finishSweep()
+{
+    ++num_sweeps_;
+    auto max_time = 0.0;
+    auto sum_time = 0.0;
+    for (auto t = 0u; t < num_threads_; ++t)
+    {
+        max_time = std::max(max_time, thread_time_[t]);
+        sum_time += thread_time_[t];
+    }  // t
+    imbalance_ = sum_time > 0.0 ? max_time * num_threads_ / sum_time : 1.0;
+    num_stolen_ = 0;
+    for (auto t = 0u; t < num_threads_; ++t) num_stolen_ += queues_[t].num_stolen;
+    if (rebalance_interval_ == 0 || num_sweeps_ < rebalance_interval_) return;
+    // the measured time of a chunk includes everything the estimated cost misses,
+    // e.g. cache misses and the nodes of the other sweeps
+    partition(chunk_time_);
+    std::fill(chunk_time_.begin(), chunk_time_.end(), 0.0);
+    std::fill(thread_time_.begin(), thread_time_.end(), 0.0);
+    for (auto t = 0u; t < num_threads_; ++t) queues_[t].num_stolen = 0;
+    num_sweeps_ = 0;
+}
+
+void loadBalancer::partition
+(
+    const std::vector<double> &weight
+)
+{
+    auto total = 0.0;
+    for (auto w : weight) total += w;
+    // chunks which were never timed fall back to their estimated cost
+    const auto &chunk_weight = total > 0.0 ? weight : cost_;
+    if (total <= 0.0) for (auto w : cost_) total += w;
+    auto c = 0u;
+    auto prefix = 0.0;
+    for (auto t = 0u; t < num_threads_; ++t)
+    {
+        queues_[t].first = c;
+        const auto bound = total * (t + 1) / num_threads_;
+        // a chunk goes to the thread which holds the larger half of it
+        while (c < num_chunks_ && (t + 1 == num_threads_ || prefix + 0.5 * chunk_weight[c] <= bound))
+        {
+            prefix += chunk_weight[c];
+            ++c;
+        }
+        queues_[t].last = c;
+        queues_[t].next = c;
+    }  // t
+}
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "lossyCodec.hpp"
+
+namespace
+{
+    // Largest magnitude of a quantization code, larger prediction errors are
+    // stored exactly
+    const double max_quantization = 1073741824.0;
+
+    // Number of quantization codes which share a Rice parameter
+    const std::size_t block_size = 64;
+
+    // Largest number of bytes of a stripe read at once, so that a corrupted
+    // stripe size cannot allocate more memory than the stream holds
+    const std::size_t read_chunk = 1u << 20;
+
+    // Rice parameter of a block whose codes are all zero, no codes follow
+    const unsigned zero_block = 31;
+
+    // Longest unary quotient of a Rice code, longer codes escape to 32 bits
+    const unsigned max_quotient = 32;
+
+    // Appends bits to a byte vector, least significant bit first
+    struct bitWriter
+    {
+        std::vector<char> &bytes;
+        std::uint64_t buffer;
+        unsigned num_bits;
+
+        // Appends the lowest n <= 32 bits of a value
+        void write(std::uint64_t value, unsigned n)
+        {
+            buffer |= value << num_bits;
+            num_bits += n;
+            while (num_bits >= 8)
+            {
+                bytes.push_back(static_cast<char>(buffer & 0xff));
+                buffer >>= 8;
+                num_bits -= 8;
+            }
+        }
+
+        // Appends the bits of an incomplete byte
+        void flush()
+        {
+            if (num_bits > 0) bytes.push_back(static_cast<char>(buffer & 0xff));
+            buffer = 0;
+            num_bits = 0;
+        }
+    };
+
+    // Reads bits written by bitWriter
+    struct bitReader
+    {
+        const std::vector<char> &bytes;
+        std::size_t position;
+        std::uint64_t buffer;
+        unsigned num_bits;
+
+        // Reads n <= 32 bits
+        std::uint64_t read(unsigned n)
+        {
+            while (num_bits < n)
+            {
+                if (position >= bytes.size()) throw std::runtime_error("Truncated compressed stripe");
+                buffer |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[position++])) <<
+                          num_bits;
+                num_bits += 8;
+            }
+            const auto value = buffer & ((std::uint64_t {1} << n) - 1);
+            buffer >>= n;
+            num_bits -= n;
+            return value;
+        }
+    };
+
+    // Lorenzo prediction of a value from its reconstructed neighbours on the
+    // left, below and below left, the first row and column only use one
+    // neighbour
+    double predict(const double *reconstructed, std::size_t nx, std::size_t x, std::size_t y)
+    {
+        const auto n = y * nx + x;
+        if (x > 0 && y > 0)
+        {
+            return reconstructed[n - 1] + reconstructed[n - nx] - reconstructed[n - nx - 1];
+        }
+        if (x > 0) return reconstructed[n - 1];
+        if (y > 0) return reconstructed[n - nx];
+        return 0.0;
+    }
+
+    // Appends the bytes of a plain value
+    template <typename T>
+    void append(std::vector<char> &bytes, T value)
+    {
+        const auto *first = reinterpret_cast<const char*>(&value);
+        bytes.insert(bytes.end(), first, first + sizeof(T));
+    }
+
+    // Reads a plain value from a stream
+    template <typename T>
+    T extract(std::istream &in)
+    {
+        T value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+        {
+            throw std::runtime_error("Truncated compressed field");
+        }
+        return value;
+    }
+}
+
+lossyCodec::lossyCodec
+(
+    e_bounds bound,
+    double error_bound,
+    std::size_t stripe_rows
+)
+: bound_ {bound},
+  error_bound_ {error_bound},
+  stripe_rows_ {stripe_rows}
+{
+    if (!(error_bound_ > 0.0)) throw std::runtime_error("Error bound must be positive");
+    if (stripe_rows_ == 0) throw std::runtime_error("Stripes need at least one row");
+}
+
+lossyCodec::statistics lossyCodec::compress
+(
+    const std::vector<double> &values,
+    std::size_t nx,
+    std::size_t ny,
+    std::ostream &out
+) const
+{
+    if (values.size() != nx * ny) throw std::runtime_error("Field does not match its size");
+    auto error_bound = error_bound_;
+    if (bound_ == RELATIVE)
+    {
+        auto min_value = HUGE_VAL;
+        auto max_value = -HUGE_VAL;
+        for (auto v : values)
+        {
+            if (!std::isfinite(v)) continue;
+            min_value = std::min(min_value, v);
+            max_value = std::max(max_value, v);
+        }  // v
+        // a constant field is bounded relative to its magnitude instead
+        const auto range = max_value > min_value ? max_value - min_value :
+                           std::max(std::fabs(min_value), std::fabs(max_value));
+        if (std::isfinite(range) && range > 0.0) error_bound *= range;
+    }
+    const long num_stripes = (ny + stripe_rows_ - 1) / stripe_rows_;
+    std::vector<std::vector<char>> stripes(num_stripes);
+    auto max_error = 0.0;
+    #pragma omp parallel for schedule(dynamic) reduction(max:max_error)
+    for (long s = 0; s < num_stripes; ++s)
+    {
+        const auto first_row = s * stripe_rows_;
+        const auto num_rows = std::min(stripe_rows_, ny - first_row);
+        max_error = std::max(max_error, encodeStripe(values.data() + first_row * nx, nx, num_rows,
+                                                     error_bound, stripes[s]));
+    }  // s
+    std::vector<char> header;
+    append(header, error_bound);
+    append(header, static_cast<std::uint64_t>(stripe_rows_));
+    for (const auto &stripe : stripes) append(header, static_cast<std::uint64_t>(stripe.size()));
+    out.write(header.data(), header.size());
+    auto compressed_bytes = header.size();
+    for (const auto &stripe : stripes)
+    {
+        out.write(stripe.data(), stripe.size());
+        compressed_bytes += stripe.size();
+    }  // stripe
+    if (!out) throw std::runtime_error("Error in writing compressed field");
+    return statistics {values.size() * sizeof(double), compressed_bytes, max_error};
+}
+
+void lossyCodec::decompress
+(
+    std::istream &in,
+    std::size_t nx,
+    std::size_t ny,
+    std::vector<double> &values
+)
+{
+    const auto error_bound = extract<double>(in);
+    const auto stripe_rows = static_cast<std::size_t>(extract<std::uint64_t>(in));
+    if (!(error_bound > 0.0) || stripe_rows == 0) throw std::runtime_error("Invalid compressed field");
+    const long num_stripes = (ny + stripe_rows - 1) / stripe_rows;
+    std::vector<std::uint64_t> stripe_bytes(num_stripes);
+    for (auto &num_bytes : stripe_bytes) num_bytes = extract<std::uint64_t>(in);
+    std::vector<std::vector<char>> stripes(num_stripes);
+    for (auto s = 0u; s < stripes.size(); ++s)
+    {
+        // the stripe only grows by what has been read
+        auto &stripe = stripes[s];
+        while (stripe.size() < stripe_bytes[s])
+        {
+            const auto offset = stripe.size();
+            const std::uint64_t remaining = stripe_bytes[s] - offset;
+            const auto num_bytes = remaining < read_chunk ? static_cast<std::size_t>(remaining) : read_chunk;
+            stripe.resize(offset + num_bytes);
+            if (!in.read(stripe.data() + offset, num_bytes))
+            {
+                throw std::runtime_error("Truncated compressed field");
+            }
+        }
+    }  // s
+    values.assign(nx * ny, 0.0);
+    auto is_failed = false;
+    #pragma omp parallel for schedule(dynamic)
+    for (long s = 0; s < num_stripes; ++s)
+    {
+        const auto first_row = s * stripe_rows;
+        try
+        {
+            decodeStripe(stripes[s], nx, std::min(stripe_rows, ny - first_row), error_bound,
+                         values.data() + first_row * nx);
+        }
+        catch (const std::runtime_error&)
+        {
+            #pragma omp atomic write
+            is_failed = true;
+        }
+    }  // s
+    if (is_failed) throw std::runtime_error("Invalid compressed stripe");
+}
+
+std::uint64_t lossyCodec::getMinimumCompressedSize
+(
+    std::size_t nx,
+    std::size_t ny
+)
+{
+    // a size which overflows cannot be held by any stream
+    const std::uint64_t max_size = std::numeric_limits<std::uint64_t>::max();
+    if (ny > 0 && nx > max_size / ny) return max_size;
+    // error bound, stripe size and one stripe with its size and number of
+    // outliers, then at least the Rice parameter of each block
+    const std::uint64_t num_values = static_cast<std::uint64_t>(nx) * ny;
+    const auto num_blocks = num_values / block_size + (num_values % block_size != 0 ? 1 : 0);
+    return 4 * sizeof(std::uint64_t) + (5 * num_blocks + 7) / 8;
+}
+
+double lossyCodec::encodeStripe
+(
+    const double *values,
+    std::size_t nx,
+    std::size_t num_rows,
+    double error_bound,
+    std::vector<char> &bytes
+)
+{
+    const auto num_values = nx * num_rows;
+    const auto step = 2.0 * error_bound;
+    std::vector<double> reconstructed(num_values);
+    std::vector<std::uint32_t> codes(num_values);
+    std::vector<std::uint32_t> outlier_index;
+    std::vector<double> outlier_value;
+    auto max_error = 0.0;
+    for (auto y = 0u; y < num_rows; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = y * nx + x;
+            const auto v = values[n];
+            const auto prediction = predict(reconstructed.data(), nx, x, y);
+            const auto quantization = std::round((v - prediction) / step);
+            const auto r = prediction + step * quantization;
+            // NaN fails both comparisons
+            if (std::fabs(quantization) < max_quantization && std::fabs(r - v) <= error_bound)
+            {
+                // zigzag encoding keeps small codes small for both signs
+                const auto q = static_cast<std::int64_t>(quantization);
+                codes[n] = static_cast<std::uint32_t>(q >= 0 ? 2 * q : -2 * q - 1);
+                reconstructed[n] = r;
+                max_error = std::max(max_error, std::fabs(r - v));
+            }
+            else
+            {
+                codes[n] = 0;
+                reconstructed[n] = v;
+                outlier_index.push_back(static_cast<std::uint32_t>(n));
+                outlier_value.push_back(v);
+            }
+        }  // x
+    }  // y
+    bytes.clear();
+    append(bytes, static_cast<std::uint64_t>(outlier_index.size()));
+    for (auto k = 0u; k < outlier_index.size(); ++k)
+    {
+        append(bytes, outlier_index[k]);
+        append(bytes, outlier_value[k]);
+    }  // k
+    bitWriter writer {bytes, 0, 0};
+    for (auto first = std::size_t {0}; first < num_values; first += block_size)
+    {
+        const auto last = std::min(first + block_size, num_values);
+        std::uint64_t sum = 0;
+        for (auto n = first; n < last; ++n) sum += codes[n];
+        if (sum == 0)
+        {
+            writer.write(zero_block, 5);
+            continue;
+        }
+        // the Rice parameter follows the mean code of the block
+        const auto mean = sum / (last - first);
+        auto k = 0u;
+        while (k < zero_block - 1 && (mean >> k) > 1) ++k;
+        writer.write(k, 5);
+        for (auto n = first; n < last; ++n)
+        {
+            const auto quotient = codes[n] >> k;
+            if (quotient < max_quotient)
+            {
+                writer.write((std::uint64_t {1} << quotient) - 1, quotient + 1);
+                writer.write(codes[n] & ((std::uint64_t {1} << k) - 1), k);
+            }
+            else
+            {
+                writer.write(0xffffffff, max_quotient);
+                writer.write(codes[n], 32);
+            }
+        }  // n
+    }  // first
+    writer.flush();
+    return max_error;
+}
+
+void lossyCodec::decodeStripe
+(
+    const std::vector<char> &bytes,
+    std::size_t nx,
+    std::size_t num_rows,
+    double error_bound,
+    double *values
+)
+{
+    const auto num_values = nx * num_rows;
+    const auto step = 2.0 * error_bound;
+    std::uint64_t num_outliers = 0;
+    const auto outlier_bytes = sizeof(std::uint32_t) + sizeof(double);
+    if (bytes.size() < sizeof(num_outliers)) throw std::runtime_error("Truncated compressed stripe");
+    std::memcpy(&num_outliers, bytes.data(), sizeof(num_outliers));
+    if (num_outliers > num_values ||
+        bytes.size() < sizeof(num_outliers) + num_outliers * outlier_bytes)
+    {
+        throw std::runtime_error("Truncated compressed stripe");
+    }
+    std::vector<std::uint32_t> outlier_index(num_outliers);
+    std::vector<double> outlier_value(num_outliers);
+    for (auto k = 0u; k < num_outliers; ++k)
+    {
+        const auto *outlier = bytes.data() + sizeof(num_outliers) + k * outlier_bytes;
+        std::memcpy(&outlier_index[k], outlier, sizeof(std::uint32_t));
+        std::memcpy(&outlier_value[k], outlier + sizeof(std::uint32_t), sizeof(double));
+    }  // k
+    bitReader reader {bytes, sizeof(num_outliers) + num_outliers * outlier_bytes, 0, 0};
+    auto next_outlier = std::size_t {0};
+    for (auto first = std::size_t {0}; first < num_values; first += block_size)
+    {
+        const auto last = std::min(first + block_size, num_values);
+        const auto k = static_cast<unsigned>(reader.read(5));
+        for (auto n = first; n < last; ++n)
+        {
+            std::uint64_t code = 0;
+            if (k != zero_block)
+            {
+                auto quotient = 0u;
+                while (quotient < max_quotient && reader.read(1) == 1) ++quotient;
+                code = quotient == max_quotient ? reader.read(32) :
+                                                  (std::uint64_t {quotient} << k) | reader.read(k);
+            }
+            const auto x = n % nx;
+            const auto y = n / nx;
+            if (next_outlier < num_outliers && outlier_index[next_outlier] == n)
+            {
+                values[n] = outlier_value[next_outlier++];
+                continue;
+            }
+            const auto q = code % 2 == 0 ? static_cast<std::int64_t>(code / 2) :
+                                           -static_cast<std::int64_t>((code + 1) / 2);
+            values[n] = predict(values, nx, x, y) + step * static_cast<double>(q);
+        }  // n
+    }  // first
+}
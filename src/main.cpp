@@ -1,5 +1,7 @@
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "latticeModel.hxx"
@@ -7,16 +9,126 @@
 #include "latticeD2Q9.hpp"
 #include "collisionD2Q9_BGK.hpp"
 #include "collisionD2Q9_MRT.hpp"
+#include "collisionD2Q9_RBGK.hpp"
+#include "collisionD2Q9_CM.hpp"
 #include "streamD2Q9.hpp"
 #include "bouncebackNode.hpp"
 #include "ZouHeNode.hpp"
+#include "nodeTypeField.hpp"
 #include "latticeBoltzmann.hpp"
 #include "boundaryNode.hxx"
 #include "momentComputing.h"
 #include "result.hpp"
+#include "resultHDF5.hpp"
+#include "diagnostics.hpp"
+#include "gridSequencing.hpp"
+#include "telemetry.hpp"
+#include "runDriver.hpp"
 
-int main()
+// Grid sequencing of the lid-driven cavity, the coarse levels use the same
+// collision model and boundaries as the fine lattice
+class cavitySequencing : public gridSequencing
 {
+    public:
+        // Constructor: Creates the grid sequencing of the cavity
+        // param lb fine lattice
+        // param kinematic_viscosity kinematic viscosity on the fine lattice
+        // param num_levels number of levels including the fine lattice
+        // param tolerance steady state tolerance
+        // param check_interval number of steps between two steady state checks
+        // param max_steps maximum number of steps on each coarse level
+        // param u_lid x-component of the lid velocity
+        // param v_lid y-component of the lid velocity
+        cavitySequencing
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            std::size_t num_levels,
+            double tolerance,
+            std::size_t check_interval,
+            std::size_t max_steps,
+            double u_lid,
+            double v_lid
+        )
+        : gridSequencing(lb, kinematic_viscosity, num_levels, tolerance, check_interval,
+                         max_steps),
+          u_lid_ {u_lid},
+          v_lid_ {v_lid}
+        {}
+        std::unique_ptr<collisionBase> makeCollision
+        (
+            latticeBase &lb,
+            double kinematic_viscosity,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        ) override
+        {
+            return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT(lb, kinematic_viscosity,
+                                                                        1.0, D2Q9, field));
+        }
+        void addBoundaries
+        (
+            latticeBase &lb,
+            collisionBase &,
+            latticeModelD2Q9 &,
+            fluidField &,
+            nodeTypeField &types
+        ) override
+        {
+            const auto nx = lb.getNumberOfNx();
+            const auto ny = lb.getNumberOfNy();
+            for (auto y = 0u; y < ny; ++y)
+            {
+                types.addHalfwayBounceback(0, y);
+                types.addHalfwayBounceback(nx - 1, y);
+            }  // y
+            for (auto x = 0u; x < nx; ++x) types.addHalfwayBounceback(x, 0);
+            for (auto x = 0u; x < nx; ++x) types.addVelocity(x, ny - 1, u_lid_, v_lid_, false);
+        }
+    private:
+        // Lid velocity
+        double u_lid_;
+        double v_lid_;
+};
+
+int main(int argc, char *argv[])
+{
+    // lbm --run file.scn runs a scenario file, lbm --queue directory runs the
+    // scenario files of a directory and lbm --listen socket_path runs the scenario
+    // files sent to a Unix socket. The exit status is 1 if any case failed
+    const std::string mode = argc > 2 ? argv[1] : "";
+    if (mode == "--run" || mode == "--queue" || mode == "--listen")
+    {
+        runDriver driver;
+        try
+        {
+            if (mode == "--run")
+            {
+                driver.runScenario(driver.readScenario(argv[2]));
+            }
+            else if (mode == "--queue")
+            {
+                driver.runDirectory(argv[2]);
+            }
+            else
+            {
+                driver.listen(argv[2]);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << argv[2] << ": " << e.what() << std::endl;
+            return 1;
+        }
+        return driver.getNumberOfFailedCases() == 0 ? 0 : 1;
+    }
+    // lbm --decompress file.lbmz ... writes the .vtk files of compressed outputs
+    if (argc > 2 && std::string(argv[1]) == "--decompress")
+    {
+        for (auto k = 2; k < argc; ++k) std::cout << result::convertToVTK(argv[k]) << std::endl;
+        return 0;
+    }
+
     std::size_t ny = 256;
     std::size_t nx = 256;
     auto tolerance = 1.0e-3;
@@ -49,6 +161,8 @@ int main()
     );
 
     //collisionD2Q9_BGK collision
+    //collisionD2Q9_RBGK collision
+    //collisionD2Q9_CM collision
     collisionD2Q9_MRT collision
     (
         lattice,
@@ -58,10 +172,19 @@ int main()
         field
     );
 
+    nodeTypeField types
+    (
+        lattice,
+        collision,
+        D2Q9,
+        field
+    );
+
     streamD2Q9 stream
     (
         lattice,
-        D2Q9
+        D2Q9,
+        types
     );
 
     bouncebackNode bbnode
@@ -99,8 +222,9 @@ int main()
         zhnode.addNode(x, ny - 1, u_lid, v_lid);
     }
 
-    run.addBoundaryNode(&bbnode);
-    run.addBoundaryNode(&zhnode);
+    // boundaries are applied inside the streaming sweep
+    bbnode.registerNodes(types);
+    zhnode.registerNodes(types);
 
     result results
     (
@@ -108,15 +232,79 @@ int main()
         field
     );
 
+#ifdef USE_HDF5
+    resultHDF5 results_h5
+    (
+        lattice,
+        field,
+        "fluid.h5",
+        64,
+        4
+    );
+#endif
+
+    diagnostics monitor
+    (
+        lattice,
+        collision,
+        field,
+        "diagnostics.csv",
+        nx / 32
+    );
+    monitor.addProbe(nx / 2, ny / 2);
+    monitor.addLineSample(true, nx / 2);
+    monitor.addLineSample(false, ny / 2);
+    monitor.addIntegral(diagnostics::MASS);
+    monitor.addIntegral(diagnostics::KINETIC_ENERGY);
+    monitor.addIntegral(diagnostics::ENSTROPHY);
+    monitor.addWallShear(diagnostics::TOP, visco_f);
+    run.addDiagnostics(&monitor);
+
+    // converge on 64 x 64 and 128 x 128 first, the fine lattice starts from the
+    // interpolated 128 x 128 solution instead of rest
+    cavitySequencing sequencing
+    (
+        lattice,
+        visco_f,
+        3,
+        tolerance,
+        nx / 8,
+        100000,
+        u_lid,
+        v_lid
+    );
+    std::cout << "coarse steps= " << sequencing.initialize(run, collision, field) << std::endl;
+
+    // per-step metrics go to a JSON lines file instead of the console
+    telemetry metrics
+    (
+        lattice,
+        collision,
+        field,
+        telemetry::JSON_FILE,
+        "telemetry.jsonl",
+        256,
+        nx / 8
+    );
+    metrics.addMetric(telemetry::STEP_TIME, 1);
+    metrics.addMetric(telemetry::MLUPS, nx / 32);
+    metrics.addMetric(telemetry::RESIDUAL, nx / 32);
+    metrics.addMetric(telemetry::MASS_DRIFT, nx / 8);
+
+    auto uprev = field.u;
     for (auto t = 0u; t <= nx; ++t)
     {
-        auto uprev = field.u;
+        // the velocity is only kept before the steps which check the steady state
+        if (t % (nx/8) == 0) uprev = field.u;
+        metrics.startStep();
         run.takeStep();
-        auto error = checkError(uprev, field.u);
-        std::cout << "t= " << t << "; error= " << error << std::endl;
+        metrics.endStep();
         if (t % (nx/8) == 0)
         {
             results.writeResultVTK(t);
+#ifdef USE_HDF5
+            results_h5.writeResult(t);
+#endif
             if (checkSteadyState(uprev, field.u, tolerance))
             {
                 results.writeResultVTK(t);
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "mappedFile.hpp"
+
+mappedFile::mappedFile
+(
+    const std::string &directory,
+    std::size_t num_bytes
+)
+: fd_ {-1},
+  data_ {nullptr},
+  num_bytes_ {0}
+{
+    auto path = directory + "/openlbm_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    fd_ = mkstemp(name.data());
+    if (fd_ < 0) throw std::runtime_error("Error in creating a scratch file in " + directory);
+    unlink(name.data());
+    resize(num_bytes);
+}
+
+mappedFile::~mappedFile()
+{
+    if (data_ != nullptr) munmap(data_, num_bytes_);
+    if (fd_ >= 0) close(fd_);
+}
+
+void mappedFile::resize
+(
+    std::size_t num_bytes
+)
+{
+    if (num_bytes == num_bytes_) return;
+    if (ftruncate(fd_, num_bytes) != 0) throw std::runtime_error("Error in resizing a scratch file");
+    void *data = MAP_FAILED;
+    if (num_bytes == 0)
+    {
+        munmap(data_, num_bytes_);
+        data = nullptr;
+    }
+    else if (data_ == nullptr)
+    {
+        data = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    }
+    else
+    {
+        data = mremap(data_, num_bytes_, num_bytes, MREMAP_MAYMOVE);
+    }
+    if (data == MAP_FAILED) throw std::runtime_error("Error in mapping a scratch file");
+    data_ = data;
+    num_bytes_ = num_bytes;
+}
+
+void mappedFile::adviseSequential()
+{
+    if (data_ != nullptr) madvise(data_, num_bytes_, MADV_SEQUENTIAL);
+}
+
+void mappedFile::prefetch
+(
+    std::size_t offset,
+    std::size_t num_bytes
+)
+{
+    if (!alignRange(offset, num_bytes)) return;
+    madvise(static_cast<char*>(data_) + offset, num_bytes, MADV_WILLNEED);
+}
+
+void mappedFile::writeBehind
+(
+    std::size_t offset,
+    std::size_t num_bytes
+)
+{
+    if (!alignRange(offset, num_bytes)) return;
+    // the dirty pages stay in the page cache when they are unmapped and are
+    // written back from there
+    sync_file_range(fd_, offset, num_bytes, SYNC_FILE_RANGE_WRITE);
+    madvise(static_cast<char*>(data_) + offset, num_bytes, MADV_DONTNEED);
+}
+
+void mappedFile::discard
+(
+    std::size_t offset,
+    std::size_t num_bytes
+)
+{
+    if (data_ == nullptr || offset >= num_bytes_) return;
+    // only whole pages inside the range are discarded, except for the last page
+    // of the file
+    const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto end = std::min(offset + num_bytes, num_bytes_);
+    if (end == num_bytes_) end = (end + page - 1) / page * page;
+    offset = (offset + page - 1) / page * page;
+    end -= end % page;
+    if (end <= offset) return;
+    madvise(static_cast<char*>(data_) + offset, end - offset, MADV_REMOVE);
+}
+
+bool mappedFile::alignRange
+(
+    std::size_t &offset,
+    std::size_t &num_bytes
+) const
+{
+    if (data_ == nullptr || offset >= num_bytes_) return false;
+    const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto end = std::min(offset + num_bytes, num_bytes_);
+    offset -= offset % page;
+    end = std::min((end + page - 1) / page * page, (num_bytes_ + page - 1) / page * page);
+    num_bytes = end - offset;
+    return num_bytes > 0;
+}
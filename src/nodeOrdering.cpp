@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "nodeOrdering.hpp"
+
+nodeOrdering::nodeOrdering
+(
+    std::size_t nx,
+    std::size_t ny
+)
+: nx_ {nx},
+  ny_ {ny},
+  ordering_ {ROW_MAJOR},
+  tile_shift_ {0},
+  tile_mask_ {0},
+  num_tiles_x_ {0},
+  tile_offset_ {},
+  tile_width_ {},
+  tiles_ {},
+  node_x_ {},
+  node_y_ {}
+{}
+
+nodeOrdering::nodeOrdering
+(
+    std::size_t nx,
+    std::size_t ny,
+    e_orderings ordering,
+    std::size_t tile_size
+)
+: nx_ {nx},
+  ny_ {ny},
+  ordering_ {ordering},
+  tile_shift_ {0},
+  tile_mask_ {tile_size - 1},
+  num_tiles_x_ {0},
+  tile_offset_ {},
+  tile_width_ {},
+  tiles_ {},
+  node_x_ {},
+  node_y_ {}
+{
+    if (ordering_ == ROW_MAJOR) return;
+    if (tile_size == 0 || (tile_size & tile_mask_) != 0)
+    {
+        throw std::runtime_error("Tile size must be a power of two");
+    }
+    while ((std::size_t {1} << tile_shift_) < tile_size) ++tile_shift_;
+    num_tiles_x_ = (nx_ + tile_mask_) >> tile_shift_;
+    const auto num_tiles_y = (ny_ + tile_mask_) >> tile_shift_;
+    auto side = std::size_t {1};
+    while (side < std::max(num_tiles_x_, num_tiles_y)) side <<= 1;
+    // sort the tiles along the curve, then hand out contiguous index ranges
+    std::vector<std::pair<std::size_t, std::size_t>> curve;
+    for (auto tile_y = 0u; tile_y < num_tiles_y; ++tile_y)
+    {
+        for (auto tile_x = 0u; tile_x < num_tiles_x_; ++tile_x)
+        {
+            const auto key = ordering_ == MORTON ? getMortonKey(tile_x, tile_y) :
+                                                   getHilbertKey(side, tile_x, tile_y);
+            curve.push_back(std::make_pair(key, tile_y * num_tiles_x_ + tile_x));
+        }  // tile_x
+    }  // tile_y
+    std::sort(begin(curve), end(curve));
+    tile_width_.assign(num_tiles_x_, tile_size);
+    tile_width_.back() = nx_ - ((num_tiles_x_ - 1) << tile_shift_);
+    const auto top_height = ny_ - ((num_tiles_y - 1) << tile_shift_);
+    tile_offset_.assign(curve.size(), 0);
+    auto offset = std::size_t {0};
+    for (auto &entry : curve)
+    {
+        const auto tile_y = entry.second / num_tiles_x_;
+        const auto tile_x = entry.second % num_tiles_x_;
+        const auto height = tile_y == num_tiles_y - 1 ? top_height : tile_size;
+        tile_offset_[entry.second] = offset;
+        tiles_.push_back(tile {offset, tile_x << tile_shift_, tile_y << tile_shift_, tile_width_[tile_x],
+                               height});
+        offset += tile_width_[tile_x] * height;
+    }  // entry
+    node_x_.assign(nx_ * ny_, 0u);
+    node_y_.assign(nx_ * ny_, 0u);
+    for (auto y = 0u; y < ny_; ++y)
+    {
+        for (auto x = 0u; x < nx_; ++x)
+        {
+            const auto n = getIndex(x, y);
+            node_x_[n] = x;
+            node_y_[n] = y;
+        }  // x
+    }  // y
+}
+
+nodeOrdering::e_orderings nodeOrdering::getOrdering() const
+{
+    return ordering_;
+}
+
+std::size_t nodeOrdering::getTileSize() const
+{
+    return ordering_ == ROW_MAJOR ? 0 : tile_mask_ + 1;
+}
+
+const std::vector<nodeOrdering::tile>& nodeOrdering::getTiles() const
+{
+    return tiles_;
+}
+
+std::size_t nodeOrdering::getMortonKey
+(
+    std::size_t tile_x,
+    std::size_t tile_y
+)
+{
+    auto key = std::size_t {0};
+    for (auto b = 0u; b < 4 * sizeof(std::size_t); ++b)
+    {
+        key |= ((tile_x >> b) & 1u) << (2 * b);
+        key |= ((tile_y >> b) & 1u) << (2 * b + 1);
+    }  // b
+    return key;
+}
+
+std::size_t nodeOrdering::getHilbertKey
+(
+    std::size_t side,
+    std::size_t tile_x,
+    std::size_t tile_y
+)
+{
+    auto key = std::size_t {0};
+    for (auto s = side / 2; s > 0; s /= 2)
+    {
+        const std::size_t rx = (tile_x & s) > 0;
+        const std::size_t ry = (tile_y & s) > 0;
+        key += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so that the sub-curve starts at its origin
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                tile_x = side - 1 - tile_x;
+                tile_y = side - 1 - tile_y;
+            }
+            std::swap(tile_x, tile_y);
+        }
+    }  // s
+    return key;
+}
@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeModel.hxx"
+
+#include "nodeTypeField.hpp"
+
+nodeTypeField::nodeTypeField
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+: lb_ (lb),
+  cb_ (cb),
+  D2Q9_ (D2Q9),
+  field_ (field),
+  type_ {},
+  param_ {},
+  velocity_ {},
+  is_normal_flow_ {},
+  density_ {},
+  opposite_ {},
+  edges_ {},
+  is_edges_ {false},
+  beta1_ {},
+  beta2_ {},
+  beta3_ {}
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    type_.assign(nx * ny, FLUID);
+    param_.assign(nx * ny, 0u);
+    // the edges are saved in place every step, also by ranges of rows
+    edges_.assign(2 * (nx + ny), nc, 0.0);
+    opposite_.assign(nc, 0u);
+    for (auto i = 0u; i < nc; ++i)
+    {
+        for (auto j = 0u; j < nc; ++j)
+        {
+            auto is_opposite = true;
+            for (auto d = 0u; d < nd; ++d)
+            {
+                is_opposite = is_opposite && D2Q9_.e[i][d] == -D2Q9_.e[j][d];
+            }  // d
+            if (is_opposite) opposite_[i] = j;
+        }  // j
+    }  // i
+    const auto c = lb_.getLatticeSpeed();
+    const auto cs_sqr = c * c / 3.0;
+    beta1_ = c / (9.0 * cs_sqr);
+    beta2_ = 0.5 / c;
+    beta3_ = beta2_ - beta1_;
+}
+
+void nodeTypeField::clear()
+{
+    std::fill(type_.begin(), type_.end(), FLUID);
+    std::fill(param_.begin(), param_.end(), 0u);
+    velocity_.clear();
+    is_normal_flow_.clear();
+    density_.clear();
+    is_edges_ = false;
+}
+
+void nodeTypeField::addBounceback
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    setType(x, y, BOUNCEBACK, 0u);
+    cb_.addNodeToSkip(lb_.getNodeIndex(x, y));
+}
+
+void nodeTypeField::addHalfwayBounceback
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    setType(x, y, HALFWAY, 0u);
+    is_edges_ = true;
+}
+
+void nodeTypeField::addVelocity
+(
+    std::size_t x,
+    std::size_t y,
+    double u_x,
+    double u_y,
+    bool is_normal_flow
+)
+{
+    // nodes with the same velocity share one table entry
+    auto k = 0u;
+    while (k < velocity_.size() && !(velocity_[k][0] == u_x && velocity_[k][1] == u_y &&
+                                     is_normal_flow_[k] == is_normal_flow)) ++k;
+    if (k == velocity_.size())
+    {
+        velocity_.push_back({u_x, u_y});
+        is_normal_flow_.push_back(is_normal_flow);
+    }
+    setType(x, y, VELOCITY, k);
+}
+
+void nodeTypeField::addPressure
+(
+    std::size_t x,
+    std::size_t y,
+    double rho
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if ((x == 0 || x == nx - 1) && (y == 0 || y == ny - 1))
+    {
+        throw std::runtime_error("Pressure node cannot be a corner");
+    }
+    auto k = 0u;
+    while (k < density_.size() && density_[k] != rho) ++k;
+    if (k == density_.size()) density_.push_back(rho);
+    setType(x, y, PRESSURE, k);
+}
+
+void nodeTypeField::addPeriodic
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    setType(x, y, PERIODIC, 0u);
+    is_edges_ = true;
+}
+
+void nodeTypeField::setType
+(
+    std::size_t x,
+    std::size_t y,
+    e_types type,
+    unsigned param
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (x >= nx || y >= ny) throw std::runtime_error("Node outside of lattice");
+    const auto is_edge = x == 0 || x == nx - 1 || y == 0 || y == ny - 1;
+    if (!is_edge && type != BOUNCEBACK && type != FLUID)
+    {
+        throw std::runtime_error("Boundary type only valid on the edge of the lattice");
+    }
+    const auto n = lb_.getNodeIndex(x, y);
+    type_[n] = type;
+    param_[n] = param;
+}
+
+int nodeTypeField::getSide
+(
+    std::size_t n
+) const
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto &ordering = lb_.getNodeOrdering();
+    const auto x = ordering.getX(n);
+    if (x == nx - 1) return 0;
+    if (ordering.getY(n) == ny - 1) return 1;
+    if (x == 0) return 2;
+    return 3;
+}
+
+std::size_t nodeTypeField::getEdgeIndex
+(
+    std::size_t x,
+    std::size_t y
+) const
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (y == 0) return x;
+    if (y == ny - 1) return nx + x;
+    if (x == 0) return 2 * nx + y;
+    return 2 * nx + ny + y;
+}
+
+void nodeTypeField::saveEdges
+(
+    const latticeArray<double> &df
+)
+{
+    saveEdges(df, 0, lb_.getNumberOfNy());
+}
+
+void nodeTypeField::saveEdges
+(
+    const latticeArray<double> &df,
+    std::size_t first_row,
+    std::size_t last_row
+)
+{
+    if (!is_edges_) return;
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    for (auto y = first_row; y < last_row; ++y)
+    {
+        if (y == 0 || y == ny - 1)
+        {
+            for (auto x = 0u; x < nx; ++x)
+            {
+                for (auto i = 0u; i < nc; ++i) edges_[getEdgeIndex(x, y)][i] = df[lb_.getNodeIndex(x, y)][i];
+            }  // x
+        }
+        else
+        {
+            for (auto i = 0u; i < nc; ++i)
+            {
+                edges_[getEdgeIndex(0, y)][i] = df[lb_.getNodeIndex(0, y)][i];
+                edges_[getEdgeIndex(nx - 1, y)][i] = df[lb_.getNodeIndex(nx - 1, y)][i];
+            }  // i
+        }
+    }  // y
+}
+
+void nodeTypeField::pullOffLattice
+(
+    latticeArray<double> &df,
+    std::size_t n,
+    std::size_t i
+)
+{
+    const long nx = lb_.getNumberOfNx();
+    const long ny = lb_.getNumberOfNy();
+    const long x = lb_.getNodeOrdering().getX(n);
+    const long y = lb_.getNodeOrdering().getY(n);
+    switch (type_[n])
+    {
+        case HALFWAY:
+        {
+            df[n][i] = edges_[getEdgeIndex(x, y)][opposite_[i]];
+            break;
+        }
+        case PERIODIC:
+        {
+            const auto x_up = (x - (D2Q9_.e[i][0] > 0.0) + (D2Q9_.e[i][0] < 0.0) + nx) % nx;
+            const auto y_up = (y - (D2Q9_.e[i][1] > 0.0) + (D2Q9_.e[i][1] < 0.0) + ny) % ny;
+            df[n][i] = edges_[getEdgeIndex(x_up, y_up)][i];
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+double nodeTypeField::getKnownSum
+(
+    const latticeArray<double> &df,
+    std::size_t n,
+    int side
+) const
+{
+    switch (side)
+    {
+        case 0:
+        {  // right
+            return df[n][0] + df[n][D2Q9_.N] + df[n][D2Q9_.S] + 2.0 * (df[n][D2Q9_.E] +
+                   df[n][D2Q9_.NE] + df[n][D2Q9_.SE]);
+        }
+        case 1:
+        {  // top
+            return df[n][0] + df[n][D2Q9_.E] + df[n][D2Q9_.W] + 2.0 * (df[n][D2Q9_.N] +
+                   df[n][D2Q9_.NE] + df[n][D2Q9_.NW]);
+        }
+        case 2:
+        {  // left
+            return df[n][0] + df[n][D2Q9_.N] + df[n][D2Q9_.S] + 2.0 * (df[n][D2Q9_.W] +
+                   df[n][D2Q9_.NW] + df[n][D2Q9_.SW]);
+        }
+        default:
+        {  // bottom
+            return df[n][0] + df[n][D2Q9_.E] + df[n][D2Q9_.W] + 2.0 * (df[n][D2Q9_.S] +
+                   df[n][D2Q9_.SW] + df[n][D2Q9_.SE]);
+        }
+    }
+}
+
+void nodeTypeField::setEdgeUnknowns
+(
+    latticeArray<double> &df,
+    std::size_t n,
+    int side,
+    double j_x,
+    double j_y
+)
+{
+    switch (side)
+    {
+        case 0:
+        {  // right
+            const auto df_diff = 0.5 * (df[n][D2Q9_.S] - df[n][D2Q9_.N]);
+            df[n][D2Q9_.W]  = df[n][D2Q9_.E] - 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.NW] = df[n][D2Q9_.SE] + df_diff - beta3_ * j_x + beta2_ * j_y;
+            df[n][D2Q9_.SW] = df[n][D2Q9_.NE] - df_diff - beta3_ * j_x - beta2_ * j_y;
+            break;
+        }
+        case 1:
+        {  // top
+            const auto df_diff = 0.5 * (df[n][D2Q9_.E] - df[n][D2Q9_.W]);
+            df[n][D2Q9_.S]  = df[n][D2Q9_.N] - 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.SW] = df[n][D2Q9_.NE] + df_diff - beta2_ * j_x - beta3_ * j_y;
+            df[n][D2Q9_.SE] = df[n][D2Q9_.NW] - df_diff + beta2_ * j_x - beta3_ * j_y;
+            break;
+        }
+        case 2:
+        {  // left
+            const auto df_diff = 0.5 * (df[n][D2Q9_.S] - df[n][D2Q9_.N]);
+            df[n][D2Q9_.E]  = df[n][D2Q9_.W] + 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.NE] = df[n][D2Q9_.SW] + df_diff + beta3_ * j_x + beta2_ * j_y;
+            df[n][D2Q9_.SE] = df[n][D2Q9_.NW] - df_diff + beta3_ * j_x - beta2_ * j_y;
+            break;
+        }
+        default:
+        {  // bottom
+            const auto df_diff = 0.5 * (df[n][D2Q9_.W] - df[n][D2Q9_.E]);
+            df[n][D2Q9_.N]  = df[n][D2Q9_.S] + 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.NE] = df[n][D2Q9_.SW] + df_diff + beta2_ * j_x + beta3_ * j_y;
+            df[n][D2Q9_.NW] = df[n][D2Q9_.SE] - df_diff - beta2_ * j_x + beta3_ * j_y;
+            break;
+        }
+    }
+}
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::BOUNCEBACK>
+(
+    latticeArray<double> &df,
+    std::size_t n
+)
+{
+    // full-way bounceback: reverse the distribution functions which have just
+    // streamed in, they stream back out in the next time step
+    auto f = df[n];
+    std::swap(f[D2Q9_.E], f[D2Q9_.W]);
+    std::swap(f[D2Q9_.N], f[D2Q9_.S]);
+    std::swap(f[D2Q9_.NE], f[D2Q9_.SW]);
+    std::swap(f[D2Q9_.NW], f[D2Q9_.SE]);
+}
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::VELOCITY>
+(
+    latticeArray<double> &df,
+    std::size_t n
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto c = lb_.getLatticeSpeed();
+    const auto x = lb_.getNodeOrdering().getX(n);
+    const auto y = lb_.getNodeOrdering().getY(n);
+    const auto left   = x == 0;
+    const auto right  = x == nx - 1;
+    const auto bottom = y == 0;
+    const auto top    = y == ny - 1;
+    const auto &vel = velocity_[param_[n]];
+    if ((top || bottom) && (left || right))
+    {
+        // corners take the mean density of their two neighbours along the edges
+        auto rho_node = 0.5 * (cb_.rho_[lb_.getNodeIndex(x, bottom ? y + 1 : y - 1)] +
+                               cb_.rho_[lb_.getNodeIndex(left ? x + 1 : x - 1, y)]);
+        const auto j_x = rho_node * vel[0];
+        const auto j_y = rho_node * vel[1];
+        if (bottom && left)
+        {
+            df[n][D2Q9_.E]  = df[n][D2Q9_.W] + 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.N]  = df[n][D2Q9_.S] + 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.NE] = df[n][D2Q9_.SW] + 0.5 * beta1_ * j_x + 0.5 * beta1_ * j_y;
+            df[n][D2Q9_.NW] = -0.5 * beta3_ * j_x + 0.5 * beta3_ * j_y;
+            df[n][D2Q9_.SE] = 0.5 * beta3_ * j_x - 0.5 * beta3_ * j_y;
+        }
+        else if (bottom && right)
+        {
+            df[n][D2Q9_.W]  = df[n][D2Q9_.E] - 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.N]  = df[n][D2Q9_.S] + 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.NW] = df[n][D2Q9_.SE] - 0.5 * beta1_ * j_x + 0.5 * beta1_ * j_y;
+            df[n][D2Q9_.NE] = 0.5 * beta3_ * j_x + 0.5 * beta3_ * j_y;
+            df[n][D2Q9_.SW] = -0.5 * beta3_ * j_x - 0.5 * beta3_ * j_y;
+        }
+        else if (top && left)
+        {
+            df[n][D2Q9_.E]  = df[n][D2Q9_.W] + 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.S]  = df[n][D2Q9_.N] - 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.SE] = df[n][D2Q9_.NW] + 0.5 * beta1_ * j_x - 0.5 * beta1_ * j_y;
+            df[n][D2Q9_.NE] = 0.5 * beta3_ * j_x + 0.5 * beta3_ * j_y;
+            df[n][D2Q9_.SW] = -0.5 * beta3_ * j_x - 0.5 * beta3_ * j_y;
+        }
+        else
+        {
+            df[n][D2Q9_.W]  = df[n][D2Q9_.E] - 2.0 * beta1_ * j_x;
+            df[n][D2Q9_.S]  = df[n][D2Q9_.N] - 2.0 * beta1_ * j_y;
+            df[n][D2Q9_.SW] = df[n][D2Q9_.NE] - 0.5 * beta1_ * j_x - 0.5 * beta1_ * j_y;
+            df[n][D2Q9_.NW] = -0.5 * beta3_ * j_x + 0.5 * beta3_ * j_y;
+            df[n][D2Q9_.SE] = 0.5 * beta3_ * j_x - 0.5 * beta3_ * j_y;
+        }
+        for (auto i = 1u; i < nc; ++i) rho_node -= df[n][i];
+        df[n][0] = rho_node;
+        return;
+    }
+    const auto side = getSide(n);
+    auto u_x = vel[0];
+    auto u_y = vel[1];
+    if (is_normal_flow_[param_[n]])
+    {
+        const auto n_fluid = right ? lb_.getNodeIndex(x - 1, y) :
+                             (top ? lb_.getNodeIndex(x, y - 1) :
+                             (left ? lb_.getNodeIndex(x + 1, y) : lb_.getNodeIndex(x, y + 1)));
+        u_x = field_.u[n_fluid][0];
+        u_y = field_.u[n_fluid][1];
+    }
+    const auto u_normal = (side == 0 || side == 2) ? u_x : u_y;
+    const auto sign = (side == 0 || side == 1) ? 1.0 : -1.0;
+    const auto rho_node = getKnownSum(df, n, side) / (1.0 + sign * u_normal / c);
+    setEdgeUnknowns(df, n, side, rho_node * u_x, rho_node * u_y);
+}
+
+template <>
+void nodeTypeField::applyRule<nodeTypeField::PRESSURE>
+(
+    latticeArray<double> &df,
+    std::size_t n
+)
+{
+    const auto c = lb_.getLatticeSpeed();
+    const auto side = getSide(n);
+    const auto rho_node = density_[param_[n]];
+    const auto sign = (side == 0 || side == 1) ? 1.0 : -1.0;
+    // normal velocity from rho * (1 + sign * u_n / c) = known sum
+    const auto u_normal = sign * c * (getKnownSum(df, n, side) / rho_node - 1.0);
+    const auto is_x = side == 0 || side == 2;
+    setEdgeUnknowns(df, n, side, is_x ? rho_node * u_normal : 0.0, is_x ? 0.0 : rho_node * u_normal);
+}
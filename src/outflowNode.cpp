@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "outflowNode.hpp"
+
+outflowNode::outflowNode
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field,
+    e_outflows outflow
+)
+: boundaryNode(false, false, lb),
+  nodes {},
+  cb_ (cb),
+  D2Q9_ (D2Q9),
+  field_ (field),
+  outflow_ {outflow},
+  u_convective_ {0.0},
+  is_convective_set_ {false},
+  rho_far_ {1.0},
+  sigma_ {0.25},
+  length_ {static_cast<double>(std::max(lb.getNumberOfNx(), lb.getNumberOfNy()))}
+{}
+
+void outflowNode::addNode
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto left   = x == 0;
+    const auto right  = x == nx - 1;
+    const auto bottom = y == 0;
+    const auto top    = y == ny - 1;
+    if ((top || bottom) && (left || right))
+    {
+        throw std::runtime_error("Outflow nodes cannot be corner nodes");
+    }
+    auto edge_i = -1;
+    if (right)  edge_i = 0;
+    if (top)    edge_i = 1;
+    if (left)   edge_i = 2;
+    if (bottom) edge_i = 3;
+    if (edge_i < 0) throw std::runtime_error("Outflow nodes must lie on an edge");
+    // the characteristic condition differentiates over two nodes inside
+    if (((left || right) && nx < 3) || ((top || bottom) && ny < 3))
+    {
+        throw std::runtime_error("Outflow nodes need two nodes inside the lattice");
+    }
+    nodes.push_back(latticeNode(x, y, lb_.getNodeIndex(x, y)));
+    nodes.back().corner = false;
+    nodes.back().index_i = edge_i;
+}
+
+void outflowNode::setConvectiveVelocity
+(
+    double u_convective
+)
+{
+    if (u_convective < 0.0) throw std::runtime_error("Convection velocity must not be negative");
+    u_convective_ = u_convective;
+    is_convective_set_ = true;
+}
+
+void outflowNode::setFarField
+(
+    double rho,
+    double sigma,
+    double length
+)
+{
+    rho_far_ = rho;
+    sigma_ = sigma;
+    length_ = length;
+}
+
+void outflowNode::updateNode
+(
+    latticeArray<double> &df,
+    bool is_modify_stream
+)
+{
+    if (is_modify_stream || nodes.empty()) return;
+    if (outflow_ == CONVECTIVE)
+    {
+        updateConvective(df);
+    }
+    else
+    {
+        updateCharacteristic(df);
+    }
+}
+
+void outflowNode::getRows
+(
+    std::size_t &first_row,
+    std::size_t &last_row
+) const
+{
+    getRowsOfNodes(nodes, 2, first_row, last_row);
+}
+
+void outflowNode::updateConvective
+(
+    latticeArray<double> &df
+)
+{
+    const auto c = lb_.getLatticeSpeed();
+    const auto nc = lb_.getNumberOfDirections();
+    auto u_convective = u_convective_;
+    if (!is_convective_set_)
+    {
+        u_convective = 0.0;
+        // mean outward velocity of the last step next to the outflow nodes
+        for (auto &node : nodes)
+        {
+            const auto o_x = node.index_i == 0 ? 1 : (node.index_i == 2 ? -1 : 0);
+            const auto o_y = node.index_i == 1 ? 1 : (node.index_i == 3 ? -1 : 0);
+            const auto u = field_.u[lb_.getNodeIndex(node.x_node - o_x, node.y_node - o_y)];
+            u_convective += std::max(u[0] * o_x + u[1] * o_y, 0.0);
+        }  // node
+        u_convective /= nodes.size();
+    }
+    const auto lambda = u_convective / c;
+    const auto relaxation = sigma_ * c / (std::sqrt(3.0) * length_) * lb_.getTimeStep();
+    for (auto &node : nodes)
+    {
+        const auto n = node.n_node;
+        const auto o_x = node.index_i == 0 ? 1 : (node.index_i == 2 ? -1 : 0);
+        const auto o_y = node.index_i == 1 ? 1 : (node.index_i == 3 ? -1 : 0);
+        const auto n_inside = lb_.getNodeIndex(node.x_node - o_x, node.y_node - o_y);
+        const auto is_first = node.df_node.empty();
+        auto rho = 0.0;
+        auto weight_unknown = 0.0;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            // distribution functions pointing into the lattice are unknown
+            if (D2Q9_.e[i][0] * o_x + D2Q9_.e[i][1] * o_y < 0.0)
+            {
+                df[n][i] = is_first ? df[n_inside][i] :
+                                      (node.df_node[i] + lambda * df[n_inside][i]) / (1.0 + lambda);
+                weight_unknown += D2Q9_.weight[i];
+            }
+            rho += df[n][i];
+        }  // i
+        // the convective condition does not fix the pressure level of a flow with
+        // a velocity inlet, the density is relaxed towards the far field like the
+        // incoming wave of the characteristic condition
+        const auto d_rho = relaxation * (rho_far_ - rho) / weight_unknown;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            if (D2Q9_.e[i][0] * o_x + D2Q9_.e[i][1] * o_y < 0.0) df[n][i] += D2Q9_.weight[i] * d_rho;
+        }  // i
+        node.df_node.assign(df[n], df[n] + nc);
+    }  // node
+}
+
+void outflowNode::updateCharacteristic
+(
+    latticeArray<double> &df
+)
+{
+    const auto c = lb_.getLatticeSpeed();
+    const auto nc = lb_.getNumberOfDirections();
+    const auto dl = lb_.getSpaceStep();
+    const auto dt = lb_.getTimeStep();
+    const auto cs = c / std::sqrt(3.0);
+    const auto cs_sqr = cs * cs;
+    for (auto &node : nodes)
+    {
+        const auto n = node.n_node;
+        const auto o_x = node.index_i == 0 ? 1 : (node.index_i == 2 ? -1 : 0);
+        const auto o_y = node.index_i == 1 ? 1 : (node.index_i == 3 ? -1 : 0);
+        const auto n_1 = lb_.getNodeIndex(node.x_node - o_x, node.y_node - o_y);
+        const auto n_2 = lb_.getNodeIndex(node.x_node - 2 * o_x, node.y_node - 2 * o_y);
+        // density, outward normal and tangential velocity of the last step, the
+        // tangent (-o_y, o_x)
+        auto normal = [&](std::size_t m) { return field_.u[m][0] * o_x + field_.u[m][1] * o_y; };
+        auto tangent = [&](std::size_t m) { return -field_.u[m][0] * o_y + field_.u[m][1] * o_x; };
+        const auto rho = cb_.rho_[n];
+        const auto u_n = normal(n);
+        const auto u_t = tangent(n);
+        // one-sided second-order differences along the outward normal
+        const auto d_rho = (3.0 * rho - 4.0 * cb_.rho_[n_1] + cb_.rho_[n_2]) / (2.0 * dl);
+        const auto d_u_n = (3.0 * u_n - 4.0 * normal(n_1) + normal(n_2)) / (2.0 * dl);
+        const auto d_u_t = (3.0 * u_t - 4.0 * tangent(n_1) + tangent(n_2)) / (2.0 * dl);
+        // amplitudes of the acoustic waves travelling with u_n + cs and u_n - cs and
+        // of the shear wave travelling with u_n, p = cs^2 * rho
+        const auto wave_out = (u_n + cs) * (cs_sqr * d_rho + rho * cs * d_u_n);
+        auto wave_in = (u_n - cs) * (cs_sqr * d_rho - rho * cs * d_u_n);
+        if (u_n < cs)
+        {
+            const auto mach = u_n / cs;
+            wave_in = sigma_ * (1.0 - mach * mach) * cs / length_ * cs_sqr * (rho - rho_far_);
+        }
+        const auto wave_shear = u_n > 0.0 ? u_n * d_u_t : 0.0;
+        const auto rho_node = rho - dt * (wave_out + wave_in) / (2.0 * cs_sqr);
+        const auto u_n_node = u_n - dt * (wave_out - wave_in) / (2.0 * rho * cs);
+        const auto u_t_node = u_t - dt * wave_shear;
+        const auto u_x = u_n_node * o_x - u_t_node * o_y;
+        const auto u_y = u_n_node * o_y + u_t_node * o_x;
+        // macroscopic values of the streamed neighbour for its non-equilibrium part
+        auto rho_1 = 0.0;
+        auto j_x = 0.0;
+        auto j_y = 0.0;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            rho_1 += df[n_1][i];
+            j_x += df[n_1][i] * D2Q9_.e[i][0];
+            j_y += df[n_1][i] * D2Q9_.e[i][1];
+        }  // i
+        for (auto i = 0u; i < nc; ++i)
+        {
+            df[n][i] = getEquilibrium(i, rho_node, u_x, u_y) + df[n_1][i] -
+                       getEquilibrium(i, rho_1, j_x / rho_1, j_y / rho_1);
+        }  // i
+    }  // node
+}
+
+double outflowNode::getEquilibrium
+(
+    std::size_t i,
+    double rho,
+    double u_x,
+    double u_y
+) const
+{
+    const auto c = lb_.getLatticeSpeed();
+    const auto cs_sqr = c * c / 3.0;
+    const auto c_dot_u = D2Q9_.e[i][0] * u_x + D2Q9_.e[i][1] * u_y;
+    const auto u_sqr = u_x * u_x + u_y * u_y;
+    return D2Q9_.weight[i] * rho * (1.0 + c_dot_u / cs_sqr + 0.5 * c_dot_u * c_dot_u /
+                                    (cs_sqr * cs_sqr) - 0.5 * u_sqr / cs_sqr);
+}
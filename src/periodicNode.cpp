@@ -0,0 +1,108 @@
+#include <stdexcept>
+#include <vector>
+
+#include "latticeBase.hpp"
+#include "latticeNode.hxx"
+
+#include "latticeModel.hxx"
+
+#include "boundaryNode.hxx"
+#include "nodeTypeField.hpp"
+#include "periodicNode.hpp"
+
+periodicNode::periodicNode
+(
+    latticeBase &lb,
+    latticeModelD2Q9 &D2Q9
+)
+: boundaryNode(true, true, lb),
+  nodes {},
+  link_node_ {},
+  link_direction_ {},
+  link_source_ {},
+  is_links_built_ {false},
+  D2Q9_ (D2Q9)
+{}
+
+void periodicNode::addNode
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (x >= nx || y >= ny) throw std::runtime_error("Node outside of lattice");
+    if (x != 0 && x != nx - 1 && y != 0 && y != ny - 1)
+    {
+        throw std::runtime_error("Periodic nodes must lie on an edge");
+    }
+    const auto n = lb_.getNodeIndex(x, y);
+    nodes.push_back(latticeNode(x, y, n));
+    // the copy of the distribution functions keeps its memory between steps
+    nodes.back().df_node.assign(lb_.getNumberOfDirections(), 0.0);
+    position.push_back(n);
+    is_links_built_ = false;
+}
+
+void periodicNode::registerNodes
+(
+    nodeTypeField &types
+)
+{
+    for (auto &node : nodes) types.addPeriodic(node.x_node, node.y_node);
+}
+
+void periodicNode::buildLinks()
+{
+    const long nx = lb_.getNumberOfNx();
+    const long ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    std::vector<long> node_of(nx * ny, -1);
+    for (auto k = 0u; k < nodes.size(); ++k) node_of[nodes[k].n_node] = k;
+    link_node_.clear();
+    link_direction_.clear();
+    link_source_.clear();
+    for (auto k = 0u; k < nodes.size(); ++k)
+    {
+        const long x = nodes[k].x_node;
+        const long y = nodes[k].y_node;
+        for (auto i = 1u; i < nc; ++i)
+        {
+            // upstream neighbour the distribution function streams in from
+            const long x_up = x - (D2Q9_.e[i][0] > 0.0) + (D2Q9_.e[i][0] < 0.0);
+            const long y_up = y - (D2Q9_.e[i][1] > 0.0) + (D2Q9_.e[i][1] < 0.0);
+            if (x_up >= 0 && x_up < nx && y_up >= 0 && y_up < ny) continue;
+            const auto source = node_of[lb_.getNodeIndex((x_up + nx) % nx, (y_up + ny) % ny)];
+            if (source < 0) continue;
+            link_node_.push_back(k);
+            link_direction_.push_back(i);
+            link_source_.push_back(source);
+        }  // i
+    }  // k
+    is_links_built_ = true;
+}
+
+void periodicNode::updateNode
+(
+    latticeArray<double> &df,
+    bool is_modify_stream
+)
+{
+    if (!is_links_built_) buildLinks();
+    if (!is_modify_stream)
+    {
+        const auto nc = lb_.getNumberOfDirections();
+        for (auto &node : nodes)
+        {
+            const auto *f = df[node.n_node];
+            for (auto i = 0u; i < nc; ++i) node.df_node[i] = f[i];
+        }  // node
+        return;
+    }
+    for (auto l = 0u; l < link_node_.size(); ++l)
+    {
+        const auto i = link_direction_[l];
+        df[nodes[link_node_[l]].n_node][i] = nodes[link_source_[l]].df_node[i];
+    }  // l
+}
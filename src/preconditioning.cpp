@@ -0,0 +1,53 @@
+#include <stdexcept>
+#include <vector>
+
+#include "latticeArray.hxx"
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "preconditioning.hpp"
+
+double checkPreconditioning
+(
+    double gamma
+)
+{
+    if (!(gamma > 0.0 && gamma <= 1.0))
+    {
+        throw std::runtime_error("Preconditioning parameter must be in (0, 1]");
+    }
+    return gamma;
+}
+
+void computePreconditionedfEq
+(
+    const latticeBase &lb,
+    const latticeModelD2Q9 &D2Q9,
+    const fluidField &field,
+    const std::vector<double> &rho,
+    double gamma,
+    latticeArray<double> &eqdf
+)
+{
+    const auto nx = lb.getNumberOfNx();
+    const auto ny = lb.getNumberOfNy();
+    const auto nd = lb.getNumberOfDimensions();
+    const auto nc = lb.getNumberOfDirections();
+    const auto c = lb.getLatticeSpeed();
+    const auto cs_sqr = c * c / 3.0;
+    for (auto n = 0u; n < nx * ny; ++n)
+    {
+        const auto u = field.u[n];
+        double u_sqr = 0.0;
+        for (auto d = 0u; d < nd; ++d) u_sqr += u[d] * u[d];
+        u_sqr /= 2.0 * gamma * cs_sqr;
+        for (auto i = 0u; i < nc; ++i)
+        {
+            double c_dot_u = 0.0;
+            for (auto d = 0u; d < nd; ++d) c_dot_u += D2Q9.e[i][d] * u[d];
+            c_dot_u /= cs_sqr;
+            eqdf[n][i] = D2Q9.weight[i] * rho[n] *
+                         (1.0 + c_dot_u * (1.0 + c_dot_u / (2.0 * gamma)) - u_sqr);
+        }  // i
+    }  // n
+}
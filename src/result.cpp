@@ -1,20 +1,124 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "latticeModel.hxx"
+#include "latticeArray.hxx"
 
 #include "latticeBase.hpp"
+#include "lossyCodec.hpp"
+#include "flowStatistics.hpp"
 #include "result.hpp"
 
+namespace
+{
+    // First bytes of a .lbmz file
+    const char lbmz_magic[] = {'L', 'B', 'M', 'Z'};
+
+    // Version of the .lbmz format
+    const std::uint64_t lbmz_version = 1;
+
+    // Extension of compressed files
+    const std::string lbmz_extension = ".lbmz";
+
+    // Longest field name of a .lbmz file
+    const std::uint64_t max_name_length = 256;
+
+    // Writes an unsigned integer of the .lbmz header
+    void writeHeader(std::ostream &out, std::uint64_t value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // Reads an unsigned integer of the .lbmz header
+    std::uint64_t readHeader(std::istream &in)
+    {
+        std::uint64_t value = 0;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+        {
+            throw std::runtime_error("Truncated .lbmz file");
+        }
+        return value;
+    }
+
+    // Counts the bytes of a stream after the read position
+    std::uint64_t getRemainingBytes(std::istream &in)
+    {
+        const auto position = in.tellg();
+        in.seekg(0, std::ios::end);
+        const auto end = in.tellg();
+        in.seekg(position);
+        if (position < 0 || end < position) throw std::runtime_error("Unreadable .lbmz file");
+        return static_cast<std::uint64_t>(end - position);
+    }
+
+    // Writes the header and the coordinates of a .vtk file of a rectilinear grid
+    void writeVTKHeader(std::ofstream &vtk_file, const std::string &title, std::size_t nx,
+                        std::size_t ny)
+    {
+        vtk_file << "# vtk DataFile Version 3.0" << std::endl;
+        vtk_file << title << std::endl;
+        vtk_file << "ASCII" << std::endl;
+        vtk_file << "DATASET RECTILINEAR_GRID" << std::endl;
+        vtk_file << "DIMENSIONS " << nx << " " << ny << " 1" << std::endl;
+
+        // Write x, y, z coordinates. z set to be 1 since it's 2D
+        vtk_file << "X_COORDINATES " << nx << " float" << std::endl;
+        for (auto x = 0u; x < nx; ++x) vtk_file << x << " ";
+        vtk_file << std::endl;
+        vtk_file << "Y_COORDINATES " << ny << " float" << std::endl;
+        for (auto y = 0u; y < ny; ++y) vtk_file << y << " ";
+        vtk_file << std::endl;
+        vtk_file << "Z_COORDINATES " << 1 << " float" << std::endl;
+        vtk_file << 0 << std::endl;
+        vtk_file << "POINT_DATA " << nx * ny << std::endl;
+    }
+
+    // Writes a scalar field of a .vtk file, values stored row-wise
+    void writeVTKScalars(std::ofstream &vtk_file, const std::string &name,
+                         const std::vector<double> &values)
+    {
+        vtk_file << "SCALARS " << name << " float" << std::endl;
+        vtk_file << "LOOKUP_TABLE default" << std::endl;
+        for (auto value : values) vtk_file << value << std::endl;
+    }
+
+    // Writes a vector field of a .vtk file, components stored row-wise
+    void writeVTKVectors(std::ofstream &vtk_file, const std::string &name,
+                         const std::vector<double> &u_x, const std::vector<double> &u_y)
+    {
+        vtk_file << "VECTORS " << name << " float" << std::endl;
+        for (auto n = 0u; n < u_x.size(); ++n) vtk_file << u_x[n] << " " << u_y[n] << " 0" << std::endl;
+    }
+}
+
 result::result
 (
     latticeBase &lb,
     fluidField &field
 )
 : lb_ (lb),
-  field_ (field)
+  field_ (field),
+  folder_ {"vtk_fluid"}
+{
+    auto results = result::initializeCleanFolder();
+    if (results != 0) throw std::runtime_error("Error in folder initialization");
+}
+
+result::result
+(
+    latticeBase &lb,
+    fluidField &field,
+    const std::string &folder
+)
+: lb_ (lb),
+  field_ (field),
+  folder_ {folder}
 {
     auto results = result::initializeCleanFolder();
     if (results != 0) throw std::runtime_error("Error in folder initialization");
@@ -23,8 +127,8 @@ result::result
 int result::initializeCleanFolder()
 {
     // creates output folders if they don't exist
-    auto vtk_folder = system("mkdir -p vtk_fluid");
-    auto old_vtk_fluid_files = system("rm -f vtk_fluid/*");
+    auto vtk_folder = system(("mkdir -p " + folder_).c_str());
+    auto old_vtk_fluid_files = system(("rm -f " + folder_ + "/*").c_str());
     return vtk_folder + old_vtk_fluid_files;
 }
 
@@ -32,32 +136,260 @@ void result::writeResultVTK(int time)
 {
     const auto nx = lb_.getNumberOfNx();
     const auto ny = lb_.getNumberOfNy();
+    writeVTK(folder_ + "/fluid_t" + std::to_string(time) + ".vtk", nx, ny,
+             getComponent(field_.p.data(), 1, 0), getComponent(field_.u.data(), field_.u.width(), 0),
+             getComponent(field_.u.data(), field_.u.width(), 1));
+}
+
+void result::writeStatisticsVTK
+(
+    int time,
+    const flowStatistics &statistics
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    std::ofstream vtk_file;
+    vtk_file.open(folder_ + "/statistics_t" + std::to_string(time) + ".vtk");
+    writeVTKHeader(vtk_file, "fluid_statistics", nx, ny);
+    writeVTKScalars(vtk_file, "mean_pressure", getStatistic(statistics, flowStatistics::MEAN_PRESSURE));
+    writeVTKVectors(vtk_file, "mean_velocity", getStatistic(statistics, flowStatistics::MEAN_VELOCITY_X),
+                    getStatistic(statistics, flowStatistics::MEAN_VELOCITY_Y));
+    writeVTKScalars(vtk_file, "pressure_variance",
+                    getStatistic(statistics, flowStatistics::PRESSURE_VARIANCE));
+    writeVTKScalars(vtk_file, "reynolds_stress_xx",
+                    getStatistic(statistics, flowStatistics::REYNOLDS_STRESS_XX));
+    writeVTKScalars(vtk_file, "reynolds_stress_yy",
+                    getStatistic(statistics, flowStatistics::REYNOLDS_STRESS_YY));
+    writeVTKScalars(vtk_file, "reynolds_stress_xy",
+                    getStatistic(statistics, flowStatistics::REYNOLDS_STRESS_XY));
+    vtk_file.close();
+}
+
+lossyCodec::statistics result::writeResultCompressed
+(
+    int time,
+    const lossyCodec &codec
+)
+{
+    return writeCompressed(time, codec, nullptr);
+}
+
+lossyCodec::statistics result::writeResultCompressed
+(
+    int time,
+    const lossyCodec &codec,
+    const latticeArray<double> &df
+)
+{
+    return writeCompressed(time, codec, &df);
+}
+
+int result::readResultCompressed
+(
+    const std::string &file_name,
+    latticeArray<double> &df
+)
+{
+    const auto fields = readCompressed(file_name);
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    if (fields.nx != nx || fields.ny != ny || fields.names.size() != 3 || fields.names[2] != "df" ||
+        fields.components[1].size() != field_.u.width() || fields.components[2].size() != df.width())
+    {
+        throw std::runtime_error(file_name + " does not match the lattice");
+    }
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lb_.getNodeIndex(x, y);
+            const auto k = y * nx + x;
+            field_.p[n] = fields.components[0][0][k];
+            for (auto d = 0u; d < field_.u.width(); ++d) field_.u[n][d] = fields.components[1][d][k];
+            for (auto i = 0u; i < df.width(); ++i) df[n][i] = fields.components[2][i][k];
+        }  // x
+    }  // y
+    return fields.time;
+}
+
+std::string result::convertToVTK
+(
+    const std::string &file_name
+)
+{
+    const auto fields = readCompressed(file_name);
+    if (fields.names.size() < 2 || fields.components[1].size() < 2)
+    {
+        throw std::runtime_error(file_name + " holds no pressure and velocity");
+    }
+    auto vtk_name = file_name;
+    if (vtk_name.size() > lbmz_extension.size() &&
+        vtk_name.compare(vtk_name.size() - lbmz_extension.size(), lbmz_extension.size(),
+                         lbmz_extension) == 0)
+    {
+        vtk_name.erase(vtk_name.size() - lbmz_extension.size());
+    }
+    vtk_name += ".vtk";
+    writeVTK(vtk_name, fields.nx, fields.ny, fields.components[0][0], fields.components[1][0],
+             fields.components[1][1]);
+    return vtk_name;
+}
+
+void result::writeVTK
+(
+    const std::string &file_name,
+    std::size_t nx,
+    std::size_t ny,
+    const std::vector<double> &p,
+    const std::vector<double> &u_x,
+    const std::vector<double> &u_y
+)
+{
     std::ofstream vtk_file;
-    vtk_file.open("vtk_fluid/fluid_t" + std::to_string(time) + ".vtk");
-    vtk_file << "# vtk DataFile Version 3.0" << std::endl;
-    vtk_file << "fluid_state" << std::endl;
-    vtk_file << "ASCII" << std::endl;
-    vtk_file << "DATASET RECTILINEAR_GRID" << std::endl;
-    vtk_file << "DIMENSIONS " << nx << " " << ny << " 1" << std::endl;
-
-    // Write x, y, z coordinates. z set to be 1 since it's 2D
-    vtk_file << "X_COORDINATES " << nx << " float" << std::endl;
-    for (auto x = 0u; x < nx; ++x) vtk_file << x << " ";
-    vtk_file << std::endl;
-    vtk_file << "Y_COORDINATES " << ny << " float" << std::endl;
-    for (auto y = 0u; y < ny; ++y) vtk_file << y << " ";
-    vtk_file << std::endl;
-    vtk_file << "Z_COORDINATES " << 1 << " float" << std::endl;
-    vtk_file << 0 << std::endl;
-    vtk_file << "POINT_DATA " << nx * ny << std::endl;
-
-    // Write relative pressure
-    vtk_file << "SCALARS relative_pressure float" << std::endl;
-    vtk_file << "LOOKUP_TABLE default" << std::endl;
-    for (auto pressure : field_.p) vtk_file << pressure << std::endl;
+    vtk_file.open(file_name);
+    writeVTKHeader(vtk_file, "fluid_state", nx, ny);
+
+    // Write relative pressure, VTK expects the points row-wise
+    writeVTKScalars(vtk_file, "relative_pressure", p);
 
     // Write velocity as vectors
-    vtk_file << "VECTORS velocity_vector float" << std::endl;
-    for (auto v : field_.u) vtk_file << v[0] << " " << v[1] << " 0" << std::endl;
+    writeVTKVectors(vtk_file, "velocity_vector", u_x, u_y);
     vtk_file.close();
 }
+
+result::compressedFields result::readCompressed
+(
+    const std::string &file_name
+)
+{
+    std::ifstream in(file_name, std::ios::binary);
+    if (!in) throw std::runtime_error("Error in opening " + file_name);
+    char magic[sizeof(lbmz_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, lbmz_magic, sizeof(magic)) != 0 ||
+        readHeader(in) != lbmz_version)
+    {
+        throw std::runtime_error(file_name + " is not a .lbmz file");
+    }
+    compressedFields fields;
+    fields.nx = readHeader(in);
+    fields.ny = readHeader(in);
+    fields.time = static_cast<int>(static_cast<std::int64_t>(readHeader(in)));
+    // the sizes in the header must fit into the rest of the file before
+    // anything is allocated for them
+    const auto min_component_bytes = lossyCodec::getMinimumCompressedSize(fields.nx, fields.ny);
+    if (fields.nx == 0 || fields.ny == 0 || min_component_bytes > getRemainingBytes(in))
+    {
+        throw std::runtime_error(file_name + " has an invalid lattice size");
+    }
+    const auto num_fields = readHeader(in);
+    if (num_fields > getRemainingBytes(in) / (2 * sizeof(std::uint64_t)))
+    {
+        throw std::runtime_error(file_name + " has an invalid number of fields");
+    }
+    for (auto f = 0u; f < num_fields; ++f)
+    {
+        const auto name_length = readHeader(in);
+        if (name_length > max_name_length || name_length > getRemainingBytes(in))
+        {
+            throw std::runtime_error(file_name + " has an invalid field name");
+        }
+        std::string name(name_length, ' ');
+        if (!in.read(&name[0], name.size())) throw std::runtime_error("Truncated .lbmz file");
+        fields.names.push_back(name);
+        const auto num_components = readHeader(in);
+        if (num_components > getRemainingBytes(in) / min_component_bytes)
+        {
+            throw std::runtime_error(file_name + " has an invalid number of components");
+        }
+        fields.components.emplace_back(num_components);
+        for (auto &component : fields.components.back())
+        {
+            lossyCodec::decompress(in, fields.nx, fields.ny, component);
+        }  // component
+    }  // f
+    return fields;
+}
+
+std::vector<double> result::getComponent
+(
+    const double *values,
+    std::size_t width,
+    std::size_t d
+) const
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    std::vector<double> component(nx * ny);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x) component[y * nx + x] = values[lb_.getNodeIndex(x, y) * width + d];
+    }  // y
+    return component;
+}
+
+std::vector<double> result::getStatistic
+(
+    const flowStatistics &statistics,
+    flowStatistics::e_quantities quantity
+) const
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    std::vector<double> values(nx * ny);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            values[y * nx + x] = statistics.getValue(lb_.getNodeIndex(x, y), quantity);
+        }  // x
+    }  // y
+    return values;
+}
+
+lossyCodec::statistics result::writeCompressed
+(
+    int time,
+    const lossyCodec &codec,
+    const latticeArray<double> *df
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto file_name = folder_ + "/fluid_t" + std::to_string(time) + lbmz_extension;
+    std::ofstream out(file_name, std::ios::binary);
+    if (!out) throw std::runtime_error("Error in creating " + file_name);
+    out.write(lbmz_magic, sizeof(lbmz_magic));
+    writeHeader(out, lbmz_version);
+    writeHeader(out, nx);
+    writeHeader(out, ny);
+    writeHeader(out, static_cast<std::uint64_t>(static_cast<std::int64_t>(time)));
+    // the names of the .vtk fields, the distribution functions go last
+    std::vector<std::string> names {"relative_pressure", "velocity_vector"};
+    std::vector<const double*> values {field_.p.data(), field_.u.data()};
+    std::vector<std::size_t> widths {1, field_.u.width()};
+    if (df)
+    {
+        names.push_back("df");
+        values.push_back(df->data());
+        widths.push_back(df->width());
+    }
+    writeHeader(out, names.size());
+    auto stats = lossyCodec::statistics {0, 0, 0.0};
+    for (auto f = 0u; f < names.size(); ++f)
+    {
+        writeHeader(out, names[f].size());
+        out.write(names[f].data(), names[f].size());
+        writeHeader(out, widths[f]);
+        for (auto d = 0u; d < widths[f]; ++d)
+        {
+            const auto component = codec.compress(getComponent(values[f], widths[f], d), nx, ny, out);
+            stats.raw_bytes += component.raw_bytes;
+            stats.max_error = std::max(stats.max_error, component.max_error);
+        }  // d
+    }  // f
+    stats.compressed_bytes = static_cast<std::size_t>(out.tellp());
+    out.close();
+    if (!out) throw std::runtime_error("Error in writing " + file_name);
+    return stats;
+}
@@ -0,0 +1,244 @@
+#ifdef USE_HDF5
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+#include <zlib.h>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+
+#include "latticeBase.hpp"
+#include "resultHDF5.hpp"
+
+resultHDF5::resultHDF5
+(
+    latticeBase &lb,
+    fluidField &field,
+    const std::string &file_name,
+    std::size_t chunk_size,
+    int compression_level
+)
+: lb_ (lb),
+  field_ (field),
+  file_name_ {file_name},
+  file_ {-1},
+  chunk_size_ {chunk_size},
+  compression_ (3, compression_level),
+  times_ {}
+{
+    if (chunk_size_ == 0) throw std::runtime_error("Chunk size must be positive");
+    if (compression_level < 0 || compression_level > 9)
+    {
+        throw std::runtime_error("Compression level must be between 0 and 9");
+    }
+    file_ = H5Fcreate(file_name_.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (file_ < 0) throw std::runtime_error("Error in creating " + file_name_);
+}
+
+resultHDF5::~resultHDF5()
+{
+    if (file_ >= 0) H5Fclose(file_);
+}
+
+void resultHDF5::setCompression
+(
+    e_fields field,
+    int compression_level
+)
+{
+    if (compression_level < 0 || compression_level > 9)
+    {
+        throw std::runtime_error("Compression level must be between 0 and 9");
+    }
+    compression_[field] = compression_level;
+}
+
+void resultHDF5::writeResult
+(
+    int time
+)
+{
+    const auto group_name = "t" + std::to_string(time);
+    if (H5Lexists(file_, group_name.c_str(), H5P_DEFAULT) > 0) return;
+    auto group = H5Gcreate2(file_, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group < 0) throw std::runtime_error("Error in creating group " + group_name);
+    writeDataset(group, "pressure", field_.p.data(), 1, compression_[PRESSURE]);
+    writeDataset(group, "velocity", field_.u.data(), field_.u.width(), compression_[VELOCITY]);
+    H5Gclose(group);
+    H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    times_.push_back(std::make_pair(time, false));
+    writeXDMF();
+}
+
+void resultHDF5::writeResult
+(
+    int time,
+    const latticeArray<double> &df
+)
+{
+    const auto group_name = "t" + std::to_string(time);
+    if (H5Lexists(file_, group_name.c_str(), H5P_DEFAULT) > 0) return;
+    auto group = H5Gcreate2(file_, group_name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group < 0) throw std::runtime_error("Error in creating group " + group_name);
+    writeDataset(group, "pressure", field_.p.data(), 1, compression_[PRESSURE]);
+    writeDataset(group, "velocity", field_.u.data(), field_.u.width(), compression_[VELOCITY]);
+    writeDataset(group, "df", df.data(), df.width(), compression_[DISTRIBUTION]);
+    H5Gclose(group);
+    H5Fflush(file_, H5F_SCOPE_GLOBAL);
+    times_.push_back(std::make_pair(time, true));
+    writeXDMF();
+}
+
+void resultHDF5::writeDataset
+(
+    hid_t group,
+    const std::string &name,
+    const double *data,
+    std::size_t width,
+    int compression_level
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto cx = std::min(chunk_size_, nx);
+    const auto cy = std::min(chunk_size_, ny);
+    const auto rank = width > 1 ? 3 : 2;
+    const hsize_t dims[3] = {ny, nx, width};
+    const hsize_t chunk[3] = {cy, cx, width};
+    auto dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, rank, chunk);
+    if (compression_level > 0)
+    {
+        H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, compression_level);
+    }
+    auto space = H5Screate_simple(rank, dims, nullptr);
+    auto dataset = H5Dcreate2(group, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, dcpl,
+                              H5P_DEFAULT);
+    H5Sclose(space);
+    H5Pclose(dcpl);
+    if (dataset < 0) throw std::runtime_error("Error in creating dataset " + name);
+
+    // Prepare every chunk in parallel: copy, byte shuffle and deflate exactly as
+    // the HDF5 filter pipeline would, partial edge chunks are padded with zeros
+    const long num_cx = (nx + cx - 1) / cx;
+    const long num_chunks = num_cx * ((ny + cy - 1) / cy);
+    const auto chunk_values = cy * cx * width;
+    const auto chunk_bytes = chunk_values * sizeof(double);
+    std::vector<std::vector<unsigned char>> chunks(num_chunks);
+    auto is_failed = false;
+    #pragma omp parallel for schedule(dynamic)
+    for (long k = 0; k < num_chunks; ++k)
+    {
+        const auto y0 = (k / num_cx) * cy;
+        const auto x0 = (k % num_cx) * cx;
+        std::vector<double> values(chunk_values, 0.0);
+        for (auto y = y0; y < std::min(y0 + cy, ny); ++y)
+        {
+            for (auto x = x0; x < std::min(x0 + cx, nx); ++x)
+            {
+                const auto n = lb_.getNodeIndex(x, y);
+                std::copy(data + n * width, data + (n + 1) * width,
+                          begin(values) + ((y - y0) * cx + x - x0) * width);
+            }  // x
+        }  // y
+        auto bytes = reinterpret_cast<const unsigned char*>(values.data());
+        if (compression_level == 0)
+        {
+            chunks[k].assign(bytes, bytes + chunk_bytes);
+            continue;
+        }
+        std::vector<unsigned char> shuffled(chunk_bytes);
+        for (auto e = 0u; e < chunk_values; ++e)
+        {
+            for (auto b = 0u; b < sizeof(double); ++b)
+            {
+                shuffled[b * chunk_values + e] = bytes[e * sizeof(double) + b];
+            }  // b
+        }  // e
+        auto compressed_size = compressBound(chunk_bytes);
+        chunks[k].resize(compressed_size);
+        if (compress2(chunks[k].data(), &compressed_size, shuffled.data(), chunk_bytes,
+                      compression_level) != Z_OK)
+        {
+            #pragma omp critical
+            is_failed = true;
+        }
+        chunks[k].resize(compressed_size);
+    }  // k
+    if (is_failed)
+    {
+        H5Dclose(dataset);
+        throw std::runtime_error("Error in compressing dataset " + name);
+    }
+    for (long k = 0; k < num_chunks; ++k)
+    {
+        const hsize_t offset[3] = {(k / num_cx) * cy, (k % num_cx) * cx, 0};
+        if (H5Dwrite_chunk(dataset, H5P_DEFAULT, 0, offset, chunks[k].size(), chunks[k].data()) < 0)
+        {
+            H5Dclose(dataset);
+            throw std::runtime_error("Error in writing dataset " + name);
+        }
+    }  // k
+    H5Dclose(dataset);
+}
+
+void resultHDF5::writeXDMF()
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nd = lb_.getNumberOfDimensions();
+    const auto nc = lb_.getNumberOfDirections();
+    // datasets are referenced relative to the index, which lies next to the file
+    const auto slash = file_name_.find_last_of('/');
+    const auto h5_name = slash == std::string::npos ? file_name_ : file_name_.substr(slash + 1);
+    const auto dot = file_name_.find_last_of('.');
+    const auto is_extension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    const auto xdmf_name = (is_extension ? file_name_.substr(0, dot) : file_name_) + ".xmf";
+    const auto grid_dims = std::to_string(ny) + " " + std::to_string(nx);
+    std::ofstream xdmf_file;
+    xdmf_file.open(xdmf_name);
+    xdmf_file << "<?xml version=\"1.0\" ?>" << std::endl;
+    xdmf_file << "<Xdmf Version=\"3.0\">" << std::endl;
+    xdmf_file << " <Domain>" << std::endl;
+    xdmf_file << "  <Grid Name=\"fluid\" GridType=\"Collection\" CollectionType=\"Temporal\">" << std::endl;
+    for (auto &time : times_)
+    {
+        const auto path = h5_name + ":/t" + std::to_string(time.first) + "/";
+        xdmf_file << "   <Grid Name=\"t" << time.first << "\" GridType=\"Uniform\">" << std::endl;
+        xdmf_file << "    <Time Value=\"" << time.first << "\"/>" << std::endl;
+        xdmf_file << "    <Topology TopologyType=\"2DCoRectMesh\" Dimensions=\"" << grid_dims << "\"/>" << std::endl;
+        xdmf_file << "    <Geometry GeometryType=\"ORIGIN_DXDY\">" << std::endl;
+        xdmf_file << "     <DataItem Dimensions=\"2\" Format=\"XML\">0 0</DataItem>" << std::endl;
+        xdmf_file << "     <DataItem Dimensions=\"2\" Format=\"XML\">1 1</DataItem>" << std::endl;
+        xdmf_file << "    </Geometry>" << std::endl;
+        xdmf_file << "    <Attribute Name=\"relative_pressure\" AttributeType=\"Scalar\" Center=\"Node\">" << std::endl;
+        xdmf_file << "     <DataItem Dimensions=\"" << grid_dims << "\" NumberType=\"Float\" Precision=\"8\" "
+                  << "Format=\"HDF\">" << path << "pressure</DataItem>" << std::endl;
+        xdmf_file << "    </Attribute>" << std::endl;
+        xdmf_file << "    <Attribute Name=\"velocity_vector\" AttributeType=\"Vector\" Center=\"Node\">" << std::endl;
+        xdmf_file << "     <DataItem Dimensions=\"" << grid_dims << " " << nd << "\" NumberType=\"Float\" "
+                  << "Precision=\"8\" Format=\"HDF\">" << path << "velocity</DataItem>" << std::endl;
+        xdmf_file << "    </Attribute>" << std::endl;
+        if (time.second)
+        {
+            xdmf_file << "    <Attribute Name=\"df\" AttributeType=\"Matrix\" Center=\"Node\">" << std::endl;
+            xdmf_file << "     <DataItem Dimensions=\"" << grid_dims << " " << nc << "\" NumberType=\"Float\" "
+                      << "Precision=\"8\" Format=\"HDF\">" << path << "df</DataItem>" << std::endl;
+            xdmf_file << "    </Attribute>" << std::endl;
+        }
+        xdmf_file << "   </Grid>" << std::endl;
+    }  // time
+    xdmf_file << "  </Grid>" << std::endl;
+    xdmf_file << " </Domain>" << std::endl;
+    xdmf_file << "</Xdmf>" << std::endl;
+    xdmf_file.close();
+}
+
+#endif // USE_HDF5
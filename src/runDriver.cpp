@@ -0,0 +1,801 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+#include "momentComputing.h"
+
+#include "latticeBase.hpp"
+#include "latticeD2Q9.hpp"
+#include "collisionD2Q9_BGK.hpp"
+#include "collisionD2Q9_MRT.hpp"
+#include "collisionD2Q9_RBGK.hpp"
+#include "collisionD2Q9_CM.hpp"
+#include "collisionD2Q9_BGK_LES.hpp"
+#include "collisionD2Q9_MRT_LES.hpp"
+#include "collisionD2Q9_BGK_PRE.hpp"
+#include "collisionD2Q9_MRT_PRE.hpp"
+#include "streamD2Q9.hpp"
+#include "nodeTypeField.hpp"
+#include "outflowNode.hpp"
+#include "latticeBoltzmann.hpp"
+#include "result.hpp"
+#include "diagnostics.hpp"
+#include "flowStatistics.hpp"
+#include "tracerParticles.hpp"
+#include "telemetry.hpp"
+#include "autotuner.hpp"
+#include "loadBalancer.hpp"
+#include "runDriver.hpp"
+
+namespace
+{
+    // Names of the edges in scenario files, indexed by e_edges
+    const char *edge_names[] = {"right", "top", "left", "bottom"};
+
+    // Suffix of scenario files in a queue directory
+    const std::string scenario_suffix = ".scn";
+
+    // Names of the edge boundaries in the problem signature of the autotuner,
+    // indexed by e_edge_boundaries
+    const char *boundary_names[] = {"wall", "velocity", "pressure", "periodic", "convective",
+                                    "characteristic"};
+
+    // Sets the initial pressure and velocity of a case
+    void initializeField
+    (
+        const runDriver::scenario &sc,
+        fluidField &field
+    )
+    {
+        std::fill(field.p.begin(), field.p.end(), 0.0);
+        for (auto n = 0u; n < field.u.size(); ++n)
+        {
+            for (auto d = 0u; d < field.u.width(); ++d) field.u[n][d] = sc.u0[d];
+        }  // n
+    }
+
+    // Cost of a link from a fluid node to a wall or out of the lattice relative
+    // to the cost of a fluid node
+    const double boundary_link_weight = 1.0;
+
+    // Creates the load balancer of a case and hands it to the collision model,
+    // nullptr if the case is not load balanced. Full-way bounceback nodes are
+    // solid
+    std::unique_ptr<loadBalancer> makeLoadBalancer
+    (
+        const runDriver::scenario &sc,
+        latticeBase &lb,
+        collisionBase &cb,
+        const nodeTypeField &types
+    )
+    {
+        std::unique_ptr<loadBalancer> balancer;
+        if (!sc.is_load_balanced) return balancer;
+        balancer.reset(new loadBalancer(lb, 0, sc.rebalance_interval));
+        std::vector<bool> solid(sc.nx * sc.ny, false);
+        for (auto n = 0u; n < solid.size(); ++n)
+        {
+            solid[n] = types.getType(n) == nodeTypeField::BOUNCEBACK;
+        }  // n
+        balancer->setCosts(solid, boundary_link_weight);
+        cb.setLoadBalancer(balancer.get());
+        return balancer;
+    }
+}
+
+runDriver::latticeBuffers::latticeBuffers
+(
+    std::size_t nx,
+    std::size_t ny,
+    nodeOrdering::e_orderings ordering,
+    std::size_t tile_size
+)
+: D2Q9 {},
+  lattice(nx, ny, 1.0, 1.0, D2Q9, ordering, tile_size),
+  field(nx, ny, {0.0, 0.0}),
+  ordering {ordering},
+  tile_size {tile_size},
+  collision {},
+  collision_name {},
+  smagorinsky_constant {0.0},
+  gamma {0.0},
+  types {},
+  stream {},
+  run {},
+  scratch_directory {}
+{}
+
+runDriver::runDriver()
+: buffers_ {},
+  num_failed_ {0}
+{}
+
+runDriver::scenario runDriver::readScenario
+(
+    const std::string &file_name
+)
+{
+    std::ifstream file(file_name);
+    if (!file) throw std::runtime_error("Error in opening " + file_name);
+    scenario sc {"", 0, 0, "BGK", 0.0, 1.0, 0.1, 0.5, {0.0, 0.0},
+                 std::vector<edgeBoundary>(4, {WALL, 0.0, 0.0, 1.0}), 0, 0.0, 100, 0, 0, 0, "", "", false, 0,
+                 false, 0, false, lossyCodec::ABSOLUTE, 0.0, false, 0, 1, false, 0, 0,
+                 tracerParticles::RK2, 0};
+    std::string line;
+    auto line_number = 0u;
+    while (std::getline(file, line))
+    {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::istringstream values(line);
+        std::string key;
+        if (!(values >> key)) continue;
+        const auto where = file_name + ":" + std::to_string(line_number) + ": ";
+        auto is_valid = true;
+        if (key == "name")
+        {
+            is_valid = static_cast<bool>(values >> sc.name);
+            // the name becomes a folder name on the command line of result
+            is_valid = is_valid && sc.name.find_first_not_of("abcdefghijklmnopqrstuvwxyz"
+                "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.-") == std::string::npos &&
+                sc.name[0] != '.' && sc.name[0] != '-';
+        }
+        else if (key == "size")
+        {
+            is_valid = static_cast<bool>(values >> sc.nx >> sc.ny);
+        }
+        else if (key == "collision")
+        {
+            is_valid = static_cast<bool>(values >> sc.collision);
+        }
+        else if (key == "viscosity")
+        {
+            is_valid = static_cast<bool>(values >> sc.viscosity);
+        }
+        else if (key == "density")
+        {
+            is_valid = static_cast<bool>(values >> sc.density);
+        }
+        else if (key == "smagorinsky")
+        {
+            is_valid = static_cast<bool>(values >> sc.smagorinsky_constant);
+        }
+        else if (key == "gamma")
+        {
+            is_valid = static_cast<bool>(values >> sc.gamma);
+        }
+        else if (key == "velocity")
+        {
+            is_valid = static_cast<bool>(values >> sc.u0[0] >> sc.u0[1]);
+        }
+        else if (key == "boundary")
+        {
+            std::string edge_name;
+            std::string type;
+            values >> edge_name >> type;
+            const auto edge = std::find(std::begin(edge_names), std::end(edge_names), edge_name) -
+                              std::begin(edge_names);
+            if (edge == 4) throw std::runtime_error(where + "unknown edge " + edge_name);
+            auto &boundary = sc.edges[edge];
+            if (type == "wall")
+            {
+                boundary.type = WALL;
+            }
+            else if (type == "velocity")
+            {
+                boundary.type = VELOCITY;
+                is_valid = static_cast<bool>(values >> boundary.u_x >> boundary.u_y);
+            }
+            else if (type == "pressure")
+            {
+                boundary.type = PRESSURE;
+                is_valid = static_cast<bool>(values >> boundary.rho);
+            }
+            else if (type == "periodic")
+            {
+                boundary.type = PERIODIC;
+            }
+            else if (type == "convective")
+            {
+                boundary.type = CONVECTIVE;
+            }
+            else if (type == "characteristic")
+            {
+                boundary.type = CHARACTERISTIC;
+                is_valid = static_cast<bool>(values >> boundary.rho);
+            }
+            else
+            {
+                throw std::runtime_error(where + "unknown boundary " + type);
+            }
+        }
+        else if (key == "steps")
+        {
+            is_valid = static_cast<bool>(values >> sc.max_steps);
+        }
+        else if (key == "tolerance")
+        {
+            is_valid = static_cast<bool>(values >> sc.tolerance);
+        }
+        else if (key == "check_interval")
+        {
+            is_valid = static_cast<bool>(values >> sc.check_interval) && sc.check_interval > 0;
+        }
+        else if (key == "output_interval")
+        {
+            is_valid = static_cast<bool>(values >> sc.output_interval);
+        }
+        else if (key == "diagnostics_interval")
+        {
+            is_valid = static_cast<bool>(values >> sc.diagnostics_interval);
+        }
+        else if (key == "telemetry_interval")
+        {
+            is_valid = static_cast<bool>(values >> sc.telemetry_interval);
+        }
+        else if (key == "out_of_core")
+        {
+            is_valid = static_cast<bool>(values >> sc.scratch_directory);
+        }
+        else if (key == "autotune")
+        {
+            is_valid = static_cast<bool>(values >> sc.tuning_cache);
+        }
+        else if (key == "load_balance")
+        {
+            sc.is_load_balanced = true;
+            is_valid = static_cast<bool>(values >> sc.rebalance_interval);
+        }
+        else if (key == "task_scheduling")
+        {
+            sc.is_task_scheduled = true;
+            is_valid = static_cast<bool>(values >> sc.band_rows);
+        }
+        else if (key == "compression")
+        {
+            std::string bound;
+            sc.is_compressed = true;
+            is_valid = static_cast<bool>(values >> bound >> sc.error_bound) && sc.error_bound > 0.0 &&
+                       (bound == "absolute" || bound == "relative");
+            sc.bound = bound == "relative" ? lossyCodec::RELATIVE : lossyCodec::ABSOLUTE;
+        }
+        else if (key == "statistics")
+        {
+            sc.is_averaged = true;
+            is_valid = static_cast<bool>(values >> sc.statistics_start >> sc.statistics_stride) &&
+                       sc.statistics_stride > 0;
+        }
+        else if (key == "tracers")
+        {
+            std::string integrator;
+            sc.is_traced = true;
+            is_valid = static_cast<bool>(values >> sc.tracers_x >> sc.tracers_y >> integrator >>
+                                         sc.trajectory_interval) && sc.trajectory_interval > 0 &&
+                       (integrator == "rk2" || integrator == "rk4");
+            sc.integrator = integrator == "rk4" ? tracerParticles::RK4 : tracerParticles::RK2;
+        }
+        else
+        {
+            throw std::runtime_error(where + "unknown key " + key);
+        }
+        std::string rest;
+        if (!is_valid || values >> rest) throw std::runtime_error(where + "invalid values of " + key);
+    }
+    if (sc.name.empty()) throw std::runtime_error(file_name + ": missing name");
+    if (sc.nx < 3 || sc.ny < 3) throw std::runtime_error(file_name + ": missing or too small size");
+    if (sc.viscosity <= 0.0) throw std::runtime_error(file_name + ": missing viscosity");
+    if (sc.max_steps == 0) throw std::runtime_error(file_name + ": missing steps");
+    // the bands of the task graph are rows of a row-major lattice in memory
+    if (sc.is_task_scheduled && (!sc.tuning_cache.empty() || !sc.scratch_directory.empty()))
+    {
+        throw std::runtime_error(file_name + ": task_scheduling cannot be combined with autotune "
+                                 "or out_of_core");
+    }
+    // periodicity needs the opposite edge
+    for (auto edge = 0u; edge < 2; ++edge)
+    {
+        if ((sc.edges[edge].type == PERIODIC) != (sc.edges[edge + 2].type == PERIODIC))
+        {
+            throw std::runtime_error(file_name + ": periodic " + edge_names[edge] +
+                                     " edge needs a periodic " + edge_names[edge + 2] + " edge");
+        }
+    }  // edge
+    return sc;
+}
+
+std::unique_ptr<collisionBase> runDriver::makeCollision
+(
+    const scenario &sc,
+    latticeBase &lb,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+{
+    const auto &name = sc.collision;
+    if (name == "BGK")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK(lb, sc.viscosity,
+            sc.density, D2Q9, field));
+    }
+    if (name == "MRT")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT(lb, sc.viscosity,
+            sc.density, D2Q9, field));
+    }
+    if (name == "RBGK")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_RBGK(lb, sc.viscosity,
+            sc.density, D2Q9, field));
+    }
+    if (name == "CM")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_CM(lb, sc.viscosity,
+            sc.density, D2Q9, field));
+    }
+    if (name == "BGK_LES")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK_LES(lb, sc.viscosity,
+            sc.smagorinsky_constant, sc.density, D2Q9, field));
+    }
+    if (name == "MRT_LES")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT_LES(lb, sc.viscosity,
+            sc.smagorinsky_constant, sc.density, D2Q9, field));
+    }
+    if (name == "BGK_PRE")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK_PRE(lb, sc.viscosity,
+            sc.gamma, sc.density, D2Q9, field));
+    }
+    if (name == "MRT_PRE")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT_PRE(lb, sc.viscosity,
+            sc.gamma, sc.density, D2Q9, field));
+    }
+    throw std::runtime_error("Unknown collision model " + name);
+}
+
+void runDriver::prepareBuffers
+(
+    const scenario &sc,
+    latticeBuffers &buffers
+)
+{
+    if (buffers.collision && buffers.collision_name == sc.collision &&
+        buffers.smagorinsky_constant == sc.smagorinsky_constant && buffers.gamma == sc.gamma &&
+        buffers.scratch_directory == sc.scratch_directory)
+    {
+        buffers.collision->reset(sc.viscosity, sc.density);
+        // the load balancer of the last case is gone
+        buffers.collision->setLoadBalancer(nullptr);
+        buffers.types->clear();
+        buffers.run->reset();
+        return;
+    }
+    buffers.run.reset();
+    buffers.stream.reset();
+    buffers.types.reset();
+    buffers.collision.reset();
+    buffers.collision = makeCollision(sc, buffers.lattice, buffers.D2Q9, buffers.field);
+    buffers.collision_name = sc.collision;
+    buffers.smagorinsky_constant = sc.smagorinsky_constant;
+    buffers.gamma = sc.gamma;
+    buffers.scratch_directory = sc.scratch_directory;
+    buffers.types.reset(new nodeTypeField(buffers.lattice, *buffers.collision, buffers.D2Q9,
+                                          buffers.field));
+    buffers.stream.reset(new streamD2Q9(buffers.lattice, buffers.D2Q9, *buffers.types));
+    buffers.run.reset(new latticeBoltzmann(buffers.lattice, *buffers.collision, *buffers.stream));
+}
+
+void runDriver::addBoundaries
+(
+    const scenario &sc,
+    latticeBase &lb,
+    collisionBase &cb,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field,
+    nodeTypeField &types,
+    std::vector<std::unique_ptr<outflowNode>> &outflows
+)
+{
+    const auto nx = lb.getNumberOfNx();
+    const auto ny = lb.getNumberOfNy();
+    // visits the nodes of an edge, without the corners if is_corner is false
+    auto forEdge = [&](std::size_t edge, bool is_corner, const std::function<void(std::size_t,
+                       std::size_t)> &add)
+    {
+        const auto is_vertical = edge == RIGHT || edge == LEFT;
+        const auto length = is_vertical ? ny : nx;
+        const auto position = edge == RIGHT ? nx - 1 : (edge == TOP ? ny - 1 : 0);
+        for (auto i = is_corner ? 0u : 1u; i < (is_corner ? length : length - 1); ++i)
+        {
+            if (is_vertical)
+            {
+                add(position, i);
+            }
+            else
+            {
+                add(i, position);
+            }
+        }  // i
+    };
+    for (auto edge = 0u; edge < 4; ++edge)
+    {
+        if (sc.edges[edge].type != PERIODIC) continue;
+        forEdge(edge, true, [&](std::size_t x, std::size_t y) { types.addPeriodic(x, y); });
+    }  // edge
+    for (auto edge = 0u; edge < 4; ++edge)
+    {
+        if (sc.edges[edge].type != WALL) continue;
+        forEdge(edge, true, [&](std::size_t x, std::size_t y) { types.addHalfwayBounceback(x, y); });
+    }  // edge
+    for (auto edge = 0u; edge < 4; ++edge)
+    {
+        const auto &boundary = sc.edges[edge];
+        if (boundary.type != PRESSURE) continue;
+        forEdge(edge, false, [&](std::size_t x, std::size_t y) { types.addPressure(x, y, boundary.rho); });
+    }  // edge
+    for (auto edge = 0u; edge < 4; ++edge)
+    {
+        const auto &boundary = sc.edges[edge];
+        if (boundary.type != VELOCITY) continue;
+        forEdge(edge, true, [&](std::size_t x, std::size_t y)
+        {
+            types.addVelocity(x, y, boundary.u_x, boundary.u_y, false);
+        });
+    }  // edge
+    for (auto edge = 0u; edge < 4; ++edge)
+    {
+        const auto &boundary = sc.edges[edge];
+        if (boundary.type != CONVECTIVE && boundary.type != CHARACTERISTIC) continue;
+        const auto outflow = boundary.type == CONVECTIVE ? outflowNode::CONVECTIVE :
+                                                           outflowNode::CHARACTERISTIC;
+        outflows.emplace_back(new outflowNode(lb, cb, D2Q9, field, outflow));
+        outflows.back()->setFarField(boundary.rho, 0.25, static_cast<double>(std::max(nx, ny)));
+        forEdge(edge, false, [&](std::size_t x, std::size_t y) { outflows.back()->addNode(x, y); });
+    }  // edge
+}
+
+std::size_t runDriver::runScenario
+(
+    const scenario &sc
+)
+{
+    const auto setup_start = std::chrono::steady_clock::now();
+    auto tuned = autotuner::configuration {nodeOrdering::ROW_MAJOR, 0, 0.0};
+    if (!sc.tuning_cache.empty())
+    {
+        // the lattice size and host are part of the key of the tuning cache
+        auto problem = sc.collision;
+        for (const auto &boundary : sc.edges) problem += std::string(";") + boundary_names[boundary.type];
+        if (!sc.scratch_directory.empty()) problem += ";out_of_core";
+        if (sc.is_load_balanced) problem += ";load_balanced";
+        autotuner tuner(sc.tuning_cache);
+        tuned = tuner.tune(problem, sc.nx, sc.ny, [&](const autotuner::configuration &candidate)
+        {
+            return measureConfiguration(sc, candidate);
+        });
+        std::cout << sc.name << ": " << (tuner.isCached() ? "cached " : "selected ")
+                  << autotuner::getOrderingName(tuned.ordering);
+        if (tuned.tile_size > 0) std::cout << " tile " << tuned.tile_size;
+        std::cout << ", " << tuned.mlups << " MLUPS" << std::endl;
+    }
+    // a case of the same size and configuration keeps the lattice and fluid
+    // field of the last case
+    if (!buffers_ || buffers_->lattice.getNumberOfNx() != sc.nx ||
+        buffers_->lattice.getNumberOfNy() != sc.ny || buffers_->ordering != tuned.ordering ||
+        buffers_->tile_size != tuned.tile_size)
+    {
+        buffers_.reset();
+        buffers_.reset(new latticeBuffers(sc.nx, sc.ny, tuned.ordering, tuned.tile_size));
+    }
+    auto &D2Q9 = buffers_->D2Q9;
+    auto &lattice = buffers_->lattice;
+    auto &field = buffers_->field;
+    initializeField(sc, field);
+
+    prepareBuffers(sc, *buffers_);
+    auto &collision = *buffers_->collision;
+    auto &types = *buffers_->types;
+    auto &run = *buffers_->run;
+    std::vector<std::unique_ptr<outflowNode>> outflows;
+    addBoundaries(sc, lattice, collision, D2Q9, field, types, outflows);
+    const auto balancer = makeLoadBalancer(sc, lattice, collision, types);
+    for (auto &outflow : outflows) run.addBoundaryNode(outflow.get());
+    if (!sc.scratch_directory.empty()) run.enableOutOfCore(sc.scratch_directory);
+    if (sc.is_task_scheduled) run.enableTaskScheduling(sc.band_rows);
+
+    const auto &folder = sc.name;
+    if (system(("mkdir -p " + folder).c_str()) != 0)
+    {
+        throw std::runtime_error("Error in creating folder " + folder);
+    }
+    std::unique_ptr<result> results;
+    if (sc.output_interval > 0 || sc.is_averaged)
+    {
+        results.reset(new result(lattice, field, folder + "/vtk_fluid"));
+    }
+    // stripes of 64 rows keep the threads busy from 128 x 128 lattices on
+    const lossyCodec codec(sc.bound, sc.is_compressed ? sc.error_bound : 1.0, 64);
+    auto compression = lossyCodec::statistics {0, 0, 0.0};
+    std::unique_ptr<diagnostics> monitor;
+    if (sc.diagnostics_interval > 0)
+    {
+        monitor.reset(new diagnostics(lattice, collision, field, folder + "/diagnostics.csv",
+                                      sc.diagnostics_interval));
+        monitor->addProbe(sc.nx / 2, sc.ny / 2);
+        monitor->addIntegral(diagnostics::MASS);
+        monitor->addIntegral(diagnostics::KINETIC_ENERGY);
+        run.addDiagnostics(monitor.get());
+    }
+    std::unique_ptr<flowStatistics> statistics;
+    if (sc.is_averaged)
+    {
+        statistics.reset(new flowStatistics(lattice, field, sc.statistics_start, sc.statistics_stride));
+        run.addStatistics(statistics.get());
+    }
+    std::unique_ptr<tracerParticles> tracers;
+    if (sc.is_traced)
+    {
+        // tiles of 16 x 16 nodes keep the velocity read by the tracers of a
+        // tile in L1
+        tracers.reset(new tracerParticles(lattice, field, sc.integrator, 16));
+        std::vector<tracerParticles::e_boundaries> edges;
+        for (auto edge = 0u; edge < 4; ++edge)
+        {
+            const auto &boundary = sc.edges[edge];
+            // a velocity edge without normal velocity is a moving wall
+            const auto u_normal = edge == RIGHT || edge == LEFT ? boundary.u_x : boundary.u_y;
+            if (boundary.type == WALL || (boundary.type == VELOCITY && u_normal == 0.0))
+            {
+                edges.push_back(tracerParticles::WALL);
+            }
+            else if (boundary.type == PERIODIC)
+            {
+                edges.push_back(tracerParticles::PERIODIC);
+            }
+            else
+            {
+                edges.push_back(tracerParticles::OPEN);
+            }
+        }  // edge
+        tracers->setBoundaries(edges[RIGHT], edges[TOP], edges[LEFT], edges[BOTTOM]);
+        tracers->addParticles(0.0, 0.0, sc.nx - 1.0, sc.ny - 1.0, sc.tracers_x, sc.tracers_y);
+        tracers->enableTrajectories(folder + "/tracers.lbmp", sc.trajectory_interval);
+        run.addTracers(tracers.get());
+    }
+    telemetry metrics
+    (
+        lattice,
+        collision,
+        field,
+        telemetry::JSON_FILE,
+        folder + "/telemetry.jsonl",
+        256,
+        sc.check_interval
+    );
+    if (sc.telemetry_interval > 0)
+    {
+        metrics.addMetric(telemetry::MLUPS, sc.telemetry_interval);
+        metrics.addMetric(telemetry::RESIDUAL, sc.telemetry_interval);
+        metrics.addMetric(telemetry::MASS_DRIFT, sc.telemetry_interval);
+    }
+    const auto setup_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                             setup_start).count();
+
+    const auto run_start = std::chrono::steady_clock::now();
+    auto u_prev = field.u;
+    auto num_steps = std::size_t {0};
+    auto is_steady = false;
+    const auto writeResult = [&]()
+    {
+        if (statistics) results->writeStatisticsVTK(num_steps, *statistics);
+        if (sc.output_interval == 0) return;
+        if (!sc.is_compressed)
+        {
+            results->writeResultVTK(num_steps);
+            return;
+        }
+        const auto stats = results->writeResultCompressed(num_steps, codec);
+        compression.raw_bytes += stats.raw_bytes;
+        compression.compressed_bytes += stats.compressed_bytes;
+        compression.max_error = std::max(compression.max_error, stats.max_error);
+    };
+    while (num_steps < sc.max_steps && !is_steady)
+    {
+        const auto is_check = sc.tolerance > 0.0 && (num_steps + 1) % sc.check_interval == 0;
+        if (is_check) u_prev = field.u;
+        metrics.startStep();
+        run.takeStep();
+        metrics.endStep();
+        ++num_steps;
+        if (sc.output_interval > 0 && num_steps % sc.output_interval == 0) writeResult();
+        if (is_check) is_steady = checkSteadyState(u_prev, field.u, sc.tolerance);
+    }
+    const auto run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                           run_start).count();
+    if (results && (sc.output_interval == 0 || num_steps % sc.output_interval != 0)) writeResult();
+    std::cout << sc.name << ": " << num_steps << " steps, " << (is_steady ? "steady" : "not steady")
+              << ", setup " << setup_seconds << " s, "
+              << num_steps * sc.nx * sc.ny / run_seconds * 1.0e-6 << " MLUPS";
+    if (balancer)
+    {
+        std::cout << ", " << balancer->getNumberOfThreads() << " threads, imbalance "
+                  << balancer->getImbalance() << ", " << balancer->getNumberOfStolenChunks()
+                  << " chunks stolen";
+    }
+    if (tracers)
+    {
+        std::cout << ", " << tracers->getNumberOfActiveParticles() << " of "
+                  << tracers->getNumberOfParticles() << " tracers left";
+    }
+    if (compression.compressed_bytes > 0)
+    {
+        std::cout << ", compression ratio "
+                  << static_cast<double>(compression.raw_bytes) / compression.compressed_bytes
+                  << ", max error " << compression.max_error;
+    }
+    std::cout << std::endl;
+    return num_steps;
+}
+
+double runDriver::measureConfiguration
+(
+    const scenario &sc,
+    const autotuner::configuration &candidate
+)
+{
+    buffers_.reset();
+    latticeBuffers buffers(sc.nx, sc.ny, candidate.ordering, candidate.tile_size);
+    initializeField(sc, buffers.field);
+    prepareBuffers(sc, buffers);
+    std::vector<std::unique_ptr<outflowNode>> outflows;
+    addBoundaries(sc, buffers.lattice, *buffers.collision, buffers.D2Q9, buffers.field, *buffers.types,
+                  outflows);
+    const auto balancer = makeLoadBalancer(sc, buffers.lattice, *buffers.collision, *buffers.types);
+    auto &run = *buffers.run;
+    for (auto &outflow : outflows) run.addBoundaryNode(outflow.get());
+    if (!sc.scratch_directory.empty()) run.enableOutOfCore(sc.scratch_directory);
+    return autotuner::measureMLUPS(run, sc.nx * sc.ny);
+}
+
+bool runDriver::runFile
+(
+    const std::string &file_name,
+    std::string &reply
+)
+{
+    try
+    {
+        const auto sc = readScenario(file_name);
+        const auto num_steps = runScenario(sc);
+        reply = "done " + sc.name + " " + std::to_string(num_steps);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << file_name << ": " << e.what() << std::endl;
+        reply = "error " + std::string(e.what());
+        ++num_failed_;
+        return false;
+    }
+}
+
+std::size_t runDriver::runDirectory
+(
+    const std::string &directory
+)
+{
+    auto num_cases = std::size_t {0};
+    while (true)
+    {
+        auto *dir = opendir(directory.c_str());
+        if (dir == nullptr) throw std::runtime_error("Error in opening " + directory);
+        std::vector<std::string> files;
+        while (auto *entry = readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            if (name.size() > scenario_suffix.size() &&
+                name.compare(name.size() - scenario_suffix.size(), scenario_suffix.size(),
+                             scenario_suffix) == 0)
+            {
+                files.push_back(name);
+            }
+        }
+        closedir(dir);
+        if (files.empty()) break;
+        std::sort(files.begin(), files.end());
+        const auto file_name = directory + "/" + files.front();
+        std::string reply;
+        const auto is_done = runFile(file_name, reply);
+        if (is_done) ++num_cases;
+        const auto renamed = file_name + (is_done ? ".done" : ".failed");
+        if (std::rename(file_name.c_str(), renamed.c_str()) != 0)
+        {
+            throw std::runtime_error("Error in renaming " + file_name);
+        }
+    }
+    return num_cases;
+}
+
+std::size_t runDriver::listen
+(
+    const std::string &socket_path
+)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Socket path too long: " + socket_path);
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+    const auto server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) throw std::runtime_error("Error in creating socket " + socket_path);
+    ::unlink(socket_path.c_str());
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(server, 16) != 0)
+    {
+        ::close(server);
+        throw std::runtime_error("Error in binding socket " + socket_path);
+    }
+    auto num_cases = std::size_t {0};
+    auto is_quit = false;
+    while (!is_quit)
+    {
+        const auto client = ::accept(server, nullptr, nullptr);
+        if (client < 0) continue;
+        std::string pending;
+        char buffer[4096];
+        while (!is_quit)
+        {
+            const auto num_read = ::read(client, buffer, sizeof(buffer));
+            if (num_read <= 0) break;
+            pending.append(buffer, num_read);
+            std::size_t end;
+            while (!is_quit && (end = pending.find('\n')) != std::string::npos)
+            {
+                auto line = pending.substr(0, end);
+                pending.erase(0, end + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty()) continue;
+                if (line == "quit")
+                {
+                    is_quit = true;
+                    break;
+                }
+                std::string reply;
+                if (runFile(line, reply)) ++num_cases;
+                reply += "\n";
+                ::send(client, reply.data(), reply.size(), MSG_NOSIGNAL);
+            }
+        }
+        ::close(client);
+    }
+    ::close(server);
+    ::unlink(socket_path.c_str());
+    return num_cases;
+}
+
+std::size_t runDriver::getNumberOfFailedCases() const
+{
+    return num_failed_;
+}
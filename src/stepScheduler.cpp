@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "latticeArray.hxx"
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "streamBase.hxx"
+#include "boundaryNode.hxx"
+#include "flowStatistics.hpp"
+#include "stepScheduler.hpp"
+
+namespace
+{
+    // Resources of a band in the task graph
+    const std::size_t num_band_resources = 3;
+
+    // Index of the distribution functions of a band
+    std::size_t getDistributions(std::size_t band)
+    {
+        return band * num_band_resources;
+    }
+
+    // Index of the macroscopic properties of a band
+    std::size_t getMacroscopic(std::size_t band)
+    {
+        return band * num_band_resources + 1;
+    }
+
+    // Index of the copies of the outer rows and edges of a band
+    std::size_t getSavedRows(std::size_t band)
+    {
+        return band * num_band_resources + 2;
+    }
+
+    // Task index of a resource which has not been accessed yet
+    const std::size_t no_task = static_cast<std::size_t>(-1);
+}
+
+stepScheduler::stepScheduler
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    streamBase &sb,
+    std::size_t band_rows
+)
+: lb_ (lb),
+  cb_ (cb),
+  sb_ (sb),
+  band_rows_ {band_rows},
+  num_bands_ {0},
+  bn_ {},
+  bn_rows_ {},
+  tasks_ {},
+  num_waiting_ {},
+  first_rows_ {},
+  last_rows_ {},
+  df_ {nullptr},
+  st_ {nullptr}
+{
+    if (!cb_.isNodeRangeSupported())
+    {
+        throw std::runtime_error("Task scheduling needs a collision model with node ranges");
+    }
+    if (!sb_.isRowRangeSupported())
+    {
+        throw std::runtime_error("Task scheduling needs a stream model with row ranges");
+    }
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = lb_.getNumberOfDirections();
+    if (band_rows_ == 0)
+    {
+        auto num_threads = std::size_t {1};
+#ifdef _OPENMP
+        num_threads = static_cast<std::size_t>(omp_get_max_threads());
+#endif
+        band_rows_ = std::max(ny / (4 * num_threads), std::size_t {1});
+    }
+    num_bands_ = (ny + band_rows_ - 1) / band_rows_;
+    first_rows_.resize(num_bands_);
+    last_rows_.resize(num_bands_);
+    for (auto k = 0u; k < num_bands_; ++k)
+    {
+        first_rows_[k].assign(nx, nc, 0.0);
+        last_rows_[k].assign(nx, nc, 0.0);
+    }  // k
+}
+
+void stepScheduler::takeStep
+(
+    latticeArray<double> &df,
+    const std::vector<boundaryNode*> &bn,
+    const std::vector<flowStatistics*> &st
+)
+{
+    auto is_changed = tasks_.empty() || bn != bn_;
+    for (auto b = 0u; b < bn.size() && !is_changed; ++b)
+    {
+        auto rows = std::make_pair(std::size_t {0}, std::size_t {0});
+        bn[b]->getRows(rows.first, rows.second);
+        is_changed = rows != bn_rows_[b];
+    }  // b
+    if (is_changed) buildGraph(bn);
+    df_ = &df;
+    st_ = &st;
+    for (auto t = 0u; t < tasks_.size(); ++t) num_waiting_[t] = tasks_[t].num_predecessors;
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (auto t = std::size_t {0}; t < tasks_.size(); ++t)
+            {
+                if (tasks_[t].num_predecessors > 0) continue;
+                #pragma omp task firstprivate(t)
+                runTask(t);
+            }  // t
+        }
+    }
+    df_ = nullptr;
+    st_ = nullptr;
+}
+
+std::size_t stepScheduler::getNumberOfTasks() const
+{
+    return tasks_.size();
+}
+
+std::size_t stepScheduler::getNumberOfBands() const
+{
+    return num_bands_;
+}
+
+void stepScheduler::buildGraph
+(
+    const std::vector<boundaryNode*> &bn
+)
+{
+    const auto ny = lb_.getNumberOfNy();
+    bn_ = bn;
+    bn_rows_.assign(bn.size(), std::make_pair(std::size_t {0}, std::size_t {0}));
+    tasks_.clear();
+    std::vector<access> accesses(num_bands_ * num_band_resources, access {no_task, {}});
+    // resources of the bands of a range of rows
+    auto getBands = [&](std::size_t first_row, std::size_t last_row,
+                        std::size_t (*resource)(std::size_t))
+    {
+        std::vector<std::size_t> resources;
+        if (last_row > first_row)
+        {
+            for (auto k = first_row / band_rows_; k <= (last_row - 1) / band_rows_; ++k)
+            {
+                resources.push_back(resource(k));
+            }  // k
+        }
+        return resources;
+    };
+    for (auto k = 0u; k < num_bands_; ++k)
+    {
+        addTask(COLLIDE, k, {getDistributions(k)}, {getMacroscopic(k)}, accesses);
+    }  // k
+    for (auto b = 0u; b < bn.size(); ++b)
+    {
+        auto &rows = bn_rows_[b];
+        bn[b]->getRows(rows.first, rows.second);
+        rows.second = std::min(rows.second, ny);
+        if (!bn[b]->prestream) continue;
+        addTask(PRESTREAM, b, getBands(rows.first, rows.second, getDistributions),
+                getBands(rows.first, rows.second, getMacroscopic), accesses);
+    }  // b
+    for (auto k = 0u; k < num_bands_; ++k)
+    {
+        addTask(SAVE_ROWS, k, {getSavedRows(k)}, {getDistributions(k)}, accesses);
+    }  // k
+    for (auto k = 0u; k < num_bands_; ++k)
+    {
+        // periodic edges pull from the opposite edge, the saved rows wrap around
+        const auto below = (k + num_bands_ - 1) % num_bands_;
+        const auto above = (k + 1) % num_bands_;
+        std::vector<std::size_t> read {getSavedRows(below), getSavedRows(k), getSavedRows(above),
+                                       getMacroscopic(k)};
+        // boundary rules read the macroscopic properties of their neighbours
+        if (k > 0) read.push_back(getMacroscopic(k - 1));
+        if (k + 1 < num_bands_) read.push_back(getMacroscopic(k + 1));
+        addTask(STREAM, k, {getDistributions(k)}, read, accesses);
+    }  // k
+    for (auto b = 0u; b < bn.size(); ++b)
+    {
+        if (bn[b]->prestream && !bn[b]->streaming) continue;
+        const auto &rows = bn_rows_[b];
+        addTask(POSTSTREAM, b, getBands(rows.first, rows.second, getDistributions),
+                getBands(rows.first, rows.second, getMacroscopic), accesses);
+    }  // b
+    for (auto k = 0u; k < num_bands_; ++k)
+    {
+        addTask(MACROSCOPIC, k, {getMacroscopic(k)}, {getDistributions(k)}, accesses);
+    }  // k
+    num_waiting_.reset(new std::atomic<std::size_t>[tasks_.size()]);
+}
+
+void stepScheduler::addTask
+(
+    e_tasks kind,
+    std::size_t index,
+    const std::vector<std::size_t> &written,
+    const std::vector<std::size_t> &read,
+    std::vector<access> &accesses
+)
+{
+    const auto t = tasks_.size();
+    std::vector<std::size_t> predecessors;
+    for (auto r : read)
+    {
+        if (accesses[r].writer != no_task) predecessors.push_back(accesses[r].writer);
+    }  // r
+    for (auto r : written)
+    {
+        if (accesses[r].writer != no_task) predecessors.push_back(accesses[r].writer);
+        predecessors.insert(predecessors.end(), accesses[r].readers.begin(),
+                            accesses[r].readers.end());
+    }  // r
+    std::sort(predecessors.begin(), predecessors.end());
+    predecessors.erase(std::unique(predecessors.begin(), predecessors.end()), predecessors.end());
+    for (auto p : predecessors) tasks_[p].successors.push_back(t);
+    tasks_.push_back(task {kind, index, {}, predecessors.size()});
+    for (auto r : written)
+    {
+        accesses[r].writer = t;
+        accesses[r].readers.clear();
+    }  // r
+    for (auto r : read)
+    {
+        if (std::find(written.begin(), written.end(), r) == written.end())
+        {
+            accesses[r].readers.push_back(t);
+        }
+    }  // r
+}
+
+void stepScheduler::runTask
+(
+    std::size_t t
+)
+{
+    auto &df = *df_;
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto &current = tasks_[t];
+    const auto k = current.index;
+    const auto first_row = k * band_rows_;
+    const auto last_row = std::min(first_row + band_rows_, ny);
+    switch (current.kind)
+    {
+        case COLLIDE:
+        {
+            cb_.restrictToNodes(first_row * nx, last_row * nx, [&]()
+            {
+                cb_.computefEq();
+                cb_.collide(df);
+            });
+            break;
+        }
+        case PRESTREAM:
+        {
+            bn_[k]->updateNode(df, false);
+            break;
+        }
+        case SAVE_ROWS:
+        {
+            const auto nc = df.width();
+            for (auto x = 0u; x < nx; ++x)
+            {
+                for (auto i = 0u; i < nc; ++i)
+                {
+                    first_rows_[k][x][i] = df[first_row * nx + x][i];
+                    last_rows_[k][x][i] = df[(last_row - 1) * nx + x][i];
+                }  // i
+            }  // x
+            sb_.saveRows(df, first_row, last_row);
+            break;
+        }
+        case STREAM:
+        {
+            // the first and the last row of the lattice have nothing to read
+            // beyond them, their own copies stand in
+            const auto &row_below = k > 0 ? last_rows_[k - 1] : first_rows_[k];
+            const auto &row_above = k + 1 < num_bands_ ? first_rows_[k + 1] : last_rows_[k];
+            sb_.streamRows(df, first_row, last_row, row_below, row_above);
+            break;
+        }
+        case POSTSTREAM:
+        {
+            if (bn_[k]->streaming) bn_[k]->updateNode(df, true);
+            if (!bn_[k]->prestream) bn_[k]->updateNode(df, false);
+            break;
+        }
+        case MACROSCOPIC:
+        {
+            cb_.restrictToNodes(first_row * nx, last_row * nx, [&]()
+            {
+                cb_.computeMacroscopicProperties(df);
+            });
+            // the band is still in cache
+            for (auto statistics : *st_) statistics->sampleNodes(first_row * nx, last_row * nx);
+            break;
+        }
+    }
+    for (auto s : current.successors)
+    {
+        if (--num_waiting_[s] == 0)
+        {
+            #pragma omp task firstprivate(s)
+            runTask(s);
+        }
+    }  // s
+}
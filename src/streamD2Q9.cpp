@@ -1,9 +1,33 @@
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 #include "latticeModel.hxx"
 
 #include "latticeBase.hpp"
 #include "streamD2Q9.hpp"
+#include "nodeTypeField.hpp"
+
+namespace
+{
+    // Number of nodes of the saved tile edges of a tiled lattice
+    // param lb lattice
+    // param is_rows TRUE for the edge rows, FALSE for the edge columns
+    // return number of nodes, 0 for lattices stored row-wise
+    std::size_t getNumberOfEdgeNodes
+    (
+        const latticeBase &lb,
+        bool is_rows
+    )
+    {
+        const auto tile_size = lb.getNodeOrdering().getTileSize();
+        if (tile_size == 0) return 0;
+        const auto nx = lb.getNumberOfNx();
+        const auto ny = lb.getNumberOfNy();
+        return is_rows ? 2 * ((ny + tile_size - 1) / tile_size) * nx :
+                         2 * ((nx + tile_size - 1) / tile_size) * ny;
+    }
+}
 
 streamD2Q9::streamD2Q9
 (
@@ -11,32 +35,360 @@ streamD2Q9::streamD2Q9
     latticeModelD2Q9 &D2Q9
 )
 : streamBase(lb),
-  D2Q9_ (D2Q9)
+  D2Q9_ (D2Q9),
+  types_ {nullptr},
+  edge_rows_ (getNumberOfEdgeNodes(lb, true), lb.getNumberOfDirections(), 0.0),
+  edge_columns_ (getNumberOfEdgeNodes(lb, false), lb.getNumberOfDirections(), 0.0)
+{}
+
+streamD2Q9::streamD2Q9
+(
+    latticeBase &lb,
+    latticeModelD2Q9 &D2Q9,
+    nodeTypeField &types
+)
+: streamBase(lb),
+  D2Q9_ (D2Q9),
+  types_ {&types},
+  edge_rows_ (getNumberOfEdgeNodes(lb, true), lb.getNumberOfDirections(), 0.0),
+  edge_columns_ (getNumberOfEdgeNodes(lb, false), lb.getNumberOfDirections(), 0.0)
 {}
 
-std::vector<std::vector<double>> streamD2Q9::stream
+void streamD2Q9::stream
 (
-    const std::vector<std::vector<double>> &df
+    latticeArray<double> &df
 )
 {
+    if (!lb_.getNodeOrdering().isRowMajor())
+    {
+        streamTiled(df);
+        return;
+    }
+    if (types_)
+    {
+        streamTyped(df);
+        return;
+    }
     const auto nx = lb_.getNumberOfNx();
-    const auto ny = lb_.getNumberOfNx();
-    auto temp_df = df;
-    // Streaming
-    for (auto n = 0u; n < nx * ny; ++n)
-    {
-        const auto left   = n % nx == 0;
-        const auto right  = n % nx == nx - 1;
-        const auto bottom = n / nx == 0;
-        const auto top    = n / nx == ny - 1;
-        if (!left)              temp_df[n][D2Q9_.E]  = df[n -  1][D2Q9_.E];
-        if (!bottom)            temp_df[n][D2Q9_.N]  = df[n - nx][D2Q9_.N];
-        if (!right)             temp_df[n][D2Q9_.W]  = df[n +  1][D2Q9_.W];
-        if (!top)               temp_df[n][D2Q9_.S]  = df[n + nx][D2Q9_.S];
-        if (!(bottom || left))  temp_df[n][D2Q9_.NE] = df[n - nx - 1][D2Q9_.NE];
-        if (!(bottom || right)) temp_df[n][D2Q9_.NW] = df[n - nx + 1][D2Q9_.NW];
-        if (!(top || right))    temp_df[n][D2Q9_.SW] = df[n + nx + 1][D2Q9_.SW];
-        if (!(top || left))     temp_df[n][D2Q9_.SE] = df[n + nx - 1][D2Q9_.SE];
-    }  // n
-    return temp_df;
+    const auto ny = lb_.getNumberOfNy();
+    const auto num_nodes = nx * ny;
+    const auto slab_nodes = df.getSlabNodes(nx);
+    // Streaming of E, N, NE and NW, their sources have lower indices. Each slab
+    // reads the next lower slab ahead and is written behind once streamed
+    for (auto last = num_nodes; last > 0;)
+    {
+        const auto first = last > slab_nodes ? last - slab_nodes : 0;
+        df.prefetch(first > slab_nodes ? first - slab_nodes : 0, std::min(first, slab_nodes));
+        for (auto n = last; n-- > first;)
+        {
+            const auto left   = n % nx == 0;
+            const auto right  = n % nx == nx - 1;
+            const auto bottom = n / nx == 0;
+            if (!left)              df[n][D2Q9_.E]  = df[n -  1][D2Q9_.E];
+            if (!bottom)            df[n][D2Q9_.N]  = df[n - nx][D2Q9_.N];
+            if (!(bottom || left))  df[n][D2Q9_.NE] = df[n - nx - 1][D2Q9_.NE];
+            if (!(bottom || right)) df[n][D2Q9_.NW] = df[n - nx + 1][D2Q9_.NW];
+        }  // n
+        if (is_write_behind_) df.writeBehind(first, last - first);
+        last = first;
+    }  // last
+    // Streaming of W, S, SW and SE, their sources have higher indices
+    for (auto first = std::size_t {0}; first < num_nodes; first += slab_nodes)
+    {
+        const auto last = std::min(first + slab_nodes, num_nodes);
+        df.prefetch(last, slab_nodes);
+        for (auto n = first; n < last; ++n)
+        {
+            const auto left   = n % nx == 0;
+            const auto right  = n % nx == nx - 1;
+            const auto top    = n / nx == ny - 1;
+            if (!right)             df[n][D2Q9_.W]  = df[n +  1][D2Q9_.W];
+            if (!top)               df[n][D2Q9_.S]  = df[n + nx][D2Q9_.S];
+            if (!(top || right))    df[n][D2Q9_.SW] = df[n + nx + 1][D2Q9_.SW];
+            if (!(top || left))     df[n][D2Q9_.SE] = df[n + nx - 1][D2Q9_.SE];
+        }  // n
+        if (is_write_behind_) df.writeBehind(first, last - first);
+    }  // first
+}
+
+void streamD2Q9::streamTyped
+(
+    latticeArray<double> &df
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    auto &types = *types_;
+    types.saveEdges(df);
+    const auto num_nodes = nx * ny;
+    const auto slab_nodes = df.getSlabNodes(nx);
+    // Streaming of E, N, NE and NW, their sources have lower indices
+    for (auto last = num_nodes; last > 0;)
+    {
+        const auto first = last > slab_nodes ? last - slab_nodes : 0;
+        df.prefetch(first > slab_nodes ? first - slab_nodes : 0, std::min(first, slab_nodes));
+        for (auto n = last; n-- > first;)
+        {
+            const auto left   = n % nx == 0;
+            const auto right  = n % nx == nx - 1;
+            const auto bottom = n / nx == 0;
+            if (!left)              df[n][D2Q9_.E]  = df[n -  1][D2Q9_.E];
+            else                    types.pullOffLattice(df, n, D2Q9_.E);
+            if (!bottom)            df[n][D2Q9_.N]  = df[n - nx][D2Q9_.N];
+            else                    types.pullOffLattice(df, n, D2Q9_.N);
+            if (!(bottom || left))  df[n][D2Q9_.NE] = df[n - nx - 1][D2Q9_.NE];
+            else                    types.pullOffLattice(df, n, D2Q9_.NE);
+            if (!(bottom || right)) df[n][D2Q9_.NW] = df[n - nx + 1][D2Q9_.NW];
+            else                    types.pullOffLattice(df, n, D2Q9_.NW);
+        }  // n
+        if (is_write_behind_) df.writeBehind(first, last - first);
+        last = first;
+    }  // last
+    // Streaming of W, S, SW and SE, their sources have higher indices. Nodes with
+    // lower indices have already read from node n, so it can be updated here
+    for (auto first = std::size_t {0}; first < num_nodes; first += slab_nodes)
+    {
+        const auto last = std::min(first + slab_nodes, num_nodes);
+        df.prefetch(last, slab_nodes);
+        for (auto n = first; n < last; ++n)
+        {
+            const auto left   = n % nx == 0;
+            const auto right  = n % nx == nx - 1;
+            const auto top    = n / nx == ny - 1;
+            if (!right)             df[n][D2Q9_.W]  = df[n +  1][D2Q9_.W];
+            else                    types.pullOffLattice(df, n, D2Q9_.W);
+            if (!top)               df[n][D2Q9_.S]  = df[n + nx][D2Q9_.S];
+            else                    types.pullOffLattice(df, n, D2Q9_.S);
+            if (!(top || right))    df[n][D2Q9_.SW] = df[n + nx + 1][D2Q9_.SW];
+            else                    types.pullOffLattice(df, n, D2Q9_.SW);
+            if (!(top || left))     df[n][D2Q9_.SE] = df[n + nx - 1][D2Q9_.SE];
+            else                    types.pullOffLattice(df, n, D2Q9_.SE);
+            if (types.getType(n) != nodeTypeField::FLUID) types.updateNode(df, n);
+        }  // n
+        if (is_write_behind_) df.writeBehind(first, last - first);
+    }  // first
+}
+
+bool streamD2Q9::isRowRangeSupported() const
+{
+    return lb_.getNodeOrdering().isRowMajor();
+}
+
+void streamD2Q9::saveRows
+(
+    const latticeArray<double> &df,
+    std::size_t first_row,
+    std::size_t last_row
+)
+{
+    if (types_) types_->saveEdges(df, first_row, last_row);
+}
+
+void streamD2Q9::streamRows
+(
+    latticeArray<double> &df,
+    std::size_t first_row,
+    std::size_t last_row,
+    const latticeArray<double> &row_below,
+    const latticeArray<double> &row_above
+)
+{
+    if (!isRowRangeSupported())
+    {
+        throw std::runtime_error("Ranges of rows can only be streamed on row-major lattices");
+    }
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    // Streaming of E, N, NE and NW, their sources lie in the same row further left
+    // or in the row below, which is the copy below the range for the first row
+    for (auto y = last_row; y-- > first_row;)
+    {
+        const auto bottom = y == 0;
+        const auto &below = y == first_row ? row_below : df;
+        const auto below_offset = y == first_row ? 0 : (y - 1) * nx;
+        for (auto x = nx; x-- > 0;)
+        {
+            const auto n = y * nx + x;
+            const auto left   = x == 0;
+            const auto right  = x == nx - 1;
+            if (!left)              df[n][D2Q9_.E]  = df[n - 1][D2Q9_.E];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.E);
+            if (!bottom)            df[n][D2Q9_.N]  = below[below_offset + x][D2Q9_.N];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.N);
+            if (!(bottom || left))  df[n][D2Q9_.NE] = below[below_offset + x - 1][D2Q9_.NE];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.NE);
+            if (!(bottom || right)) df[n][D2Q9_.NW] = below[below_offset + x + 1][D2Q9_.NW];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.NW);
+        }  // x
+    }  // y
+    // Streaming of W, S, SW and SE, their sources lie in the same row further right
+    // or in the row above, which is the copy above the range for the last row
+    for (auto y = first_row; y < last_row; ++y)
+    {
+        const auto top = y == ny - 1;
+        const auto &above = y + 1 == last_row ? row_above : df;
+        const auto above_offset = y + 1 == last_row ? 0 : (y + 1) * nx;
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = y * nx + x;
+            const auto left   = x == 0;
+            const auto right  = x == nx - 1;
+            if (!right)             df[n][D2Q9_.W]  = df[n + 1][D2Q9_.W];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.W);
+            if (!top)               df[n][D2Q9_.S]  = above[above_offset + x][D2Q9_.S];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.S);
+            if (!(top || right))    df[n][D2Q9_.SW] = above[above_offset + x + 1][D2Q9_.SW];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.SW);
+            if (!(top || left))     df[n][D2Q9_.SE] = above[above_offset + x - 1][D2Q9_.SE];
+            else if (types_)        types_->pullOffLattice(df, n, D2Q9_.SE);
+            if (types_ && types_->getType(n) != nodeTypeField::FLUID) types_->updateNode(df, n);
+        }  // x
+    }  // y
+}
+
+void streamD2Q9::saveTileEdges
+(
+    const latticeArray<double> &df
+)
+{
+    const auto nx = lb_.getNumberOfNx();
+    const auto ny = lb_.getNumberOfNy();
+    const auto nc = df.width();
+    const auto tile_size = lb_.getNodeOrdering().getTileSize();
+    for (const auto &t : lb_.getNodeOrdering().getTiles())
+    {
+        const auto j = t.y / tile_size;
+        const auto i = t.x / tile_size;
+        for (auto x = 0u; x < t.width; ++x)
+        {
+            const auto *bottom = df[t.first + x];
+            const auto *top = df[t.first + (t.height - 1) * t.width + x];
+            std::copy(bottom, bottom + nc, edge_rows_[2 * j * nx + t.x + x]);
+            std::copy(top, top + nc, edge_rows_[(2 * j + 1) * nx + t.x + x]);
+        }  // x
+        for (auto y = 0u; y < t.height; ++y)
+        {
+            const auto *left = df[t.first + y * t.width];
+            const auto *right = df[t.first + y * t.width + t.width - 1];
+            std::copy(left, left + nc, edge_columns_[2 * i * ny + t.y + y]);
+            std::copy(right, right + nc, edge_columns_[(2 * i + 1) * ny + t.y + y]);
+        }  // y
+    }  // t
+}
+
+void streamD2Q9::streamTiled
+(
+    latticeArray<double> &df
+)
+{
+    const long nx = lb_.getNumberOfNx();
+    const long ny = lb_.getNumberOfNy();
+    const auto nc = df.width();
+    const auto tile_size = lb_.getNodeOrdering().getTileSize();
+    if (types_) types_->saveEdges(df);
+    saveTileEdges(df);
+    const auto E = D2Q9_.E;
+    const auto N = D2Q9_.N;
+    const auto W = D2Q9_.W;
+    const auto S = D2Q9_.S;
+    const auto NE = D2Q9_.NE;
+    const auto NW = D2Q9_.NW;
+    const auto SW = D2Q9_.SW;
+    const auto SE = D2Q9_.SE;
+    for (const auto &t : lb_.getNodeOrdering().getTiles())
+    {
+        const long w = t.width;
+        const long h = t.height;
+        const long x0 = t.x;
+        const long y0 = t.y;
+        const auto i = t.x / tile_size;
+        const auto j = t.y / tile_size;
+        // saved edges of the neighbouring tiles towards this tile, nullptr on the
+        // edges of the lattice
+        const double *below = y0 > 0 ? edge_rows_[(2 * j - 1) * nx] : nullptr;
+        const double *above = y0 + h < ny ? edge_rows_[(2 * j + 2) * nx] : nullptr;
+        const double *left = x0 > 0 ? edge_columns_[(2 * i - 1) * ny] : nullptr;
+        const double *right = x0 + w < nx ? edge_columns_[(2 * i + 2) * ny] : nullptr;
+        // copies direction k from the source at x, y of node n, or pulls it in
+        // through the node type field for sources outside of the lattice. Rows
+        // come first, so that the corners of diagonal neighbours are found as well
+        auto pull = [&](std::size_t n, long x, long y, std::size_t k)
+        {
+            const double *source = nullptr;
+            if (x < 0 || x >= nx)   source = nullptr;
+            else if (y < y0)        source = below ? below + x * nc : nullptr;
+            else if (y >= y0 + h)   source = above ? above + x * nc : nullptr;
+            else if (x < x0)        source = left ? left + y * nc : nullptr;
+            else if (x >= x0 + w)   source = right ? right + y * nc : nullptr;
+            else                    source = df[t.first + (y - y0) * w + (x - x0)];
+            if (source)             df[n][k] = source[k];
+            else if (types_)        types_->pullOffLattice(df, n, k);
+        };
+        // Streaming of E, N, NE and NW, their sources inside the tile lie in the
+        // same row further left or in the row below, which are visited later
+        for (auto ly = h; ly-- > 0;)
+        {
+            const long y = y0 + ly;
+            const auto row = t.first + ly * w;
+            auto edgeNode = [&](long lx)
+            {
+                const long x = x0 + lx;
+                pull(row + lx, x - 1, y, E);
+                pull(row + lx, x, y - 1, N);
+                pull(row + lx, x - 1, y - 1, NE);
+                pull(row + lx, x + 1, y - 1, NW);
+            };
+            if (ly == 0)
+            {
+                for (auto lx = w; lx-- > 0;) edgeNode(lx);
+                continue;
+            }
+            edgeNode(w - 1);
+            for (auto n = row + w - 1; n-- > row + 1;)
+            {
+                df[n][E]  = df[n - 1][E];
+                df[n][N]  = df[n - w][N];
+                df[n][NE] = df[n - w - 1][NE];
+                df[n][NW] = df[n - w + 1][NW];
+            }  // n
+            if (w > 1) edgeNode(0);
+        }  // ly
+        // Streaming of W, S, SW and SE, their sources inside the tile lie in the
+        // same row further right or in the row above. Nodes visited earlier have
+        // already read from node n
+        for (long ly = 0; ly < h; ++ly)
+        {
+            const long y = y0 + ly;
+            const auto row = t.first + ly * w;
+            auto edgeNode = [&](long lx)
+            {
+                const long x = x0 + lx;
+                pull(row + lx, x + 1, y, W);
+                pull(row + lx, x, y + 1, S);
+                pull(row + lx, x + 1, y + 1, SW);
+                pull(row + lx, x - 1, y + 1, SE);
+            };
+            if (ly == h - 1)
+            {
+                for (long lx = 0; lx < w; ++lx) edgeNode(lx);
+            }
+            else
+            {
+                edgeNode(0);
+                for (auto n = row + 1; n + 1 < row + w; ++n)
+                {
+                    df[n][W]  = df[n + 1][W];
+                    df[n][S]  = df[n + w][S];
+                    df[n][SW] = df[n + w + 1][SW];
+                    df[n][SE] = df[n + w - 1][SE];
+                }  // n
+                if (w > 1) edgeNode(w - 1);
+            }
+            if (!types_) continue;
+            for (auto n = row; n < row + w; ++n)
+            {
+                if (types_->getType(n) != nodeTypeField::FLUID) types_->updateNode(df, n);
+            }  // n
+        }  // ly
+    }  // t
 }
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "latticeModel.hxx"
+#include "latticeArray.hxx"
+#include "momentComputing.h"
+
+#include "latticeBase.hpp"
+#include "collisionBase.hxx"
+#include "telemetry.hpp"
+
+namespace
+{
+    // Keys of the metrics in the JSON lines
+    const char *metric_keys[] = {"step_time", "mlups", "residual", "mass_drift"};
+}
+
+telemetry::telemetry
+(
+    latticeBase &lb,
+    collisionBase &cb,
+    fluidField &field,
+    e_sinks sink,
+    const std::string &address,
+    std::size_t capacity,
+    std::size_t flush_interval
+)
+: lb_ (lb),
+  cb_ (cb),
+  field_ (field),
+  sink_ {sink},
+  file_ {},
+  socket_ {-1},
+  buffer_ (capacity),
+  first_ {0},
+  size_ {0},
+  flush_interval_ {flush_interval},
+  intervals_ (num_metrics_, 0),
+  step_ {0},
+  start_ {},
+  elapsed_ (num_metrics_, 0.0),
+  u_prev_ {},
+  initial_mass_ {0},
+  lines_ {},
+  pending_bytes_ {0},
+  num_dropped_ {0}
+{
+    if (capacity == 0) throw std::runtime_error("Telemetry buffer capacity must be positive");
+    if (flush_interval_ == 0) throw std::runtime_error("Telemetry flush interval must be positive");
+    if (sink_ == JSON_FILE)
+    {
+        file_.open(address);
+        if (!file_) throw std::runtime_error("Error in opening " + address);
+    }
+    else
+    {
+        sockaddr_un socket_address;
+        std::memset(&socket_address, 0, sizeof(socket_address));
+        socket_address.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(socket_address.sun_path))
+        {
+            throw std::runtime_error("Socket path too long: " + address);
+        }
+        std::strcpy(socket_address.sun_path, address.c_str());
+        socket_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (socket_ < 0 || ::connect(socket_, reinterpret_cast<sockaddr*>(&socket_address),
+                                     sizeof(socket_address)) != 0)
+        {
+            if (socket_ >= 0) ::close(socket_);
+            throw std::runtime_error("Error in connecting to " + address);
+        }
+    }
+    initial_mass_ = computeMass();
+}
+
+telemetry::~telemetry()
+{
+    flush();
+    if (socket_ >= 0) ::close(socket_);
+}
+
+void telemetry::addMetric
+(
+    e_metrics metric,
+    std::size_t interval
+)
+{
+    if (interval == 0) throw std::runtime_error("Telemetry metric interval must be positive");
+    intervals_[metric] = interval;
+}
+
+void telemetry::startStep()
+{
+    const auto interval = intervals_[RESIDUAL];
+    if (interval > 0 && (step_ + 1) % interval == 0) u_prev_ = field_.u;
+    start_ = std::chrono::steady_clock::now();
+}
+
+void telemetry::endStep()
+{
+    const auto end = std::chrono::steady_clock::now();
+    const auto seconds = std::chrono::duration<double>(end - start_).count();
+    ++step_;
+    elapsed_[STEP_TIME] += seconds;
+    elapsed_[MLUPS] += seconds;
+    record entry;
+    entry.step = step_;
+    entry.mask = 0;
+    for (auto m = 0u; m < num_metrics_; ++m)
+    {
+        const auto interval = intervals_[m];
+        if (interval == 0 || step_ % interval != 0) continue;
+        auto value = 0.0;
+        switch (m)
+        {
+            case STEP_TIME:
+                value = elapsed_[m] / interval;
+                elapsed_[m] = 0.0;
+                break;
+            case MLUPS:
+                value = static_cast<double>(interval * field_.u.size()) / elapsed_[m] * 1.0e-6;
+                elapsed_[m] = 0.0;
+                break;
+            case RESIDUAL:
+                value = checkError(u_prev_, field_.u);
+                break;
+            case MASS_DRIFT:
+                value = computeMass() / initial_mass_ - 1.0;
+                break;
+        }
+        entry.mask |= 1u << m;
+        entry.values[m] = value;
+    }  // m
+    if (entry.mask != 0)
+    {
+        if (size_ == buffer_.size()) flush();
+        buffer_[(first_ + size_) % buffer_.size()] = entry;
+        ++size_;
+    }
+    if (step_ % flush_interval_ == 0) flush();
+}
+
+void telemetry::flush()
+{
+    if (size_ == 0) return;
+    char number[32];
+    for (auto k = 0u; k < size_; ++k)
+    {
+        const auto &entry = buffer_[(first_ + k) % buffer_.size()];
+        lines_ += "{\"step\":" + std::to_string(entry.step);
+        for (auto m = 0u; m < num_metrics_; ++m)
+        {
+            if (!(entry.mask & (1u << m))) continue;
+            // JSON has no representation of nan and inf
+            if (std::isfinite(entry.values[m]))
+            {
+                std::snprintf(number, sizeof(number), "%.9g", entry.values[m]);
+            }
+            else
+            {
+                std::strcpy(number, "null");
+            }
+            lines_ += ",\"" + std::string(metric_keys[m]) + "\":" + number;
+        }  // m
+        lines_ += "}\n";
+    }  // k
+    first_ = (first_ + size_) % buffer_.size();
+    size_ = 0;
+    if (sink_ == JSON_FILE)
+    {
+        file_ << lines_;
+        file_.flush();
+        lines_.clear();
+    }
+    else
+    {
+        // a slow or closed listener must not stop the simulation, so the socket
+        // is never waited for: the records it does not take are dropped
+        auto sent = std::size_t {0};
+        while (socket_ >= 0 && sent < lines_.size())
+        {
+            const auto n = ::send(socket_, lines_.data() + sent, lines_.size() - sent,
+                                  MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n >= 0)
+            {
+                sent += n;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            else if (errno != EINTR)
+            {
+                ::close(socket_);
+                socket_ = -1;
+            }
+        }
+        // the rest of a partly sent line, including one left from an earlier
+        // flush, is never dropped, or the listener would see it glued to the
+        // next record. It is finished first at the next flush
+        auto kept = std::size_t {0};
+        const auto is_partly_sent = sent < pending_bytes_ || (sent > 0 && lines_[sent - 1] != '\n');
+        if (socket_ >= 0 && sent < lines_.size() && is_partly_sent)
+        {
+            kept = lines_.find('\n', sent) + 1 - sent;
+        }
+        num_dropped_ += std::count(lines_.begin() + sent + kept, lines_.end(), '\n');
+        lines_.erase(0, sent);
+        lines_.resize(kept);
+        pending_bytes_ = kept;
+    }
+}
+
+std::size_t telemetry::getNumberOfDroppedRecords() const
+{
+    return num_dropped_;
+}
+
+double telemetry::computeMass() const
+{
+    auto mass = 0.0;
+    for (auto rho : cb_.rho_) mass += rho;
+    return mass;
+}
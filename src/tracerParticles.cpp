@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "latticeModel.hxx"
+
+#include "latticeBase.hpp"
+#include "tracerParticles.hpp"
+
+namespace
+{
+    // Edges in the order of setBoundaries()
+    const std::size_t right = 0;
+    const std::size_t top = 1;
+    const std::size_t left = 2;
+    const std::size_t bottom = 3;
+
+    // Number of steps between two sorts of the particles by tile. Particles
+    // move less than a node per step, so the tiles of the particles stay close
+    // to their bins for several steps
+    const std::size_t sort_interval = 16;
+
+    // First bytes of a trajectory file
+    const char lbmp_magic[] = {'L', 'B', 'M', 'P'};
+
+    // Version of the trajectory format
+    const std::uint64_t lbmp_version = 1;
+
+    // Number of particles whose stages are computed together
+    const std::size_t block_size = 64;
+
+    // Runge-Kutta stages: fraction of the velocity of the last stage which
+    // moves the position of a stage and weight of the velocity of a stage
+    const double rk2_offsets[] = {0.0, 0.5};
+    const double rk2_weights[] = {0.0, 1.0};
+    const double rk4_offsets[] = {0.0, 0.5, 0.5, 1.0};
+    const double rk4_weights[] = {1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0};
+
+    // Position for the interpolation, beyond the outermost nodes the velocity
+    // of the edge is held and periodic positions wrap around
+    inline double getPosition(double position, std::size_t num_nodes, bool is_periodic)
+    {
+        const auto length = static_cast<double>(num_nodes);
+        if (!is_periodic) return std::min(std::max(position, 0.0), length - 1.0);
+        if (position < 0.0 || position >= length) position -= std::floor(position / length) * length;
+        return position < length ? position : 0.0;
+    }
+
+    // Bilinear interpolation of a velocity copy whose rows have width nodes,
+    // the components are given in nodes per time step
+    inline void interpolate(const float *u, std::size_t width, double x, double y, double &u_x, double &u_y)
+    {
+        // positions are not negative, the signed conversion is a single
+        // instruction
+        const auto x_0 = static_cast<long>(x);
+        const auto y_0 = static_cast<long>(y);
+        const auto f_x = x - x_0;
+        const auto f_y = y - y_0;
+        const auto *lower = u + 2 * (y_0 * width + x_0);
+        const auto *upper = lower + 2 * width;
+        u_x = (1.0 - f_y) * ((1.0 - f_x) * lower[0] + f_x * lower[2]) +
+              f_y * ((1.0 - f_x) * upper[0] + f_x * upper[2]);
+        u_y = (1.0 - f_y) * ((1.0 - f_x) * lower[1] + f_x * lower[3]) +
+              f_y * ((1.0 - f_x) * upper[1] + f_x * upper[3]);
+    }
+
+    // Writes an unsigned integer of the trajectory file
+    void writeInteger(std::ostream &out, std::uint64_t value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+tracerParticles::tracerParticles
+(
+    latticeBase &lb,
+    fluidField &field,
+    e_integrators integrator,
+    std::size_t tile_size
+)
+: lb_ (lb),
+  nx_ {lb.getNumberOfNx()},
+  ny_ {lb.getNumberOfNy()},
+  field_ (field),
+  integrator_ {integrator},
+  tile_size_ {tile_size},
+  num_tiles_x_ {0},
+  num_tiles_y_ {0},
+  boundaries_ (4, WALL),
+  is_solid_ {},
+  u_ {},
+  u_last_ {},
+  u_half_ {},
+  is_started_ {false},
+  x_ {},
+  y_ {},
+  id_ {},
+  sorted_x_ {},
+  sorted_y_ {},
+  sorted_id_ {},
+  tile_first_ {},
+  is_sorted_ {false},
+  num_unsorted_steps_ {0},
+  file_ {},
+  interval_ {0},
+  record_ {},
+  is_header_written_ {false}
+{
+    if (nx_ < 2 || ny_ < 2) throw std::runtime_error("Tracers need at least two nodes along each side");
+    if (tile_size_ == 0) throw std::runtime_error("Tile size must be positive");
+    num_tiles_x_ = (nx_ + tile_size_ - 1) / tile_size_;
+    num_tiles_y_ = (ny_ + tile_size_ - 1) / tile_size_;
+    is_solid_.assign(nx_ * ny_, 0);
+    u_.assign(2 * (nx_ + 1) * (ny_ + 1), 0.0f);
+    u_last_ = u_;
+    u_half_ = u_;
+}
+
+void tracerParticles::setBoundaries
+(
+    e_boundaries right_edge,
+    e_boundaries top_edge,
+    e_boundaries left_edge,
+    e_boundaries bottom_edge
+)
+{
+    if ((right_edge == PERIODIC) != (left_edge == PERIODIC) ||
+        (top_edge == PERIODIC) != (bottom_edge == PERIODIC))
+    {
+        throw std::runtime_error("Periodic edges need a periodic opposite edge");
+    }
+    boundaries_ = {right_edge, top_edge, left_edge, bottom_edge};
+}
+
+void tracerParticles::addSolidNode
+(
+    std::size_t x,
+    std::size_t y
+)
+{
+    if (x >= nx_ || y >= ny_) throw std::runtime_error("Solid node outside of lattice");
+    is_solid_[y * nx_ + x] = 1;
+    for (auto p = 0u; p < x_.size(); ++p)
+    {
+        if (std::lround(x_[p]) == static_cast<long>(x) && std::lround(y_[p]) == static_cast<long>(y))
+        {
+            x_[p] = std::numeric_limits<double>::quiet_NaN();
+            y_[p] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }  // p
+    is_sorted_ = false;
+}
+
+std::size_t tracerParticles::addParticle
+(
+    double x,
+    double y
+)
+{
+    if (is_header_written_) throw std::runtime_error("Particles cannot be added after trajectories");
+    if (!(x >= -0.5 && x < nx_ - 0.5 && y >= -0.5 && y < ny_ - 0.5))
+    {
+        throw std::runtime_error("Particle outside of lattice");
+    }
+    if (isSolid(std::lround(x), std::lround(y))) throw std::runtime_error("Particle in solid cell");
+    const auto id = id_.size();
+    if (id >= std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("Too many particles");
+    x_.push_back(x);
+    y_.push_back(y);
+    id_.push_back(static_cast<std::uint32_t>(id));
+    is_sorted_ = false;
+    return id;
+}
+
+void tracerParticles::addParticles
+(
+    double x_min,
+    double y_min,
+    double x_max,
+    double y_max,
+    std::size_t num_x,
+    std::size_t num_y
+)
+{
+    if (is_header_written_) throw std::runtime_error("Particles cannot be added after trajectories");
+    if (!(x_min >= -0.5 && x_max < nx_ - 0.5 && x_min <= x_max && y_min >= -0.5 && y_max < ny_ - 0.5 &&
+          y_min <= y_max))
+    {
+        throw std::runtime_error("Particles outside of lattice");
+    }
+    const auto dx = num_x > 1 ? (x_max - x_min) / (num_x - 1) : 0.0;
+    const auto dy = num_y > 1 ? (y_max - y_min) / (num_y - 1) : 0.0;
+    x_.reserve(x_.size() + num_x * num_y);
+    y_.reserve(y_.size() + num_x * num_y);
+    id_.reserve(id_.size() + num_x * num_y);
+    for (auto j = 0u; j < num_y; ++j)
+    {
+        for (auto i = 0u; i < num_x; ++i)
+        {
+            const auto x = x_min + i * dx;
+            const auto y = y_min + j * dy;
+            if (!isSolid(std::lround(x), std::lround(y))) addParticle(x, y);
+        }  // i
+    }  // j
+}
+
+void tracerParticles::enableTrajectories
+(
+    const std::string &file_name,
+    std::size_t interval
+)
+{
+    if (interval == 0) throw std::runtime_error("Trajectory interval must be positive");
+    file_.open(file_name, std::ios::binary);
+    if (!file_) throw std::runtime_error("Error in opening " + file_name);
+    interval_ = interval;
+}
+
+void tracerParticles::advance
+(
+    std::size_t time
+)
+{
+    copyVelocity();
+    if (!is_sorted_ || num_unsorted_steps_ >= sort_interval) sortParticles();
+    ++num_unsorted_steps_;
+    const long num_tiles = num_tiles_x_ * num_tiles_y_;
+    const auto nx = static_cast<double>(nx_);
+    const auto ny = static_cast<double>(ny_);
+    const auto width = nx_ + 1;
+    const auto is_periodic_x = boundaries_[left] == PERIODIC;
+    const auto is_periodic_y = boundaries_[bottom] == PERIODIC;
+    // velocity of each stage: the last step, twice the half step for RK4 and
+    // the current step
+    const auto num_stages = integrator_ == RK2 ? 2u : 4u;
+    const float *u_stages[] = {u_last_.data(), u_half_.data(), u_half_.data(), u_.data()};
+    const auto *offsets = integrator_ == RK2 ? rk2_offsets : rk4_offsets;
+    const auto *weights = integrator_ == RK2 ? rk2_weights : rk4_weights;
+    // tiles hold different numbers of particles
+    #pragma omp parallel for schedule(dynamic)
+    for (long t = 0; t < num_tiles; ++t)
+    {
+        double x[block_size], y[block_size], k_x[block_size], k_y[block_size];
+        double x_next[block_size], y_next[block_size];
+        // the stages run over blocks of particles, so that the interpolations
+        // of different particles overlap instead of waiting for each other
+        for (auto first = tile_first_[t]; first < tile_first_[t + 1]; first += block_size)
+        {
+            const auto num_particles = std::min(block_size, tile_first_[t + 1] - first);
+            for (auto b = 0u; b < num_particles; ++b)
+            {
+                // particles removed since the last sort are interpolated at the origin
+                // and not stored
+                const auto is_removed = std::isnan(x_[first + b]);
+                x[b] = is_removed ? 0.0 : x_[first + b];
+                y[b] = is_removed ? 0.0 : y_[first + b];
+                k_x[b] = 0.0;
+                k_y[b] = 0.0;
+                x_next[b] = x[b];
+                y_next[b] = y[b];
+            }  // b
+            for (auto s = 0u; s < num_stages; ++s)
+            {
+                for (auto b = 0u; b < num_particles; ++b)
+                {
+                    const auto stage_x = getPosition(x[b] + offsets[s] * k_x[b], nx_, is_periodic_x);
+                    const auto stage_y = getPosition(y[b] + offsets[s] * k_y[b], ny_, is_periodic_y);
+                    interpolate(u_stages[s], width, stage_x, stage_y, k_x[b], k_y[b]);
+                    x_next[b] += weights[s] * k_x[b];
+                    y_next[b] += weights[s] * k_y[b];
+                }  // b
+            }  // s
+            for (auto b = 0u; b < num_particles; ++b)
+            {
+                const auto p = first + b;
+                if (std::isnan(x_[p])) continue;
+                // most particles stay in fluid cells, the edges lie half a node
+                // beyond the outermost nodes
+                const auto is_inside = x_next[b] >= -0.5 && x_next[b] < nx - 0.5 && y_next[b] >= -0.5 &&
+                                       y_next[b] < ny - 0.5;
+                if (!is_inside ||
+                    is_solid_[static_cast<long>(y_next[b] + 0.5) * nx_ + static_cast<long>(x_next[b] + 0.5)])
+                {
+                    applyBoundaries(x[b], y[b], x_next[b], y_next[b]);
+                }
+                x_[p] = x_next[b];
+                y_[p] = y_next[b];
+            }  // b
+        }  // first
+    }  // t
+    if (file_.is_open() && time % interval_ == 0) writeTrajectories(time);
+}
+
+void tracerParticles::getPositions
+(
+    std::vector<double> &x,
+    std::vector<double> &y
+) const
+{
+    x.assign(id_.size(), 0.0);
+    y.assign(id_.size(), 0.0);
+    for (auto p = 0u; p < id_.size(); ++p)
+    {
+        x[id_[p]] = x_[p];
+        y[id_[p]] = y_[p];
+    }  // p
+}
+
+std::size_t tracerParticles::getNumberOfParticles() const
+{
+    return id_.size();
+}
+
+std::size_t tracerParticles::getNumberOfActiveParticles() const
+{
+    return std::count_if(x_.begin(), x_.end(), [](double x) { return !std::isnan(x); });
+}
+
+void tracerParticles::copyVelocity()
+{
+    const long ny = ny_;
+    const auto width = nx_ + 1;
+    const auto is_periodic_x = boundaries_[left] == PERIODIC;
+    const auto is_periodic_y = boundaries_[bottom] == PERIODIC;
+    // the velocity of the fluid field is given in space steps per time step
+    const auto scale = lb_.getTimeStep() / lb_.getSpaceStep();
+    std::swap(u_, u_last_);
+    #pragma omp parallel for schedule(static)
+    for (long y = 0; y < ny; ++y)
+    {
+        auto *row = u_.data() + 2 * y * width;
+        for (auto x = 0u; x < nx_; ++x)
+        {
+            const auto *u = field_.u[lb_.getNodeIndex(x, y)];
+            const auto is_solid = is_solid_[y * nx_ + x] != 0;
+            row[2 * x] = is_solid ? 0.0f : static_cast<float>(u[0] * scale);
+            row[2 * x + 1] = is_solid ? 0.0f : static_cast<float>(u[1] * scale);
+        }  // x
+        const auto edge = is_periodic_x ? 0 : nx_ - 1;
+        row[2 * nx_] = row[2 * edge];
+        row[2 * nx_ + 1] = row[2 * edge + 1];
+    }  // y
+    const auto edge = is_periodic_y ? 0 : ny_ - 1;
+    std::copy(u_.begin() + 2 * edge * width, u_.begin() + 2 * (edge + 1) * width,
+              u_.begin() + 2 * ny_ * width);
+    if (!is_started_)
+    {
+        // the first step has no velocity of the last step to start from
+        u_last_ = u_;
+        is_started_ = true;
+    }
+    const long num_values = u_.size();
+    #pragma omp parallel for schedule(static)
+    for (long k = 0; k < num_values; ++k) u_half_[k] = 0.5f * (u_last_[k] + u_[k]);
+}
+
+void tracerParticles::sortParticles()
+{
+    const auto num_tiles = num_tiles_x_ * num_tiles_y_;
+    const auto num_particles = x_.size();
+    // counting sort, tile t is counted at t + 2 so that after the scatter
+    // tile_first_[t] is the first particle of tile t
+    tile_first_.assign(num_tiles + 3, 0);
+    for (auto p = 0u; p < num_particles; ++p) ++tile_first_[getTile(x_[p], y_[p]) + 2];
+    for (auto t = 2u; t < tile_first_.size(); ++t) tile_first_[t] += tile_first_[t - 1];
+    sorted_x_.resize(num_particles);
+    sorted_y_.resize(num_particles);
+    sorted_id_.resize(num_particles);
+    for (auto p = 0u; p < num_particles; ++p)
+    {
+        const auto q = tile_first_[getTile(x_[p], y_[p]) + 1]++;
+        sorted_x_[q] = x_[p];
+        sorted_y_[q] = y_[p];
+        sorted_id_[q] = id_[p];
+    }  // p
+    std::swap(x_, sorted_x_);
+    std::swap(y_, sorted_y_);
+    std::swap(id_, sorted_id_);
+    is_sorted_ = true;
+    num_unsorted_steps_ = 0;
+}
+
+void tracerParticles::applyBoundaries
+(
+    double x_last,
+    double y_last,
+    double &x,
+    double &y
+) const
+{
+    const auto nx = static_cast<double>(nx_);
+    const auto ny = static_cast<double>(ny_);
+    // the edges lie half a node beyond the outermost nodes
+    const std::pair<double*, std::size_t> crossings[] =
+    {
+        {&x, x < -0.5 ? left : (x > nx - 0.5 ? right : 4)},
+        {&y, y < -0.5 ? bottom : (y > ny - 0.5 ? top : 4)}
+    };
+    for (const auto &crossing : crossings)
+    {
+        if (crossing.second == 4) continue;
+        const auto boundary = boundaries_[crossing.second];
+        if (boundary == OPEN)
+        {
+            x = std::numeric_limits<double>::quiet_NaN();
+            y = std::numeric_limits<double>::quiet_NaN();
+            return;
+        }
+        if (boundary == WALL)
+        {
+            const auto wall = crossing.second == left || crossing.second == bottom ? -0.5 :
+                              (crossing.second == right ? nx : ny) - 0.5;
+            *crossing.first = 2.0 * wall - *crossing.first;
+        }
+    }  // crossing
+    const auto cell_x = std::lround(x);
+    const auto cell_y = std::lround(y);
+    if (isSolid(cell_x, cell_y))
+    {
+        // reflects at the faces between the last cell and the solid cells
+        const auto last_x = std::lround(x_last);
+        const auto last_y = std::lround(y_last);
+        if (cell_x != last_x && isSolid(cell_x, last_y)) x = static_cast<double>(cell_x + last_x) - x;
+        if (cell_y != last_y && isSolid(last_x, cell_y)) y = static_cast<double>(cell_y + last_y) - y;
+        // corners and steps longer than a cell keep the particle in place
+        if (isSolid(std::lround(x), std::lround(y)))
+        {
+            x = x_last;
+            y = y_last;
+        }
+    }
+    if (boundaries_[left] == PERIODIC) x -= std::floor((x + 0.5) / nx) * nx;
+    if (boundaries_[bottom] == PERIODIC) y -= std::floor((y + 0.5) / ny) * ny;
+}
+
+bool tracerParticles::isSolid
+(
+    long x,
+    long y
+) const
+{
+    const long nx = nx_;
+    const long ny = ny_;
+    if (x < 0 || x >= nx)
+    {
+        if (boundaries_[left] != PERIODIC) return true;
+        x = (x % nx + nx) % nx;
+    }
+    if (y < 0 || y >= ny)
+    {
+        if (boundaries_[bottom] != PERIODIC) return true;
+        y = (y % ny + ny) % ny;
+    }
+    return is_solid_[y * nx + x] != 0;
+}
+
+std::size_t tracerParticles::getTile
+(
+    double x,
+    double y
+) const
+{
+    if (std::isnan(x)) return num_tiles_x_ * num_tiles_y_;
+    const long nx = nx_;
+    const long ny = ny_;
+    const auto cell_x = std::min(std::max(std::lround(x), 0l), nx - 1);
+    const auto cell_y = std::min(std::max(std::lround(y), 0l), ny - 1);
+    return (cell_y / tile_size_) * num_tiles_x_ + cell_x / tile_size_;
+}
+
+void tracerParticles::writeTrajectories
+(
+    std::size_t time
+)
+{
+    const auto num_particles = id_.size();
+    if (!is_header_written_)
+    {
+        file_.write(lbmp_magic, sizeof(lbmp_magic));
+        writeInteger(file_, lbmp_version);
+        writeInteger(file_, num_particles);
+        writeInteger(file_, nx_);
+        writeInteger(file_, ny_);
+        record_.resize(2 * num_particles);
+        is_header_written_ = true;
+    }
+    const long num_sorted = num_particles;
+    #pragma omp parallel for schedule(static)
+    for (long p = 0; p < num_sorted; ++p)
+    {
+        record_[2 * id_[p]] = static_cast<float>(x_[p]);
+        record_[2 * id_[p] + 1] = static_cast<float>(y_[p]);
+    }  // p
+    writeInteger(file_, time);
+    file_.write(reinterpret_cast<const char*>(record_.data()), record_.size() * sizeof(float));
+    if (!file_) throw std::runtime_error("Error in writing trajectories");
+}
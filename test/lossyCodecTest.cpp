@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "latticeArray.hxx"
+
+#include "lossyCodec.hpp"
+#include "result.hpp"
+
+// Round trip tests of lossyCodec: every reconstructed value must lie within the
+// error bound, non-finite values must come back exactly and corrupted streams
+// and .lbmz files must raise std::runtime_error
+namespace
+{
+    // Number of failed checks
+    std::size_t num_failures = 0;
+
+    // Counts and prints a failed check
+    void check(bool is_ok, const std::string &message)
+    {
+        if (is_ok) return;
+        ++num_failures;
+        std::cout << "FAIL " << message << std::endl;
+    }
+
+    // Smooth field with NaN, infinite and spike outliers on the first and last
+    // rows and columns of the stripes and of the field. Huge finite spikes only
+    // test ABSOLUTE bounds, as they would widen the range of RELATIVE bounds
+    std::vector<double> makeField
+    (
+        std::size_t nx,
+        std::size_t ny,
+        std::size_t stripe_rows,
+        double spike
+    )
+    {
+        std::vector<double> values(nx * ny);
+        for (auto y = 0u; y < ny; ++y)
+        {
+            for (auto x = 0u; x < nx; ++x)
+            {
+                values[y * nx + x] = std::sin(0.3 * x) * std::cos(0.2 * y) + 0.01 * x;
+            }  // x
+        }  // y
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+        const auto inf = std::numeric_limits<double>::infinity();
+        values[0] = nan;
+        values[nx - 1] = inf;
+        values[nx * ny - 1] = -inf;
+        values[(ny - 1) * nx] = spike;
+        for (auto y = stripe_rows; y < ny; y += stripe_rows)
+        {
+            // last value of a stripe and first value of the next
+            values[y * nx - 1] = nan;
+            values[y * nx] = y % 2 == 0 ? inf : -spike;
+        }  // y
+        return values;
+    }
+
+    // Compresses and decompresses a field and checks every value against the
+    // bound, which is relative to the range of the finite values for RELATIVE
+    void checkRoundTrip
+    (
+        lossyCodec::e_bounds bound,
+        double error_bound,
+        std::size_t nx,
+        std::size_t ny,
+        std::size_t stripe_rows
+    )
+    {
+        const auto name = std::string(bound == lossyCodec::ABSOLUTE ? "ABSOLUTE" : "RELATIVE") +
+                          " " + std::to_string(nx) + "x" + std::to_string(ny) + " stripes of " +
+                          std::to_string(stripe_rows) + ": ";
+        const auto spike = bound == lossyCodec::ABSOLUTE ? 1.0e300 : std::nan("");
+        const auto values = makeField(nx, ny, stripe_rows, spike);
+        auto absolute_bound = error_bound;
+        if (bound == lossyCodec::RELATIVE)
+        {
+            auto min_value = HUGE_VAL;
+            auto max_value = -HUGE_VAL;
+            for (auto v : values)
+            {
+                if (!std::isfinite(v)) continue;
+                min_value = std::min(min_value, v);
+                max_value = std::max(max_value, v);
+            }  // v
+            absolute_bound *= max_value - min_value;
+        }
+        lossyCodec codec(bound, error_bound, stripe_rows);
+        std::stringstream stream;
+        const auto stats = codec.compress(values, nx, ny, stream);
+        check(stats.max_error <= absolute_bound, name + "reported error above the bound");
+        check(stats.compressed_bytes >= lossyCodec::getMinimumCompressedSize(nx, ny),
+              name + "smaller than the minimum compressed size");
+        std::vector<double> reconstructed;
+        lossyCodec::decompress(stream, nx, ny, reconstructed);
+        check(reconstructed.size() == values.size(), name + "wrong number of values");
+        if (reconstructed.size() != values.size()) return;
+        auto max_error = 0.0;
+        for (auto n = 0u; n < values.size(); ++n)
+        {
+            const auto v = values[n];
+            const auto r = reconstructed[n];
+            if (std::isnan(v))
+            {
+                check(std::isnan(r), name + "NaN not restored at " + std::to_string(n));
+            }
+            else if (std::isinf(v))
+            {
+                check(r == v, name + "infinity not restored at " + std::to_string(n));
+            }
+            else
+            {
+                max_error = std::max(max_error, std::fabs(r - v));
+                check(std::fabs(r - v) <= absolute_bound, name + "error above the bound at " +
+                      std::to_string(n));
+            }
+        }  // n
+        std::cout << name << "max |r - v| " << max_error << ", bound " << absolute_bound << ", "
+                  << stats.raw_bytes << " -> " << stats.compressed_bytes << " bytes" << std::endl;
+    }
+
+    // Checks that a corrupted or truncated stream raises std::runtime_error
+    void checkCorruption()
+    {
+        const std::size_t nx = 16;
+        const std::size_t ny = 12;
+        lossyCodec codec(lossyCodec::ABSOLUTE, 1.0e-3, 4);
+        std::stringstream stream;
+        codec.compress(makeField(nx, ny, 4, 1.0e300), nx, ny, stream);
+        const auto bytes = stream.str();
+        // the header holds the error bound, the stripe rows and the stripe sizes
+        const auto size_offset = sizeof(double) + sizeof(std::uint64_t);
+        const std::vector<std::uint64_t> bad_sizes = {std::uint64_t {1} << 62,
+                                                      std::numeric_limits<std::uint64_t>::max(),
+                                                      bytes.size()};
+        for (auto bad_size : bad_sizes)
+        {
+            auto corrupted = bytes;
+            std::memcpy(&corrupted[size_offset], &bad_size, sizeof(bad_size));
+            std::stringstream in(corrupted);
+            std::vector<double> values;
+            auto is_runtime_error = false;
+            try
+            {
+                lossyCodec::decompress(in, nx, ny, values);
+            }
+            catch (const std::runtime_error&)
+            {
+                is_runtime_error = true;
+            }
+            catch (...)
+            {
+            }
+            check(is_runtime_error, "stripe size " + std::to_string(bad_size) +
+                  " does not raise runtime_error");
+        }  // bad_size
+        std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+        std::vector<double> values;
+        auto is_runtime_error = false;
+        try
+        {
+            lossyCodec::decompress(truncated, nx, ny, values);
+        }
+        catch (const std::runtime_error&)
+        {
+            is_runtime_error = true;
+        }
+        check(is_runtime_error, "truncated field does not raise runtime_error");
+        // a constant field compresses to the smallest possible size
+        std::stringstream constant;
+        const auto constant_bytes = codec.compress(std::vector<double>(nx * ny, 0.0), nx, ny,
+                                                   constant).compressed_bytes;
+        check(constant_bytes >= lossyCodec::getMinimumCompressedSize(nx, ny),
+              "constant field smaller than the minimum compressed size");
+    }
+
+    // Header of a .lbmz file, the sizes of the fields are written as given
+    struct lbmzHeader
+    {
+        std::uint64_t nx;
+        std::uint64_t ny;
+        std::uint64_t num_fields;
+        std::uint64_t name_length;
+        std::uint64_t num_components;
+    };
+
+    // Writes a .lbmz file of a pressure field with the sizes of a header, the
+    // compressed pressure always has the size of a 16 x 12 lattice
+    void writeFile
+    (
+        const std::string &file_name,
+        const lbmzHeader &header
+    )
+    {
+        const std::size_t nx = 16;
+        const std::size_t ny = 12;
+        std::ofstream out(file_name, std::ios::binary);
+        const auto write = [&out](std::uint64_t value)
+        {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        out.write("LBMZ", 4);
+        write(1);
+        write(header.nx);
+        write(header.ny);
+        write(0);
+        write(header.num_fields);
+        const std::string name = "relative_pressure";
+        write(header.name_length);
+        out.write(name.data(), std::min<std::uint64_t>(name.size(), header.name_length));
+        write(header.num_components);
+        lossyCodec codec(lossyCodec::ABSOLUTE, 1.0e-3, 4);
+        codec.compress(makeField(nx, ny, 4, 1.0e300), nx, ny, out);
+    }
+
+    // Checks that .lbmz headers with sizes the file cannot hold raise
+    // std::runtime_error before anything is allocated for them
+    void checkHeader()
+    {
+        const auto file_name = "lbm_codec_test_" + std::to_string(::getpid()) + ".lbmz";
+        const std::uint64_t huge = std::uint64_t {1} << 62;
+        const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+        const std::vector<std::pair<std::string, lbmzHeader>> headers =
+        {
+            {"lattice of 2^62 x 2^62 nodes", {huge, huge, 1, 17, 1}},
+            {"lattice of 2^64 - 1 x 2 nodes", {max, 2, 1, 17, 1}},
+            {"lattice larger than the file", {4096, 4096, 1, 17, 1}},
+            {"lattice without nodes", {0, 12, 1, 17, 1}},
+            {"2^62 fields", {16, 12, huge, 17, 1}},
+            {"name of 2^62 characters", {16, 12, 1, huge, 1}},
+            {"name longer than the file", {16, 12, 1, 100000, 1}},
+            {"2^62 components", {16, 12, 1, 17, huge}},
+            {"2^64 - 1 components", {16, 12, 1, 17, max}}
+        };
+        for (auto &header : headers)
+        {
+            writeFile(file_name, header.second);
+            auto is_runtime_error = false;
+            try
+            {
+                result::convertToVTK(file_name);
+            }
+            catch (const std::runtime_error&)
+            {
+                is_runtime_error = true;
+            }
+            catch (...)
+            {
+            }
+            check(is_runtime_error, header.first + " does not raise runtime_error");
+        }  // header
+        // the untouched header is read, but holds no velocity
+        writeFile(file_name, {16, 12, 1, 17, 1});
+        auto message = std::string {};
+        try
+        {
+            result::convertToVTK(file_name);
+        }
+        catch (const std::runtime_error &error)
+        {
+            message = error.what();
+        }
+        check(message == file_name + " holds no pressure and velocity", "valid header not read: " +
+              message);
+        std::remove(file_name.c_str());
+    }
+}
+
+int main()
+{
+    for (auto bound : {lossyCodec::ABSOLUTE, lossyCodec::RELATIVE})
+    {
+        const auto error_bound = bound == lossyCodec::ABSOLUTE ? 1.0e-3 : 1.0e-4;
+        // stripes which divide the rows, a shorter last stripe, single rows and a
+        // single stripe
+        checkRoundTrip(bound, error_bound, 37, 24, 6);
+        checkRoundTrip(bound, error_bound, 37, 23, 5);
+        checkRoundTrip(bound, error_bound, 9, 7, 1);
+        checkRoundTrip(bound, error_bound, 64, 10, 32);
+    }  // bound
+    checkCorruption();
+    checkHeader();
+    std::cout << (num_failures == 0 ? "lossyCodec passed" : "lossyCodec FAILED") << std::endl;
+    return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "validation.hpp"
+
+// lbm_validation [--record] [--enforce-mlups] [--tolerance band] [baseline_file]
+// runs the validation suite, --record writes the MLUPS of this machine to the
+// baseline file instead of comparing them, --enforce-mlups fails runs below the
+// MLUPS band instead of reporting them and --tolerance sets the relative MLUPS
+// band below the baseline, 0.25 by default
+int main(int argc, char *argv[])
+{
+    auto is_recording = false;
+    auto is_enforcing_mlups = false;
+    auto mlups_tolerance = 0.25;
+    std::string baseline_file = "validation_baseline.csv";
+    try
+    {
+        for (auto a = 1; a < argc; ++a)
+        {
+            const std::string arg = argv[a];
+            if (arg == "--record")
+            {
+                is_recording = true;
+            }
+            else if (arg == "--enforce-mlups")
+            {
+                is_enforcing_mlups = true;
+            }
+            else if (arg == "--tolerance" && a + 1 < argc)
+            {
+                mlups_tolerance = std::stod(argv[++a]);
+            }
+            else
+            {
+                baseline_file = arg;
+            }
+        }  // a
+        validation suite
+        (
+            baseline_file,
+            mlups_tolerance,
+            is_recording,
+            is_enforcing_mlups
+        );
+        return suite.run() ? 0 : 1;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << baseline_file << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
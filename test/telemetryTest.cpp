@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "latticeModel.hxx"
+
+#include "latticeD2Q9.hpp"
+#include "collisionD2Q9_BGK.hpp"
+#include "telemetry.hpp"
+
+// Tests of the UNIX_SOCKET sink of telemetry: a listener which reads part of the
+// stream and then stops reading must neither block the steps nor receive a
+// broken JSON line, and every record is either received or counted as dropped
+namespace
+{
+    // Number of failed checks
+    std::size_t num_failures = 0;
+
+    // Counts and prints a failed check
+    void check(bool is_ok, const std::string &message)
+    {
+        if (is_ok) return;
+        ++num_failures;
+        std::cout << "FAIL " << message << std::endl;
+    }
+
+    // Reads at most max_bytes from a non-blocking socket
+    // return number of bytes read, 0 once nothing is left or at the end
+    std::size_t readSome
+    (
+        int socket,
+        std::size_t max_bytes,
+        std::string &received
+    )
+    {
+        std::vector<char> buffer(4096);
+        auto total = std::size_t {0};
+        while (total < max_bytes)
+        {
+            const auto n = ::read(socket, buffer.data(), std::min(buffer.size(), max_bytes - total));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            received.append(buffer.data(), n);
+            total += n;
+        }
+        return total;
+    }
+
+    // Checks that a line is a record {"step":s,...} of known metrics with a
+    // step after the previous one
+    bool isRecord
+    (
+        const std::string &line,
+        std::size_t &previous_step
+    )
+    {
+        const std::string head = "{\"step\":";
+        if (line.compare(0, head.size(), head) != 0 || line.back() != '}') return false;
+        std::size_t end = 0;
+        const auto step = std::stoul(line.substr(head.size()), &end);
+        if (step <= previous_step) return false;
+        previous_step = step;
+        auto pos = head.size() + end;
+        const std::vector<std::string> keys = {"\"step_time\":", "\"mass_drift\":"};
+        while (pos < line.size() - 1)
+        {
+            if (line[pos] != ',') return false;
+            ++pos;
+            auto is_key = false;
+            for (auto &key : keys)
+            {
+                if (line.compare(pos, key.size(), key) != 0) continue;
+                pos += key.size();
+                is_key = true;
+            }  // key
+            if (!is_key) return false;
+            if (line.compare(pos, 4, "null") == 0)
+            {
+                pos += 4;
+                continue;
+            }
+            try
+            {
+                std::stod(line.substr(pos), &end);
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+            pos += end;
+        }
+        return pos == line.size() - 1;
+    }
+
+    // Runs telemetry against a listener which alternates between reading part
+    // of the stream and not reading at all. A unix socket takes a send in
+    // segments of about half its buffer, so flushes larger than that are cut off
+    // inside a line and the following flushes find the socket full
+    void checkStalledListener()
+    {
+        const std::size_t nx = 16;
+        const std::size_t ny = 16;
+        const std::size_t num_rounds = 60;
+        const std::size_t steps_per_round = 3000;
+        const auto path = "lbm_telemetry_test_" + std::to_string(::getpid()) + ".sock";
+        const auto listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path.c_str());
+        ::unlink(path.c_str());
+        if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&address),
+                                   sizeof(address)) != 0 || ::listen(listener, 1) != 0)
+        {
+            check(false, "cannot listen on " + path);
+            return;
+        }
+
+        latticeModelD2Q9 D2Q9;
+        latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+        fluidField field(nx, ny, {0.0, 0.0});
+        collisionD2Q9_BGK collision(lattice, 0.1, 1.0, D2Q9, field);
+        std::string received;
+        std::size_t num_dropped = 0;
+        int reader = -1;
+        {
+            telemetry metrics
+            (
+                lattice,
+                collision,
+                field,
+                telemetry::UNIX_SOCKET,
+                path,
+                4096,
+                steps_per_round
+            );
+            reader = ::accept(listener, nullptr, nullptr);
+            ::fcntl(reader, F_SETFL, ::fcntl(reader, F_GETFL) | O_NONBLOCK);
+            metrics.addMetric(telemetry::STEP_TIME, 1);
+            metrics.addMetric(telemetry::MASS_DRIFT, 3);
+            for (auto r = 0u; r < num_rounds; ++r)
+            {
+                for (auto t = 0u; t < steps_per_round; ++t)
+                {
+                    metrics.startStep();
+                    metrics.endStep();
+                }  // t
+                // a stalled listener every other round, an odd number of bytes
+                // otherwise
+                if (r % 2 == 1) readSome(reader, 150000 + 1237 * r, received);
+            }  // r
+            num_dropped = metrics.getNumberOfDroppedRecords();
+        }
+        ::fcntl(reader, F_SETFL, ::fcntl(reader, F_GETFL) & ~O_NONBLOCK);
+        while (readSome(reader, 1 << 20, received) > 0) {}
+        ::close(reader);
+        ::close(listener);
+        ::unlink(path.c_str());
+
+        std::size_t num_lines = 0;
+        std::size_t previous_step = 0;
+        std::size_t pos = 0;
+        while (true)
+        {
+            const auto end = received.find('\n', pos);
+            if (end == std::string::npos) break;
+            const auto line = received.substr(pos, end - pos);
+            check(isRecord(line, previous_step), "broken line " + std::to_string(num_lines) +
+                  ": " + line.substr(0, 200));
+            ++num_lines;
+            pos = end + 1;
+        }
+        // a record cut off by closing the sink has no newline
+        const auto num_cut = pos < received.size() ? 1u : 0u;
+        const auto num_records = num_rounds * steps_per_round;
+        check(num_dropped > 0, "the stalled listener dropped no records");
+        check(num_lines + num_dropped + num_cut == num_records, std::to_string(num_lines) +
+              " received and " + std::to_string(num_dropped) + " dropped of " +
+              std::to_string(num_records) + " records");
+        std::cout << "stalled listener: " << num_lines << " records received, " << num_dropped
+                  << " dropped" << std::endl;
+    }
+}
+
+int main()
+{
+    checkStalledListener();
+    std::cout << (num_failures == 0 ? "telemetry passed" : "telemetry FAILED") << std::endl;
+    return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1089 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+
+#include "latticeBase.hpp"
+#include "latticeD2Q9.hpp"
+#include "collisionD2Q9_BGK.hpp"
+#include "collisionD2Q9_MRT.hpp"
+#include "collisionD2Q9_RBGK.hpp"
+#include "collisionD2Q9_CM.hpp"
+#include "collisionD2Q9_BGK_LES.hpp"
+#include "collisionD2Q9_MRT_LES.hpp"
+#include "collisionD2Q9_BGK_PRE.hpp"
+#include "collisionD2Q9_MRT_PRE.hpp"
+#include "collisionD2Q9_SC.hpp"
+#include "collisionD2Q9_BGK_ADE.hpp"
+#include "streamD2Q9.hpp"
+#include "nodeTypeField.hpp"
+#include "bouncebackNode.hpp"
+#include "ZouHeNode.hpp"
+#include "ZouHePressureNode.hpp"
+#include "periodicNode.hpp"
+#include "immersedBoundary.hpp"
+#include "outflowNode.hpp"
+#include "latticeBoltzmann.hpp"
+#include "loadBalancer.hpp"
+#include "momentComputing.h"
+#include "allocationCounter.hpp"
+#include "validation.hpp"
+
+namespace
+{
+    // Smagorinsky constant of the LES collision models
+    const double smagorinsky_constant = 0.1;
+
+    // Preconditioning parameter of the preconditioned collision models, the lid
+    // velocity of the cavity stays well below sqrt(gamma) * cs
+    const double preconditioning_gamma = 0.25;
+
+    // Tile size of the TILED engine, small enough to leave partial tiles
+    const std::size_t tile_size = 8;
+
+    // Number of timing windows of a run
+    const std::size_t num_windows = 10;
+
+    // Threads, nodes per chunk and sweeps between two rebalances of the
+    // LOAD_BALANCED engine. More threads than cores and chunks of part of a row
+    // leave chunks to be stolen, and the partition changes every few steps
+    const int balanced_threads = 4;
+    const std::size_t balanced_chunk_nodes = 24;
+    const std::size_t balanced_rebalance_interval = 5;
+
+    // Creates the load balancer of the LOAD_BALANCED engine and hands it to the
+    // collision model, nullptr for the other engines. Nodes skipped by the
+    // collision are solid
+    std::unique_ptr<loadBalancer> makeLoadBalancer
+    (
+        validation::e_engines engine,
+        latticeBase &lb,
+        collisionBase &cb
+    )
+    {
+        std::unique_ptr<loadBalancer> balancer;
+        if (engine != validation::LOAD_BALANCED) return balancer;
+        // the balancer takes its number of threads from OpenMP when it is created
+#ifdef _OPENMP
+        const auto num_threads = omp_get_max_threads();
+        omp_set_num_threads(std::max(num_threads, balanced_threads));
+#endif
+        balancer.reset(new loadBalancer(lb, balanced_chunk_nodes, balanced_rebalance_interval));
+#ifdef _OPENMP
+        omp_set_num_threads(num_threads);
+#endif
+        const auto num_nodes = lb.getNumberOfNx() * lb.getNumberOfNy();
+        std::vector<bool> solid(num_nodes, false);
+        for (auto n = 0u; n < num_nodes; ++n) solid[n] = cb.isNodeSkipped(n);
+        balancer->setCosts(solid, 1.0);
+        cb.setLoadBalancer(balancer.get());
+        return balancer;
+    }
+
+    // Adds markers of about one grid unit spacing on a circle
+    void addCircle
+    (
+        immersedBoundary &body,
+        double centre_x,
+        double centre_y,
+        double radius
+    )
+    {
+        const auto pi = std::acos(-1.0);
+        const auto num_markers = static_cast<std::size_t>(std::ceil(2.0 * pi * radius));
+        const auto length = 2.0 * pi * radius / num_markers;
+        for (auto m = 0u; m < num_markers; ++m)
+        {
+            const auto angle = 2.0 * pi * m / num_markers;
+            body.addMarker(centre_x + radius * std::cos(angle), centre_y + radius * std::sin(angle),
+                           length);
+        }  // m
+    }
+
+    // Runs the time steps and returns the million lattice updates per second of
+    // the fastest timing window, which is robust against other load on the machine.
+    // The heap allocations of all steps but the first, which may set up lazily,
+    // are counted in builds with COUNT_ALLOCATIONS
+    double timeSteps
+    (
+        latticeBoltzmann &run,
+        std::size_t num_nodes,
+        std::size_t num_steps,
+        std::size_t &num_allocations
+    )
+    {
+        auto mlups = 0.0;
+        auto first_allocations = getNumberOfAllocations();
+        for (auto w = 0u; w < num_windows; ++w)
+        {
+            const auto window_steps = num_steps / num_windows;
+            const auto start = std::chrono::steady_clock::now();
+            for (auto t = 0u; t < window_steps; ++t)
+            {
+                run.takeStep();
+                if (w == 0 && t == 0) first_allocations = getNumberOfAllocations();
+            }  // t
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            mlups = std::max(mlups, num_nodes * window_steps / elapsed.count() / 1.0e6);
+        }  // w
+        num_allocations = getNumberOfAllocations() - first_allocations;
+        return mlups;
+    }
+}
+
+validation::validation
+(
+    const std::string &baseline_file,
+    double mlups_tolerance,
+    bool is_recording,
+    bool is_enforcing_mlups
+)
+: baseline_file_ {baseline_file},
+  mlups_tolerance_ {mlups_tolerance},
+  is_recording_ {is_recording},
+  is_enforcing_mlups_ {is_enforcing_mlups},
+  baseline_ {},
+  collisions_ {"BGK", "MRT", "RBGK", "CM", "BGK_LES", "MRT_LES"}
+{
+    readBaseline();
+}
+
+std::unique_ptr<collisionBase> validation::makeCollision
+(
+    const std::string &name,
+    latticeBase &lb,
+    double kinematic_viscosity,
+    latticeModelD2Q9 &D2Q9,
+    fluidField &field
+)
+{
+    const auto rho0 = 1.0;
+    if (name == "BGK")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK(lb, kinematic_viscosity,
+            rho0, D2Q9, field));
+    }
+    if (name == "MRT")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT(lb, kinematic_viscosity,
+            rho0, D2Q9, field));
+    }
+    if (name == "RBGK")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_RBGK(lb, kinematic_viscosity,
+            rho0, D2Q9, field));
+    }
+    if (name == "CM")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_CM(lb, kinematic_viscosity,
+            rho0, D2Q9, field));
+    }
+    if (name == "BGK_LES")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK_LES(lb, kinematic_viscosity,
+            smagorinsky_constant, rho0, D2Q9, field));
+    }
+    if (name == "MRT_LES")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT_LES(lb, kinematic_viscosity,
+            smagorinsky_constant, rho0, D2Q9, field));
+    }
+    if (name == "BGK_PRE")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_BGK_PRE(lb, kinematic_viscosity,
+            preconditioning_gamma, rho0, D2Q9, field));
+    }
+    if (name == "MRT_PRE")
+    {
+        return std::unique_ptr<collisionBase>(new collisionD2Q9_MRT_PRE(lb, kinematic_viscosity,
+            preconditioning_gamma, rho0, D2Q9, field));
+    }
+    throw std::runtime_error("Unknown collision model " + name);
+}
+
+nodeOrdering::e_orderings validation::getOrdering
+(
+    e_engines engine
+)
+{
+    return engine == TILED ? nodeOrdering::HILBERT : nodeOrdering::ROW_MAJOR;
+}
+
+validation::runResult validation::runChannel
+(
+    const std::string &collision_name,
+    e_engines engine,
+    std::size_t band_rows,
+    bool is_couette
+)
+{
+    const std::size_t nx = 64;
+    const std::size_t ny = 17;
+    const std::size_t num_steps = 10000;
+    const auto visco = 0.1;
+    const auto u_max = 0.05;
+    // walls lie half a node outside of the bounceback rows, the moving wall of
+    // Couette flow on the Zou/He row
+    std::vector<double> u_exact(ny, 0.0);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        const auto y_wall = y + 0.5;
+        u_exact[y] = is_couette ? u_max * y_wall / (ny - 0.5) :
+                                  4.0 * u_max * y_wall * (ny - y_wall) / (ny * ny);
+    }  // y
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9, getOrdering(engine), tile_size);
+    auto collision = makeCollision(collision_name, lattice, visco, D2Q9, field);
+    nodeTypeField types(lattice, *collision, D2Q9, field);
+    streamD2Q9 stream_objects(lattice, D2Q9);
+    streamD2Q9 stream_typed(lattice, D2Q9, types);
+    // the SCHEDULED and LOAD_BALANCED engines run the boundaryNode objects of
+    // the OBJECTS engine
+    const auto is_objects = engine == OBJECTS || engine == SCHEDULED || engine == LOAD_BALANCED;
+    streamD2Q9 &stream = is_objects ? stream_objects : stream_typed;
+    bouncebackNode walls(lattice, &stream, D2Q9, field);
+    ZouHeNode lid(lattice, *collision, D2Q9, field);
+    ZouHeNode inlet(lattice, *collision, D2Q9, field);
+    ZouHePressureNode outlet(lattice, *collision, D2Q9, field);
+    latticeBoltzmann run(lattice, *collision, stream);
+
+    for (auto x = 0u; x < nx; ++x)
+    {
+        walls.addNode(x, 0);
+        if (is_couette)
+        {
+            lid.addNode(x, ny - 1, u_max, 0.0);
+        }
+        else
+        {
+            walls.addNode(x, ny - 1);
+        }
+    }  // x
+    for (auto y = 1u; y < ny - 1; ++y)
+    {
+        inlet.addNode(0, y, u_exact[y], 0.0);
+        outlet.addNode(nx - 1, y, 1.0);
+    }  // y
+    if (is_objects)
+    {
+        run.addBoundaryNode(&walls);
+        run.addBoundaryNode(&lid);
+        run.addBoundaryNode(&inlet);
+        run.addBoundaryNode(&outlet);
+    }
+    else
+    {
+        walls.registerNodes(types);
+        lid.registerNodes(types);
+        inlet.registerNodes(types);
+        outlet.registerNodes(types);
+    }
+
+    if (engine == SCHEDULED) run.enableTaskScheduling(band_rows);
+    const auto balancer = makeLoadBalancer(engine, lattice, *collision);
+
+    runResult result {0.0, 0.0, 0, {}};
+    result.mlups = timeSteps(run, nx * ny, num_steps, result.num_allocations);
+    const auto &df = run.getDistributionFunctions();
+    result.df.assign(df.data(), df.data() + df.size() * df.width());
+    auto error_sqr = 0.0;
+    auto norm_sqr = 0.0;
+    for (auto y = 0u; y < ny; ++y)
+    {
+        const auto u = field.u[lattice.getNodeIndex(nx / 2, y)][0];
+        error_sqr += (u - u_exact[y]) * (u - u_exact[y]);
+        norm_sqr += u_exact[y] * u_exact[y];
+    }  // y
+    result.error = std::sqrt(error_sqr / norm_sqr);
+    return result;
+}
+
+validation::runResult validation::runTaylorGreen
+(
+    const std::string &collision_name,
+    e_engines engine
+)
+{
+    const std::size_t nx = 32;
+    const std::size_t ny = 32;
+    const std::size_t num_steps = 500;
+    const auto visco = 0.05;
+    const auto u_0 = 0.01;
+    const auto pi = std::acos(-1.0);
+    const auto k = 2.0 * pi / nx;
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9, getOrdering(engine), tile_size);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        for (auto x = 0u; x < nx; ++x)
+        {
+            const auto n = lattice.getNodeIndex(x, y);
+            field.u[n][0] = -u_0 * std::cos(k * x) * std::sin(k * y);
+            field.u[n][1] =  u_0 * std::sin(k * x) * std::cos(k * y);
+        }  // x
+    }  // y
+    auto collision = makeCollision(collision_name, lattice, visco, D2Q9, field);
+    nodeTypeField types(lattice, *collision, D2Q9, field);
+    streamD2Q9 stream_objects(lattice, D2Q9);
+    streamD2Q9 stream_typed(lattice, D2Q9, types);
+    streamD2Q9 &stream = engine == OBJECTS ? stream_objects : stream_typed;
+    periodicNode edges(lattice, D2Q9);
+    latticeBoltzmann run(lattice, *collision, stream);
+    for (auto x = 0u; x < nx; ++x)
+    {
+        edges.addNode(x, 0);
+        edges.addNode(x, ny - 1);
+    }  // x
+    for (auto y = 1u; y < ny - 1; ++y)
+    {
+        edges.addNode(0, y);
+        edges.addNode(nx - 1, y);
+    }  // y
+    if (engine == OBJECTS)
+    {
+        run.addBoundaryNode(&edges);
+    }
+    else
+    {
+        edges.registerNodes(types);
+    }
+
+    auto kineticEnergy = [&field, nx, ny]()
+    {
+        auto energy = 0.0;
+        for (auto n = 0u; n < nx * ny; ++n)
+        {
+            energy += field.u[n][0] * field.u[n][0] + field.u[n][1] * field.u[n][1];
+        }  // n
+        return energy;
+    };
+    const auto energy_0 = kineticEnergy();
+    runResult result {0.0, 0.0, 0, {}};
+    result.mlups = timeSteps(run, nx * ny, num_steps, result.num_allocations);
+    const auto decay = std::exp(-4.0 * visco * k * k * num_steps);
+    result.error = std::abs(kineticEnergy() / energy_0 - decay) / decay;
+    return result;
+}
+
+validation::runResult validation::runCavity
+(
+    const std::string &collision_name,
+    e_engines engine,
+    std::size_t band_rows
+)
+{
+    const std::size_t nx = 64;
+    const std::size_t ny = 64;
+    const std::size_t num_steps = 8000;
+    const auto u_lid = 0.1;
+    const auto visco = u_lid * nx / 100.0;
+    // u_x / u_lid on the vertical centre line at Re = 100 from Ghia1982
+    const std::vector<double> y_ghia =
+    {
+        0.0000, 0.0547, 0.0625, 0.0703, 0.1016, 0.1719, 0.2813, 0.4531, 0.5000,
+        0.6172, 0.7344, 0.8516, 0.9531, 0.9609, 0.9688, 0.9766, 1.0000
+    };
+    const std::vector<double> u_ghia =
+    {
+        0.00000, -0.03717, -0.04192, -0.04775, -0.06434, -0.10150, -0.15662, -0.21090, -0.20581,
+        -0.13641, 0.00332, 0.23151, 0.68717, 0.73722, 0.78871, 0.84123, 1.00000
+    };
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9, getOrdering(engine), tile_size);
+    auto collision = makeCollision(collision_name, lattice, visco, D2Q9, field);
+    nodeTypeField types(lattice, *collision, D2Q9, field);
+    streamD2Q9 stream_objects(lattice, D2Q9);
+    streamD2Q9 stream_typed(lattice, D2Q9, types);
+    // the SCHEDULED and LOAD_BALANCED engines run the boundaryNode objects of
+    // the OBJECTS engine
+    const auto is_objects = engine == OBJECTS || engine == SCHEDULED || engine == LOAD_BALANCED;
+    streamD2Q9 &stream = is_objects ? stream_objects : stream_typed;
+    bouncebackNode walls(lattice, &stream, D2Q9, field);
+    ZouHeNode lid(lattice, *collision, D2Q9, field);
+    latticeBoltzmann run(lattice, *collision, stream);
+
+    // same boundaries as main.cpp
+    for (auto y = 0u; y < ny; ++y)
+    {
+        walls.addNode(0, y);
+        walls.addNode(nx - 1, y);
+    }  // y
+    for (auto x = 0u; x < nx; ++x)
+    {
+        walls.addNode(x, 0);
+        lid.addNode(x, ny - 1, u_lid, 0.0);
+    }  // x
+    if (is_objects)
+    {
+        run.addBoundaryNode(&walls);
+        run.addBoundaryNode(&lid);
+    }
+    else
+    {
+        walls.registerNodes(types);
+        lid.registerNodes(types);
+    }
+
+    if (engine == SCHEDULED) run.enableTaskScheduling(band_rows);
+    const auto balancer = makeLoadBalancer(engine, lattice, *collision);
+
+    runResult result {0.0, 0.0, 0, {}};
+    result.mlups = timeSteps(run, nx * ny, num_steps, result.num_allocations);
+    const auto &df = run.getDistributionFunctions();
+    result.df.assign(df.data(), df.data() + df.size() * df.width());
+    // the bottom wall lies half a node below row 0, the lid on row ny - 1 and the
+    // centre line between columns nx / 2 - 1 and nx / 2
+    std::vector<double> y_profile(1, 0.0);
+    std::vector<double> u_profile(1, 0.0);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        y_profile.push_back((y + 0.5) / (ny - 0.5));
+        u_profile.push_back(0.5 * (field.u[lattice.getNodeIndex(nx / 2 - 1, y)][0] +
+                                   field.u[lattice.getNodeIndex(nx / 2, y)][0]) / u_lid);
+    }  // y
+    for (auto k = 0u; k < y_ghia.size(); ++k)
+    {
+        auto j = 1u;
+        while (j < y_profile.size() - 1 && y_profile[j] < y_ghia[k]) ++j;
+        const auto w = (y_ghia[k] - y_profile[j - 1]) / (y_profile[j] - y_profile[j - 1]);
+        const auto u = (1.0 - w) * u_profile[j - 1] + w * u_profile[j];
+        result.error = std::max(result.error, std::abs(u - u_ghia[k]));
+    }  // k
+    return result;
+}
+
+validation::steadyResult validation::runSteadyCavity
+(
+    const std::string &collision_name
+)
+{
+    const std::size_t nx = 64;
+    const std::size_t ny = 64;
+    const std::size_t check_interval = 50;
+    const std::size_t max_steps = 50000;
+    const auto tolerance = 1.0e-4;
+    const auto u_lid = 0.1;
+    const auto visco = u_lid * nx / 100.0;
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+    auto collision = makeCollision(collision_name, lattice, visco, D2Q9, field);
+    nodeTypeField types(lattice, *collision, D2Q9, field);
+    streamD2Q9 stream(lattice, D2Q9, types);
+    latticeBoltzmann run(lattice, *collision, stream);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        types.addHalfwayBounceback(0, y);
+        types.addHalfwayBounceback(nx - 1, y);
+    }  // y
+    for (auto x = 0u; x < nx; ++x)
+    {
+        types.addHalfwayBounceback(x, 0);
+        types.addVelocity(x, ny - 1, u_lid, 0.0, false);
+    }  // x
+
+    steadyResult result {0, {}};
+    auto u_prev = field.u;
+    while (result.num_steps < max_steps)
+    {
+        for (auto t = 0u; t < check_interval; ++t) run.takeStep();
+        result.num_steps += check_interval;
+        if (checkSteadyState(u_prev, field.u, tolerance)) break;
+        u_prev = field.u;
+    }
+    for (auto y = 0u; y < ny; ++y)
+    {
+        result.u_centre.push_back(0.5 * (field.u[lattice.getNodeIndex(nx / 2 - 1, y)][0] +
+                                         field.u[lattice.getNodeIndex(nx / 2, y)][0]) / u_lid);
+    }  // y
+    return result;
+}
+
+bool validation::comparePreconditioning()
+{
+    const std::vector<std::string> preconditioned = {"BGK_PRE", "MRT_PRE"};
+    const std::vector<std::string> unpreconditioned = {"BGK", "MRT"};
+    // maximum deviation of the steady centre line velocity, relative to u_lid
+    const auto tolerance = 0.03;
+    auto is_passed = true;
+    std::cout << std::left << std::setw(14) << "steady" << std::setw(9) << "collision"
+              << std::right << std::setw(9) << "gamma" << std::setw(12) << "difference"
+              << std::setw(10) << "tolerance" << std::setw(10) << "steps"
+              << std::setw(10) << "baseline" << "  saved" << "\n";
+    for (auto c = 0u; c < preconditioned.size(); ++c)
+    {
+        const auto result = runSteadyCavity(preconditioned[c]);
+        const auto reference = runSteadyCavity(unpreconditioned[c]);
+        auto difference = 0.0;
+        for (auto y = 0u; y < result.u_centre.size(); ++y)
+        {
+            difference = std::max(difference, std::abs(result.u_centre[y] - reference.u_centre[y]));
+        }  // y
+        const auto is_ok = std::isfinite(difference) && difference <= tolerance;
+        if (!is_ok) is_passed = false;
+        const auto saved = 100.0 * (1.0 - static_cast<double>(result.num_steps) /
+                                          reference.num_steps);
+        std::cout << std::left << std::setw(14) << "cavity" << std::setw(9) << preconditioned[c]
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(9)
+                  << preconditioning_gamma << std::scientific << std::setprecision(3)
+                  << std::setw(12) << difference << std::setw(10) << std::setprecision(2)
+                  << tolerance << std::setw(10) << result.num_steps << std::setw(10)
+                  << reference.num_steps << "  " << std::fixed << std::setprecision(0) << saved
+                  << "%" << (is_ok ? "" : " FAIL difference") << std::endl;
+    }  // c
+    return is_passed;
+}
+
+std::vector<validation::modelResult> validation::runLaplace()
+{
+    const std::size_t nx = 64;
+    const std::size_t ny = 64;
+    const std::size_t num_steps = 3000;
+    const auto visco = 1.0 / 6.0;
+    // G = -5 separates liquid and gas of densities of about 1.9 and 0.13
+    const auto interaction_strength = -5.0;
+    const auto rho_liquid = 1.93;
+    const auto rho_gas = 0.16;
+    const std::vector<double> radii = {10.0, 14.0, 18.0};
+    const auto pi = std::acos(-1.0);
+
+    std::vector<double> surface_tension;
+    for (auto radius : radii)
+    {
+        fluidField field(nx, ny, {0.0, 0.0});
+        latticeModelD2Q9 D2Q9;
+        latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+        // diffuse interface of a few nodes
+        std::vector<double> initial_density(nx * ny);
+        for (auto y = 0u; y < ny; ++y)
+        {
+            for (auto x = 0u; x < nx; ++x)
+            {
+                const auto r = std::hypot(x - 0.5 * (nx - 1), y - 0.5 * (ny - 1));
+                initial_density[lattice.getNodeIndex(x, y)] = rho_gas + 0.5 * (rho_liquid - rho_gas) *
+                                                              (1.0 - std::tanh(r - radius));
+            }  // x
+        }  // y
+        collisionD2Q9_SC collision(lattice, visco, interaction_strength, rho_gas, initial_density,
+                                   D2Q9, field);
+        collision.setPeriodic(true, true);
+        streamD2Q9 stream(lattice, D2Q9);
+        periodicNode edges(lattice, D2Q9);
+        latticeBoltzmann run(lattice, collision, stream);
+        for (auto x = 0u; x < nx; ++x)
+        {
+            edges.addNode(x, 0);
+            edges.addNode(x, ny - 1);
+        }  // x
+        for (auto y = 1u; y < ny - 1; ++y)
+        {
+            edges.addNode(0, y);
+            edges.addNode(nx - 1, y);
+        }  // y
+        run.addBoundaryNode(&edges);
+        for (auto t = 0u; t < num_steps; ++t) run.takeStep();
+
+        const auto inside = lattice.getNodeIndex(nx / 2, ny / 2);
+        const auto outside = lattice.getNodeIndex(0, 0);
+        auto mass = 0.0;
+        for (auto rho : collision.rho_) mass += rho;
+        const auto area = (mass - collision.rho_[outside] * nx * ny) /
+                          (collision.rho_[inside] - collision.rho_[outside]);
+        surface_tension.push_back((field.p[inside] - field.p[outside]) * std::sqrt(area / pi));
+    }  // radius
+    modelResult result {0.0, 0.0, 0.0};
+    for (auto sigma : surface_tension) result.reference += sigma / surface_tension.size();
+    for (auto sigma : surface_tension)
+    {
+        const auto error = std::abs(sigma - result.reference) / result.reference;
+        if (error < result.error) continue;
+        result.value = sigma;
+        result.error = error;
+    }  // sigma
+    return {result};
+}
+
+std::vector<validation::modelResult> validation::runHeatedCavity()
+{
+    const std::size_t nx = 48;
+    const std::size_t ny = 48;
+    const std::size_t num_steps = 10000;
+    const auto rayleigh = 1.0e4;
+    const auto prandtl = 0.71;
+    const auto nusselt_ref = 2.243;
+    const auto u_max_ref = 16.178;
+    // the walls lie half a node outside of the edge nodes, the temperature
+    // difference is 1 and the buoyancy velocity sqrt(b * dT * L) keeps Ma low
+    const auto length = static_cast<double>(nx);
+    const auto u_buoyancy = 0.1;
+    const auto visco = u_buoyancy * length * std::sqrt(prandtl / rayleigh);
+    const auto diffusivity = visco / prandtl;
+    const auto buoyancy = u_buoyancy * u_buoyancy / length;
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+    collisionD2Q9_BGK_ADE collision(lattice, visco, diffusivity, 1.0,
+                                    std::vector<double>(nx * ny, 0.0), D2Q9, field);
+    collision.setBuoyancy(0.0, buoyancy, 0.0);
+    collision.setEdge(collisionD2Q9_BGK_ADE::LEFT, collisionD2Q9_BGK_ADE::FIXED, 0.5);
+    collision.setEdge(collisionD2Q9_BGK_ADE::RIGHT, collisionD2Q9_BGK_ADE::FIXED, -0.5);
+    collision.setEdge(collisionD2Q9_BGK_ADE::TOP, collisionD2Q9_BGK_ADE::ADIABATIC, 0.0);
+    collision.setEdge(collisionD2Q9_BGK_ADE::BOTTOM, collisionD2Q9_BGK_ADE::ADIABATIC, 0.0);
+    nodeTypeField types(lattice, collision, D2Q9, field);
+    streamD2Q9 stream(lattice, D2Q9, types);
+    latticeBoltzmann run(lattice, collision, stream);
+    for (auto y = 0u; y < ny; ++y)
+    {
+        types.addHalfwayBounceback(0, y);
+        types.addHalfwayBounceback(nx - 1, y);
+    }  // y
+    for (auto x = 1u; x < nx - 1; ++x)
+    {
+        types.addHalfwayBounceback(x, 0);
+        types.addHalfwayBounceback(x, ny - 1);
+    }  // x
+    for (auto t = 0u; t < num_steps; ++t) run.takeStep();
+
+    // at steady state the heat flux through every vertical line is the same, so
+    // Nu = 1 + L / (diffusivity * dT) * <u_x * T> over the cavity
+    const auto &temperature = collision.getScalar();
+    auto heat_flux = 0.0;
+    for (auto n = 0u; n < nx * ny; ++n) heat_flux += field.u[n][0] * temperature[n];
+    const auto nusselt = 1.0 + heat_flux / (nx * ny) * length / diffusivity;
+    auto u_max = 0.0;
+    for (auto y = 0u; y < ny; ++y)
+    {
+        u_max = std::max(u_max, 0.5 * (field.u[lattice.getNodeIndex(nx / 2 - 1, y)][0] +
+                                       field.u[lattice.getNodeIndex(nx / 2, y)][0]));
+    }  // y
+    u_max *= length / diffusivity;
+    return
+    {
+        {nusselt, nusselt_ref, std::abs(nusselt - nusselt_ref) / nusselt_ref},
+        {u_max, u_max_ref, std::abs(u_max - u_max_ref) / u_max_ref}
+    };
+}
+
+std::vector<validation::modelResult> validation::runCylinder()
+{
+    const std::size_t diameter = 10;
+    const std::size_t nx = 22 * diameter;
+    const std::size_t ny = 41 * diameter / 10;
+    const std::size_t num_steps = 10000;
+    const std::size_t num_iterations = 3;
+    const auto drag_ref = 5.58;
+    // Re = u_mean * D / nu = 20 with the mean of the parabolic inlet profile
+    const auto u_max = 0.075;
+    const auto u_mean = 2.0 / 3.0 * u_max;
+    const auto visco = u_mean * diameter / 20.0;
+    // the walls lie half a node outside of the bounceback rows as in
+    // runChannel(), the centre 2 D behind the inlet and 2 D above the bottom wall
+    const auto centre_x = 2.0 * diameter;
+    const auto centre_y = 2.0 * diameter - 0.5;
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+    collisionD2Q9_BGK collision(lattice, visco, 1.0, D2Q9, field);
+    streamD2Q9 stream(lattice, D2Q9);
+    bouncebackNode walls(lattice, &stream, D2Q9, field);
+    ZouHeNode inlet(lattice, collision, D2Q9, field);
+    ZouHePressureNode outlet(lattice, collision, D2Q9, field);
+    immersedBoundary body(lattice, D2Q9, centre_x, centre_y, num_iterations);
+    addCircle(body, centre_x, centre_y, 0.5 * diameter);
+    latticeBoltzmann run(lattice, collision, stream);
+    for (auto x = 0u; x < nx; ++x)
+    {
+        walls.addNode(x, 0);
+        walls.addNode(x, ny - 1);
+    }  // x
+    for (auto y = 1u; y < ny - 1; ++y)
+    {
+        const auto y_wall = y + 0.5;
+        inlet.addNode(0, y, 4.0 * u_max * y_wall * (ny - y_wall) / (ny * ny), 0.0);
+        outlet.addNode(nx - 1, y, 1.0);
+    }  // y
+    run.addBoundaryNode(&walls);
+    run.addBoundaryNode(&inlet);
+    run.addBoundaryNode(&outlet);
+    run.addBoundaryNode(&body);
+
+    auto drag = 0.0;
+    for (auto t = 0u; t < num_steps; ++t)
+    {
+        run.takeStep();
+        if (2 * t >= num_steps) drag += body.getForce()[0] / (num_steps - num_steps / 2);
+    }  // t
+    const auto drag_coefficient = 2.0 * drag / (u_mean * u_mean * diameter);
+    return {{drag_coefficient, drag_ref, std::abs(drag_coefficient - drag_ref) / drag_ref}};
+}
+
+std::vector<validation::modelResult> validation::runRotatingCylinder()
+{
+    const std::size_t nx = 48;
+    const std::size_t ny = 48;
+    const std::size_t num_steps = 3000;
+    const std::size_t num_iterations = 3;
+    const auto visco = 0.1;
+    const auto inner_radius = 8.0;
+    const auto outer_radius = 20.0;
+    const auto angular_velocity = 0.005;
+    const auto pi = std::acos(-1.0);
+    const auto centre = 0.5 * (nx - 1);
+    const auto torque_ref = -4.0 * pi * visco * angular_velocity * inner_radius * inner_radius *
+                            outer_radius * outer_radius /
+                            (outer_radius * outer_radius - inner_radius * inner_radius);
+
+    fluidField field(nx, ny, {0.0, 0.0});
+    latticeModelD2Q9 D2Q9;
+    latticeD2Q9 lattice(nx, ny, 1.0, 1.0, D2Q9);
+    collisionD2Q9_BGK collision(lattice, visco, 1.0, D2Q9, field);
+    streamD2Q9 stream(lattice, D2Q9);
+    periodicNode edges(lattice, D2Q9);
+    immersedBoundary rotor(lattice, D2Q9, centre, centre, num_iterations);
+    immersedBoundary stator(lattice, D2Q9, centre, centre, num_iterations);
+    rotor.setMotion(0.0, 0.0, angular_velocity);
+    addCircle(rotor, centre, centre, inner_radius);
+    addCircle(stator, centre, centre, outer_radius);
+    latticeBoltzmann run(lattice, collision, stream);
+    for (auto x = 0u; x < nx; ++x)
+    {
+        edges.addNode(x, 0);
+        edges.addNode(x, ny - 1);
+    }  // x
+    for (auto y = 1u; y < ny - 1; ++y)
+    {
+        edges.addNode(0, y);
+        edges.addNode(nx - 1, y);
+    }  // y
+    run.addBoundaryNode(&edges);
+    run.addBoundaryNode(&rotor);
+    run.addBoundaryNode(&stator);
+    for (auto t = 0u; t < num_steps; ++t) run.takeStep();
+
+    const auto torque = rotor.getTorque();
+    return {{torque, torque_ref, std::abs(torque - torque_ref) / std::abs(torque_ref)}};
+}
+
+std::vector<validation::modelResult> validation::runOutflow
+(
+    outflowNode::e_outflows outflow
+)
+{
+    const std::size_t nx = 64;
+    const std::size_t ny = 17;
+    const std::size_t num_steps = 130;
+    const auto visco = 0.02;
+    // Gaussian pulse with the velocity of a wave which only runs to the right,
+    // it passes the outflow nodes after about 90 steps
+    const auto amplitude = 1.0e-3;
+    const auto pulse_x = 24.0;
+    const auto pulse_width = 4.0;
+    const auto cs = 1.0 / std::sqrt(3.0);
+
+    // density and u_x of the short channel after the run, on a channel of the
+    // given length
+    auto runPulse = [&](std::size_t length)
+    {
+        fluidField field(length, ny, {0.0, 0.0});
+        latticeModelD2Q9 D2Q9;
+        latticeD2Q9 lattice(length, ny, 1.0, 1.0, D2Q9);
+        std::vector<double> initial_density(length * ny);
+        for (auto y = 0u; y < ny; ++y)
+        {
+            for (auto x = 0u; x < length; ++x)
+            {
+                const auto n = lattice.getNodeIndex(x, y);
+                const auto pulse = amplitude * std::exp(-(x - pulse_x) * (x - pulse_x) /
+                                                        (2.0 * pulse_width * pulse_width));
+                initial_density[n] = 1.0 + pulse;
+                if (y > 0 && y < ny - 1) field.u[n][0] = cs * pulse;
+            }  // x
+        }  // y
+        collisionD2Q9_BGK collision(lattice, visco, initial_density, D2Q9, field);
+        streamD2Q9 stream(lattice, D2Q9);
+        bouncebackNode walls(lattice, &stream, D2Q9, field);
+        outflowNode outlet(lattice, collision, D2Q9, field, outflow);
+        if (outflow == outflowNode::CONVECTIVE) outlet.setConvectiveVelocity(cs);
+        latticeBoltzmann run(lattice, collision, stream);
+        for (auto x = 0u; x < length; ++x)
+        {
+            walls.addNode(x, 0);
+            walls.addNode(x, ny - 1);
+        }  // x
+        for (auto y = 1u; y < ny - 1; ++y)
+        {
+            walls.addNode(0, y);
+            outlet.addNode(length - 1, y);
+        }  // y
+        run.addBoundaryNode(&walls);
+        run.addBoundaryNode(&outlet);
+        for (auto t = 0u; t < num_steps; ++t) run.takeStep();
+        std::vector<double> state;
+        for (auto y = 0u; y < ny; ++y)
+        {
+            for (auto x = 0u; x < nx; ++x)
+            {
+                const auto n = lattice.getNodeIndex(x, y);
+                state.push_back(collision.rho_[n]);
+                state.push_back(field.u[n][0] / cs);
+            }  // x
+        }  // y
+        return state;
+    };
+    const auto truncated = runPulse(nx);
+    const auto reference = runPulse(4 * nx);
+    modelResult result {0.0, 0.0, 0.0};
+    for (auto k = 0u; k < truncated.size(); ++k)
+    {
+        result.value = std::max(result.value, std::abs(truncated[k] - reference[k]) / amplitude);
+    }  // k
+    result.error = result.value;
+    return {result};
+}
+
+bool validation::validateModels()
+{
+    // case, model, measured quantities and tolerances of their relative error
+    struct modelCase
+    {
+        std::string name;
+        std::string model;
+        std::vector<std::string> quantities;
+        std::vector<double> tolerances;
+    };
+    const std::vector<modelCase> cases =
+    {
+        {"laplace", "SC", {"dp*R"}, {0.05}},
+        {"heated_cavity", "BGK_ADE", {"Nu", "u_max"}, {0.02, 0.02}},
+        {"cylinder", "IBM", {"Cd"}, {0.2}},
+        {"rotor", "IBM", {"torque"}, {0.15}},
+        {"outflow_conv", "BGK", {"reflection"}, {0.1}},
+        {"outflow_char", "BGK", {"reflection"}, {0.1}}
+    };
+    auto is_passed = true;
+    std::cout << std::left << std::setw(14) << "case" << std::setw(9) << "model"
+              << std::setw(11) << "quantity" << std::right << std::setw(10) << "value"
+              << std::setw(12) << "reference" << std::setw(12) << "error"
+              << std::setw(10) << "tolerance" << "  status" << "\n";
+    for (auto &model_case : cases)
+    {
+        std::vector<modelResult> results;
+        if (model_case.name == "laplace")
+        {
+            results = runLaplace();
+        }
+        else if (model_case.name == "heated_cavity")
+        {
+            results = runHeatedCavity();
+        }
+        else if (model_case.name == "cylinder")
+        {
+            results = runCylinder();
+        }
+        else if (model_case.name == "rotor")
+        {
+            results = runRotatingCylinder();
+        }
+        else if (model_case.name == "outflow_conv")
+        {
+            results = runOutflow(outflowNode::CONVECTIVE);
+        }
+        else
+        {
+            results = runOutflow(outflowNode::CHARACTERISTIC);
+        }
+        for (auto q = 0u; q < results.size(); ++q)
+        {
+            const auto &result = results[q];
+            const auto is_ok = std::isfinite(result.error) && result.error <= model_case.tolerances[q];
+            if (!is_ok) is_passed = false;
+            std::cout << std::left << std::setw(14) << model_case.name << std::setw(9)
+                      << model_case.model << std::setw(11) << model_case.quantities[q] << std::right
+                      << std::scientific << std::setprecision(3) << std::setw(10) << result.value
+                      << std::setw(12) << result.reference << std::setw(12) << result.error
+                      << std::setw(10) << std::setprecision(2) << model_case.tolerances[q] << "  "
+                      << (is_ok ? "ok" : "FAIL error") << std::endl;
+        }  // q
+    }  // model_case
+    return is_passed;
+}
+
+bool validation::run()
+{
+    const std::vector<std::string> case_names = {"poiseuille", "couette", "taylor_green", "cavity"};
+    // engine, its name and the band rows of the SCHEDULED engine: single rows, a
+    // size which leaves a partial band and the default
+    struct engineRun
+    {
+        e_engines engine;
+        std::string name;
+        std::size_t band_rows;
+    };
+    const std::vector<engineRun> engines =
+    {
+        {OBJECTS, "objects", 0},
+        {TYPED, "typed", 0},
+        {TILED, "tiled", 0},
+        {SCHEDULED, "sched_1", 1},
+        {SCHEDULED, "sched_5", 5},
+        {SCHEDULED, "sched", 0},
+        {LOAD_BALANCED, "balanced", 0}
+    };
+    // Error tolerance of each case
+    const std::vector<double> tolerances = {0.01, 0.03, 0.02, 0.03};
+    auto is_passed = true;
+    std::cout << std::left << std::setw(14) << "case" << std::setw(9) << "collision"
+              << std::setw(9) << "engine" << std::right << std::setw(12) << "error"
+              << std::setw(10) << "tolerance" << std::setw(10) << "MLUPS"
+              << std::setw(10) << "baseline" << "  status" << "\n";
+    for (auto c = 0u; c < case_names.size(); ++c)
+    {
+        for (auto &collision : collisions_)
+        {
+            // distribution functions of the OBJECTS engine
+            std::vector<double> df_objects;
+            for (auto &engine : engines)
+            {
+                // task graphs and load balanced sweeps need node ranges, which
+                // only BGK and MRT have, and are compared on the cases with
+                // boundaryNode objects
+                const auto is_compared = engine.engine == SCHEDULED || engine.engine == LOAD_BALANCED;
+                if (is_compared && (c == TAYLOR_GREEN || (collision != "BGK" && collision != "MRT")))
+                {
+                    continue;
+                }
+                runResult result {0.0, 0.0, 0, {}};
+                switch (c)
+                {
+                    case POISEUILLE:
+                    {
+                        result = runChannel(collision, engine.engine, engine.band_rows, false);
+                        break;
+                    }
+                    case COUETTE:
+                    {
+                        result = runChannel(collision, engine.engine, engine.band_rows, true);
+                        break;
+                    }
+                    case TAYLOR_GREEN:
+                    {
+                        result = runTaylorGreen(collision, engine.engine);
+                        break;
+                    }
+                    default:
+                    {
+                        result = runCavity(collision, engine.engine, engine.band_rows);
+                        break;
+                    }
+                }
+                if (engine.engine == OBJECTS) df_objects = result.df;
+                std::cout << std::left << std::setw(14) << case_names[c] << std::setw(9)
+                          << collision << std::setw(9) << engine.name << std::right;
+                const auto key = case_names[c] + "," + collision + "," + engine.name;
+                const auto is_error_ok = std::isfinite(result.error) &&
+                                         result.error <= tolerances[c];
+                // the task graphs and chunks run the same operations as the
+                // serial step
+                const auto is_same = !is_compared || result.df == df_objects;
+                const auto is_ok = is_error_ok && is_same;
+                auto status = is_error_ok ? std::string("ok") : std::string("FAIL error");
+                if (!is_same)
+                {
+                    status = is_error_ok ? "FAIL differs from objects" : status + ", differs from objects";
+                }
+                auto baseline = baseline_.find(key);
+                // the MLUPS depend on the machine and its load, they only fail
+                // runs on request
+                std::string mlups_status;
+                if (is_recording_)
+                {
+                    baseline_[key] = result.mlups;
+                    if (is_ok) status = "ok, recorded";
+                }
+                else if (baseline == baseline_.end())
+                {
+                    // a run without baseline would pass any performance regression
+                    mlups_status = "no baseline";
+                }
+                else if (result.mlups < (1.0 - mlups_tolerance_) * baseline->second)
+                {
+                    mlups_status = "low MLUPS";
+                }
+                if (!mlups_status.empty())
+                {
+                    if (!is_ok)
+                    {
+                        status += ", " + mlups_status;
+                    }
+                    else
+                    {
+                        status = (is_enforcing_mlups_ ? "FAIL " : "ok, ") + mlups_status;
+                    }
+                }
+                // time steps do not allocate, checked in builds which count allocations
+                if (result.num_allocations > 0)
+                {
+                    status = status.compare(0, 4, "FAIL") == 0 ? status + ", allocations" :
+                                                                 "FAIL allocations";
+                }
+                if (status.compare(0, 4, "FAIL") == 0) is_passed = false;
+                const auto baseline_mlups = baseline_.count(key) > 0 ? baseline_[key] : 0.0;
+                std::cout << std::scientific << std::setprecision(3) << std::setw(12) << result.error
+                          << std::setw(10) << std::setprecision(2) << tolerances[c] << std::fixed
+                          << std::setw(10) << result.mlups << std::setw(10) << baseline_mlups
+                          << "  " << status << std::endl;
+            }  // engine
+        }  // collision
+    }  // c
+    if (!comparePreconditioning()) is_passed = false;
+    if (!validateModels()) is_passed = false;
+    if (is_recording_) writeBaseline();
+    std::cout << (is_passed ? "Validation passed" : "Validation FAILED") << std::endl;
+    return is_passed;
+}
+
+void validation::readBaseline()
+{
+    std::ifstream baseline_file(baseline_file_);
+    std::string line;
+    while (std::getline(baseline_file, line))
+    {
+        const auto comma = line.find_last_of(',');
+        if (line.empty() || line[0] == '#' || comma == std::string::npos) continue;
+        std::istringstream value(line.substr(comma + 1));
+        auto mlups = 0.0;
+        if (value >> mlups) baseline_[line.substr(0, comma)] = mlups;
+    }
+}
+
+void validation::writeBaseline()
+{
+    std::ofstream baseline_file;
+    baseline_file.open(baseline_file_);
+    baseline_file << "# case,collision,engine,MLUPS" << std::endl;
+    for (auto &entry : baseline_) baseline_file << entry.first << "," << entry.second << std::endl;
+    baseline_file.close();
+    if (!baseline_file) throw std::runtime_error("Error in writing " + baseline_file_);
+}
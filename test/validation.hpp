@@ -0,0 +1,234 @@
+#ifndef VALIDATION_HPP_INCLUDED
+#define VALIDATION_HPP_INCLUDED
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "latticeModel.hxx"
+#include "collisionBase.hxx"
+
+#include "latticeBase.hpp"
+#include "nodeOrdering.hpp"
+#include "outflowNode.hpp"
+
+class validation
+{
+    public:
+        // Analytical and reference cases
+        enum e_cases
+        {
+            POISEUILLE,
+            COUETTE,
+            TAYLOR_GREEN,
+            CAVITY
+        };
+        // Streaming engines: boundaryNode objects called by LatticeBoltzmann,
+        // boundary rules of a nodeTypeField applied inside the streaming sweep,
+        // the same rules on a lattice stored in Hilbert-ordered tiles, the
+        // boundaryNode objects with the steps run as task graphs on bands of rows,
+        // or the boundaryNode objects with the collision sweeps spread over
+        // threads by a load balancer
+        enum e_engines
+        {
+            OBJECTS,
+            TYPED,
+            TILED,
+            SCHEDULED,
+            LOAD_BALANCED
+        };
+        // Constructor: Creates the validation suite which runs every case with every
+        // collision model and streaming engine, checks the error norm against the
+        // tolerance of the case and compares the performance with a stored
+        // baseline, then checks the cases of single models against their
+        // reference values. Slow runs and runs without a baseline entry are only reported
+        // unless the MLUPS are enforced. Builds with COUNT_ALLOCATIONS also fail
+        // runs whose time steps allocate
+        // param baseline_file CSV file with the MLUPS baseline of each run
+        // param mlups_tolerance relative band below the baseline, e.g. 0.2 reports
+        //       runs which are more than 20% slower than the baseline
+        // param is_recording TRUE to write the MLUPS of this machine to the
+        //       baseline file instead of checking them
+        // param is_enforcing_mlups TRUE to fail slow runs and runs without a
+        //       baseline entry
+        validation
+        (
+            const std::string &baseline_file,
+            double mlups_tolerance,
+            bool is_recording,
+            bool is_enforcing_mlups
+        );
+        // Runs all cases, prints one line per run and writes the baseline if it is
+        // recorded
+        // return true if every run is within its error tolerance and MLUPS band
+        bool run();
+    private:
+        // Error norm and performance of a single run
+        struct runResult
+        {
+            // Error norm of the case, see the tolerances in run()
+            double error;
+            // Million lattice updates per second of the time stepping loop
+            double mlups;
+            // Heap allocations of the time steps after the first, always 0 in
+            // builds without COUNT_ALLOCATIONS
+            std::size_t num_allocations;
+            // Distribution functions after the last step in memory order, which the
+            // SCHEDULED and LOAD_BALANCED engines must reproduce exactly
+            std::vector<double> df;
+        };
+        // Measured quantity of a model case and its reference value
+        struct modelResult
+        {
+            // Measured quantity, e.g. a Nusselt number
+            double value;
+            // Reference value of the quantity
+            double reference;
+            // Relative deviation of the quantity from the reference
+            double error;
+        };
+        // Iterations to steady state and centre line velocity of a run
+        struct steadyResult
+        {
+            // Number of steps until checkSteadyState passes
+            std::size_t num_steps;
+            // u_x / u_lid on the vertical centre line
+            std::vector<double> u_centre;
+        };
+        // Creates a collision model by name: BGK, MRT, RBGK, CM, BGK_LES, MRT_LES,
+        // BGK_PRE or MRT_PRE
+        // param name name of the collision model
+        // param lb reference to LatticeModel
+        // param kinematic_viscosity kinematic viscosity
+        // param D2Q9 lattice model D2Q9
+        // param field fluid field
+        std::unique_ptr<collisionBase> makeCollision
+        (
+            const std::string &name,
+            latticeBase &lb,
+            double kinematic_viscosity,
+            latticeModelD2Q9 &D2Q9,
+            fluidField &field
+        );
+        // Storage order of the lattice for an engine
+        // param engine streaming engine
+        nodeOrdering::e_orderings getOrdering
+        (
+            e_engines engine
+        );
+        // Poiseuille or Couette flow in a channel with a Zou/He inlet carrying the
+        // analytical profile and a Zou/He pressure outlet. The error is the
+        // relative L2 norm of u_x at the middle of the channel
+        // param collision name of the collision model
+        // param engine streaming engine
+        // param band_rows number of rows of a band of the SCHEDULED engine, 0 for
+        //       the default
+        // param is_couette Couette flow with a moving top wall if true
+        runResult runChannel
+        (
+            const std::string &collision,
+            e_engines engine,
+            std::size_t band_rows,
+            bool is_couette
+        );
+        // Decaying Taylor-Green vortex on a periodic lattice, with periodicNode
+        // objects or periodic nodes of a nodeTypeField. The error is the relative
+        // deviation of the kinetic energy from exp(-4 * nu * k^2 * t)
+        // param collision name of the collision model
+        // param engine streaming engine
+        runResult runTaylorGreen
+        (
+            const std::string &collision,
+            e_engines engine
+        );
+        // Lid-driven cavity with the boundaries of main.cpp at Re = 100. The error
+        // is the maximum deviation of u_x / u_lid on the vertical centre line from
+        // "High-Re solutions for incompressible flow using the Navier-Stokes
+        // equations and a multigrid method" Ghia1982
+        // param collision name of the collision model
+        // param engine streaming engine
+        // param band_rows number of rows of a band of the SCHEDULED engine, 0 for
+        //       the default
+        runResult runCavity
+        (
+            const std::string &collision,
+            e_engines engine,
+            std::size_t band_rows
+        );
+        // Lid-driven cavity at Re = 100 run from rest until checkSteadyState passes
+        // param collision name of the collision model
+        steadyResult runSteadyCavity
+        (
+            const std::string &collision
+        );
+        // Runs the steady cavity with the preconditioned collision models and
+        // their unpreconditioned counterparts, prints the iterations saved and
+        // the difference of the steady centre line velocities
+        // return true if every steady solution matches its counterpart
+        bool comparePreconditioning();
+        // Static droplets of three radii in a periodic lattice with the Shan-Chen
+        // model. By Laplace's law dp * R equals the surface tension for every
+        // radius, R is taken from the mass of the droplet. The error is the
+        // largest relative deviation of dp * R from its mean
+        // return dp * R
+        std::vector<modelResult> runLaplace();
+        // Differentially heated square cavity at Ra = 1e4 and Pr = 0.71 with the
+        // BGK_ADE model: fixed temperatures on the left and right walls,
+        // adiabatic top and bottom walls and Boussinesq buoyancy. The mean Nusselt
+        // number and the largest u_x on the vertical centre line in units of
+        // diffusivity / L are compared with "Natural convection of air in a square
+        // cavity: a bench mark numerical solution" deVahlDavis1983
+        // return Nusselt number and u_max
+        std::vector<modelResult> runHeatedCavity();
+        // Cylinder of diameter D = 10 in a channel of height 4.1 D at Re = 20, the
+        // 2D-1 case of "Benchmark computations of laminar flow around a cylinder"
+        // Schaefer1996, with an immersedBoundary. The drag coefficient is
+        // averaged over the second half of the run, since pressure waves
+        // between inlet and outlet decay slowly. The diffuse interface of the
+        // markers overestimates the drag by about 15% at this resolution
+        // return drag coefficient
+        std::vector<modelResult> runCylinder();
+        // Cylinder of radius 8 rotating inside a fixed cylinder of radius 20, both
+        // immersedBoundary bodies. The torque of the fluid on the inner cylinder
+        // is compared with -4 * pi * mu * omega * R1^2 * R2^2 / (R2^2 - R1^2) of
+        // circular Couette flow, which checks the marker kinematics of a rotating
+        // body and the sign and scaling of the marker forces. The diffuse
+        // interface gives about 10% more torque at this resolution
+        // return torque on the inner cylinder
+        std::vector<modelResult> runRotatingCylinder();
+        // Acoustic pulse which runs towards the outflow nodes at the end of a
+        // closed channel of 64 x 17 nodes at rest. The channel is compared with one
+        // four times as long which the pulse does not leave during the run, the
+        // reflection is the largest difference of density and velocity on the
+        // short channel relative to the pulse amplitude. A Zou/He pressure outlet
+        // reflects about 65%
+        // param outflow outflow condition, the CONVECTIVE one with U = cs
+        // return reflection of the pulse
+        std::vector<modelResult> runOutflow
+        (
+            outflowNode::e_outflows outflow
+        );
+        // Runs the cases of the collision models and boundaries which do not fit
+        // the matrix of run(), prints the measured quantities and their reference
+        // return true if every quantity is within its tolerance
+        bool validateModels();
+        // Reads the MLUPS baseline, a missing file gives an empty baseline
+        void readBaseline();
+        // Writes the MLUPS baseline
+        void writeBaseline();
+        // Name of the baseline file
+        std::string baseline_file_;
+        // Relative MLUPS band below the baseline
+        double mlups_tolerance_;
+        // Boolean toggle to record the baseline instead of checking it
+        bool is_recording_;
+        // Boolean toggle to fail runs below the MLUPS band instead of reporting them
+        bool is_enforcing_mlups_;
+        // MLUPS baseline of each run, keyed by case,collision,engine
+        std::map<std::string, double> baseline_;
+        // Collision models which are validated
+        std::vector<std::string> collisions_;
+};
+
+#endif // VALIDATION_HPP_INCLUDED